@@ -79,6 +79,108 @@ cog_timezone(void)
     return tz;
 }
 
+/* 8 ASCII digits in a little-endian word, or UINT64_MAX if any isn't one */
+static uint64_t
+_cog_8digits(const char str[])
+{
+    uint64_t v;
+
+    memcpy(&v, str, sizeof(v));
+    if (((v & 0xF0F0F0F0F0F0F0F0)
+         | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+        != 0x3333333333333333)
+        return UINT64_MAX;
+    v -= 0x3030303030303030;
+    v = (v * 10) + (v >> 8);
+    return (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32)))
+            + (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32))))
+           >> 32;
+}
+
+/* `n` digits starting at `str`, -1 if any isn't one */
+static int
+_cog_digits(const char str[], int n)
+{
+    int value = 0;
+
+    while (n--) {
+        const unsigned d = (unsigned char)*str++ - '0';
+        if (d > 9) return -1;
+        value = value * 10 + (int)d;
+    }
+    return value;
+}
+
+/* days since 1970-01-01 of a proleptic gregorian date */
+static int64_t
+_cog_days_from_civil(int64_t y, unsigned m, unsigned d)
+{
+    int64_t era;
+    unsigned yoe, doy, doe;
+
+    /* years start in March, so leap days fall at their end */
+    if (m <= 2) --y;
+    era = (y >= 0 ? y : y - 399) / 400;
+    yoe = (unsigned)(y - era * 400);
+    doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+/* YYYY-MM-DDTHH:MM:SS[.fff...](Z|+HH:MM|-HH:MM), 0 if `str` doesn't fit */
+static int
+_cog_iso8601_fixed(const char str[], size_t len, uint64_t *p_value)
+{
+    int year, mon, mday, hour, min, sec, millis = 0, tz = 0;
+    int64_t secs;
+    size_t i = 19;
+
+    if (len < 20 || str[4] != '-' || str[7] != '-' || str[10] != 'T'
+        || str[13] != ':' || str[16] != ':')
+        return 0;
+    if ((year = _cog_digits(str, 4)) < 0 || (mon = _cog_digits(str + 5, 2)) < 1
+        || mon > 12 || (mday = _cog_digits(str + 8, 2)) < 1 || mday > 31
+        || (hour = _cog_digits(str + 11, 2)) < 0
+        || (min = _cog_digits(str + 14, 2)) < 0
+        || (sec = _cog_digits(str + 17, 2)) < 0)
+        return 0;
+
+    if ('.' == str[i]) {
+        int scale = 100;
+
+        while (++i < len && (unsigned)((unsigned char)str[i] - '0') <= 9) {
+            millis += (str[i] - '0') * scale;
+            scale /= 10;
+        }
+    }
+    if (i < len && 'Z' == str[i]) {
+        ++i;
+    }
+    else if (i + 6 <= len && ('+' == str[i] || '-' == str[i])
+             && ':' == str[i + 3])
+    {
+        const int tz_hour = _cog_digits(str + i + 1, 2),
+                  tz_min = _cog_digits(str + i + 4, 2);
+
+        if (tz_hour < 0 || tz_min < 0) return 0;
+        tz = (tz_hour * 60 + tz_min) * 60;
+        if ('-' == str[i]) tz = -tz;
+        i += 6;
+    }
+    else {
+        return 0;
+    }
+    if (i != len) return 0;
+
+    secs = _cog_days_from_civil(year, (unsigned)mon, (unsigned)mday) * 86400
+           + hour * 3600 + min * 60 + sec - tz;
+    if (secs < 0) return 0;
+    *p_value = (uint64_t)secs * 1000 + (uint64_t)millis;
+
+    return 1;
+}
+
 int
 cog_iso8601_to_unix_ms(const char str[], size_t len, uint64_t *p_value)
 {
@@ -86,7 +188,8 @@ cog_iso8601_to_unix_ms(const char str[], size_t len, uint64_t *p_value)
     int tz_operator = 'Z';
     int tz_hour = 0, tz_min = 0;
     struct tm tm = { 0 };
-    (void)len;
+
+    if (_cog_iso8601_fixed(str, len, p_value)) return 1;
 
     /* ISO-8601 complete format */
     sscanf(str, "%d-%d-%dT%d:%d:%lf%d%d:%d", &tm.tm_year, &tm.tm_mon,
@@ -129,14 +232,44 @@ cog_unix_ms_to_iso8601(char *str, size_t len, uint64_t value)
 }
 
 int
-cog_strtou64(char *str, size_t len, uint64_t *p_value)
+cog_strtou64(const char str[], size_t len, uint64_t *p_value)
 {
-    char fmt[512];
-    size_t ret = snprintf(fmt, sizeof(fmt), "%%%zu" SCNu64, len);
+    uint64_t value = 0;
+    size_t i = 0;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    /* 16 digits can't overflow, a snowflake has up to 20 */
+    for (; i + 8 <= len && i < 16; i += 8) {
+        const uint64_t chunk = _cog_8digits(str + i);
+        if (UINT64_MAX == chunk) break;
+        value = value * 100000000 + chunk;
+    }
+#endif
+    for (; i < len; ++i) {
+        const unsigned d = (unsigned char)str[i] - '0';
 
-    if (ret >= sizeof(fmt)) return 0;
+        if (d > 9) break;
+        value = value > (UINT64_MAX - d) / 10 ? UINT64_MAX : value * 10 + d;
+    }
+    if (!i) return 0;
 
-    return sscanf(str, fmt, p_value) != EOF;
+    *p_value = value;
+    return 1;
+}
+
+int
+cog_strtoi64(const char str[], size_t len, int64_t *p_value)
+{
+    const int negative = len && '-' == *str;
+    uint64_t value;
+
+    if (!cog_strtou64(str + negative, len - negative, &value)) return 0;
+
+    if (negative)
+        *p_value = value > (uint64_t)INT64_MAX ? INT64_MIN : -(int64_t)value;
+    else
+        *p_value = value > (uint64_t)INT64_MAX ? INT64_MAX : (int64_t)value;
+    return 1;
 }
 
 int
@@ -272,3 +405,108 @@ cog_timestamp_us(void)
     }
     return 0;
 }
+
+/* every allocation is aligned to this (see COG_ARENA_SIZEOF()), blocks
+ *      start with a pointer to the previous block padded to it */
+#define ARENA_ALIGN     16
+#define ARENA_MIN_BLOCK 1024
+
+static bool
+_cog_arena_grow(struct ccord_arena *arena, size_t size)
+{
+    size_t realsize = arena->realsize ? 2 * arena->realsize : ARENA_MIN_BLOCK;
+    char *block;
+
+    if (realsize < size) realsize = size;
+    if (!(block = malloc(ARENA_ALIGN + realsize))) return false;
+
+    memcpy(block, &arena->block, sizeof(arena->block));
+    arena->block = block;
+    arena->size = 0;
+    arena->realsize = realsize;
+
+    return true;
+}
+
+void
+cog_arena_init(struct ccord_arena *arena, size_t size)
+{
+    memset(arena, 0, sizeof *arena);
+    if (size) _cog_arena_grow(arena, size);
+}
+
+void
+cog_arena_init_fixed(struct ccord_arena *arena, void *buf, size_t size)
+{
+    arena->block = buf;
+    arena->size = 0;
+    arena->realsize = size;
+    arena->fixed = true;
+}
+
+void *
+cog_arena_alloc(struct ccord_arena *arena, size_t size)
+{
+    char *p;
+
+    size = COG_ARENA_SIZEOF(size);
+    if (!arena->block || size > arena->realsize - arena->size) {
+        if (arena->fixed || !_cog_arena_grow(arena, size)) return NULL;
+    }
+
+    p = arena->block + (arena->fixed ? 0 : ARENA_ALIGN) + arena->size;
+    arena->size += size;
+    memset(p, 0, size);
+
+    return p;
+}
+
+void
+cog_arena_cleanup(struct ccord_arena *arena)
+{
+    char *block = arena->fixed ? NULL : arena->block, *prev;
+
+    while (block) {
+        memcpy(&prev, block, sizeof(prev));
+        free(block);
+        block = prev;
+    }
+    memset(arena, 0, sizeof *arena);
+}
+
+int
+cog_varint_put(char buf[], size_t size, size_t *pos, uint64_t value)
+{
+    size_t i = *pos;
+
+    do {
+        if (i >= size) return -1;
+        buf[i++] = (char)((value & 0x7F) | (value > 0x7F ? 0x80 : 0));
+        value >>= 7;
+    } while (value);
+    *pos = i;
+
+    return 0;
+}
+
+int
+cog_varint_get(const char buf[], size_t size, size_t *pos, uint64_t *p_value)
+{
+    uint64_t value = 0;
+    size_t i = *pos;
+    unsigned shift;
+
+    for (shift = 0; shift < 64; shift += 7) {
+        unsigned char byte;
+
+        if (i >= size) return -1;
+        byte = (unsigned char)buf[i++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *p_value = value;
+            *pos = i;
+            return 0;
+        }
+    }
+    return -1;
+}
@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include <stdint.h>
 
+#include "types.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -37,7 +39,9 @@ long cog_timezone(void);
 /**
  * @brief Convert a iso8601 string to a unix timestamp (milliseconds)
  *
- * Can be matched to the json_extract() and json_inject() %F specifier
+ * Can be matched to the json_extract() and json_inject() %F specifier.
+ *        Discord's `YYYY-MM-DDTHH:MM:SS[.ffffff](Z|+HH:MM)` layout is read
+ *        without going through `sscanf()` and `mktime()`
  * @param str the iso8601 string timestamp
  * @param len the string length
  * @param p_value pointer to the `uint64_t` variable to receive the converted
@@ -59,13 +63,29 @@ int cog_unix_ms_to_iso8601(char str[], size_t len, const uint64_t value);
 /**
  * @brief Convert a numerical string to `uint64_t`
  *
+ * Reads the leading digits of `str`, eight at a time where it can, so
+ *        snowflakes take a couple of steps rather than a `sscanf()` call.
+ *        Values past `UINT64_MAX` are clamped to it
  * @param str the numerical string
  * @param len the string length
  * @param p_value pointer to the `uint64_t` variable to receive the converted
- * value
+ * value, left untouched on failure
  * @return 1 on success, 0 on failure
  */
-int cog_strtou64(char *str, size_t len, uint64_t *p_value);
+int cog_strtou64(const char str[], size_t len, uint64_t *p_value);
+
+/**
+ * @brief Convert a numerical string with an optional leading `-` to
+ *        `int64_t`
+ *
+ * Counterpart of cog_strtou64() for signed integers
+ * @param str the numerical string
+ * @param len the string length
+ * @param p_value pointer to the `int64_t` variable to receive the converted
+ * value, left untouched on failure
+ * @return 1 on success, 0 on failure
+ */
+int cog_strtoi64(const char str[], size_t len, int64_t *p_value);
 
 /**
  * @brief Convert `uint64_t` to a numerical string
@@ -129,6 +149,68 @@ uint64_t cog_timestamp_ms(void);
  */
 uint64_t cog_timestamp_us(void);
 
+/** @brief Amount of bytes taken from an arena by a `size` allocation */
+#define COG_ARENA_SIZEOF(size) (((size) + 15) & ~(size_t)15)
+
+/**
+ * @brief Initialize an arena with a first block of `size` bytes
+ *
+ * @param arena the arena to be initialized
+ * @param size the first block size, further blocks are added as needed
+ */
+void cog_arena_init(struct ccord_arena *arena, size_t size);
+
+/**
+ * @brief Initialize an arena over a user-given buffer, it won't grow past it
+ *
+ * @param arena the arena to be initialized
+ * @param buf the buffer, aligned as memory returned by malloc()
+ * @param size the buffer size
+ */
+void cog_arena_init_fixed(struct ccord_arena *arena, void *buf, size_t size);
+
+/**
+ * @brief Take `size` zero-initialized bytes from the arena
+ *
+ * @param arena the arena initialized with cog_arena_init()
+ * @param size amount of bytes to be taken
+ * @return the memory, suitably aligned for any type, or NULL on failure
+ */
+void *cog_arena_alloc(struct ccord_arena *arena, size_t size);
+
+/**
+ * @brief Release every block taken by the arena
+ * @note a buffer given to cog_arena_init_fixed() is left to the user
+ *
+ * @param arena the arena initialized with cog_arena_init()
+ */
+void cog_arena_cleanup(struct ccord_arena *arena);
+
+/**
+ * @brief Write `value` as a LEB128 varint, 7 bits per byte
+ *
+ * @param buf the buffer to be written to
+ * @param size the buffer size
+ * @param pos the current position, advanced past the varint
+ * @param value the value to be written
+ * @return 0 on success, -1 if it doesn't fit the buffer
+ */
+int cog_varint_put(char buf[], size_t size, size_t *pos, uint64_t value);
+
+/**
+ * @brief Read a LEB128 varint written by cog_varint_put()
+ *
+ * @param buf the buffer to be read from
+ * @param size the buffer size
+ * @param pos the current position, advanced past the varint
+ * @param p_value the read value
+ * @return 0 on success, -1 if the varint is truncated or too long
+ */
+int cog_varint_get(const char buf[],
+                   size_t size,
+                   size_t *pos,
+                   uint64_t *p_value);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
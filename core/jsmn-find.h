@@ -9,6 +9,12 @@ extern "C" {
 #error "jsmn-find.h should be included after jsmn.h"
 #endif
 
+#ifndef JSMNF_LINEAR_MAX
+/** objects up to this many fields are looked up with a linear scan, larger
+ *      ones are hashed on their first jsmnf_find() */
+#define JSMNF_LINEAR_MAX 16
+#endif
+
 /** @brief JSON token description */
 struct jsmnftok {
     /** start position in JSON data string */
@@ -33,6 +39,8 @@ typedef struct jsmnf_pair {
     struct jsmnftok v;
     /** current state of this pair */
     int state;
+    /** whether `fields` have been hashed by jsmnf_find(), objects only */
+    int hashed;
 } jsmnf_pair;
 
 /** @brief Bucket (@ref jsmnf_pair) loader, keeps track of pair array
@@ -78,6 +86,10 @@ JSMN_API int jsmnf_load(jsmnf_loader *loader,
  * @param[in] length length of the key too be matched
  * @return the @ref jsmnf_pair `head`'s field matched to `key`, or NULL if
  * not encountered
+ * @note the first lookup on an object larger than @ref JSMNF_LINEAR_MAX
+ *      rearranges its `fields` into a hash table, pointers taken by
+ *      walking `fields` beforehand are invalidated, and concurrent
+ *      lookups on the same pairs must be synchronized
  */
 JSMN_API jsmnf_pair *jsmnf_find(const jsmnf_pair *head,
                                 const char *js,
@@ -141,6 +153,57 @@ JSMN_API int jsmn_parse_auto(jsmn_parser *parser,
                              jsmntok_t **p_tokens,
                              unsigned *num_tokens);
 
+/** @brief Instruction sets jsmn_parse_fast() and jsmnf_unescape() may
+ *      scan input with */
+enum jsmn_isa {
+    /** pick the widest one supported by the running CPU */
+    JSMN_ISA_AUTO = 0,
+    /** portable byte by byte classification */
+    JSMN_ISA_SCALAR,
+    /** 16-byte SSE2 compares */
+    JSMN_ISA_SSE2,
+    /** 32-byte AVX2 compares */
+    JSMN_ISA_AVX2
+};
+
+/**
+ * @brief `jsmn_parse_auto()` alternative that tokenizes 64-byte blocks at
+ *      a time
+ *
+ * Quotes, backslashes and structural characters of each block are
+ *      gathered into bitmasks with SIMD compares, string interiors are
+ *      masked out, and tokens are only emitted at the remaining bits
+ *      (simdjson's stage 1). The output is the same as `jsmn_parse_auto()`
+ *      in non-strict mode, which it falls back to for anything unusual,
+ *      so that errors are reported identically
+ * @note `parser` must have just been initialized with `jsmn_init()`
+ *
+ * @param[in,out] parser the `jsmn_parser` initialized with `jsmn_init()`
+ * @param[in] js the JSON data string
+ * @param[in] length the raw JSON string length
+ * @param[out] p_tokens pointer to `jsmntok_t` to be dynamically increased
+ *      @note must be `free()`'d once done being used
+ * @param[in,out] num_tokens amount of tokens
+ * @return a `enum jsmnerr` value for error or the amount of `tokens` used
+ */
+JSMN_API int jsmn_parse_fast(jsmn_parser *parser,
+                             const char *js,
+                             size_t length,
+                             jsmntok_t **p_tokens,
+                             unsigned *num_tokens);
+
+/**
+ * @brief Select the instruction set used by jsmn_parse_fast() and
+ *      jsmnf_unescape()
+ *
+ * @note the default is picked once and thread-safely on first use, but
+ *      changing it must not race with other threads' parsing
+ * @param[in] isa the instruction set, falls back to @ref JSMN_ISA_AUTO if
+ *      unsupported by the running CPU
+ * @return the instruction set now in use
+ */
+JSMN_API enum jsmn_isa jsmn_fast_select(enum jsmn_isa isa);
+
 /**
  * @brief Utility function for unescaping a Unicode string
  *
@@ -161,6 +224,9 @@ JSMN_API long jsmnf_unescape(char buf[],
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
 
 /* key */
 #define CHASH_KEY_FIELD k
@@ -205,9 +271,6 @@ jsmnf_init(jsmnf_loader *loader)
     loader->pairnext = 0;
 }
 
-#define _JSMNF_STRING_A js
-#define _JSMNF_STRING_B js
-
 static int
 _jsmnf_load_pairs(struct jsmnf_loader *loader,
                   const char *js,
@@ -217,6 +280,7 @@ _jsmnf_load_pairs(struct jsmnf_loader *loader,
                   struct jsmnf_pair *pairs,
                   unsigned num_pairs)
 {
+    static const struct jsmnf_pair blank_pair = { 0 };
     int offset = 0;
 
     if (!num_tokens) return 0;
@@ -229,75 +293,50 @@ _jsmnf_load_pairs(struct jsmnf_loader *loader,
     case JSMN_ARRAY: {
         const unsigned top_idx = loader->pairnext + (1 + tok->size),
                        bottom_idx = loader->pairnext;
-        int ret;
+        int i, ret;
 
-        if (tok->size > (int)(num_pairs - bottom_idx)
-            || top_idx > (num_pairs - bottom_idx))
-        {
+        if (tok->size > (int)(num_pairs - bottom_idx) || top_idx > num_pairs)
             return JSMN_ERROR_NOMEM;
-        }
 
         loader->pairnext = top_idx;
 
-        (void)chash_init_stack(curr, &pairs[bottom_idx], top_idx - bottom_idx,
-                               _JSMNF_TABLE);
+        /* fields are laid out in order, objects are only hashed once
+         *      jsmnf_find() needs it, the spare bucket keeps room for it */
+        curr->fields = &pairs[bottom_idx];
+        curr->capacity = top_idx - bottom_idx;
+        curr->size = tok->size;
+        curr->hashed = 0;
+        curr->fields[tok->size] = blank_pair;
+
+        for (i = 0; i < tok->size; ++i) {
+            struct jsmnf_pair *field = curr->fields + i;
+            const struct jsmntok *_value;
 
-        if (JSMN_OBJECT == tok->type) {
-            while (curr->size < tok->size) {
+            *field = blank_pair;
+            field->state = CHASH_FILLED;
+
+            if (JSMN_OBJECT == tok->type) {
                 const struct jsmntok *_key = tok + 1 + offset;
-                struct jsmnftok key, value = { 0 };
 
-                key.pos = _key->start;
-                key.len = _key->end - _key->start;
+                field->k.pos = _key->start;
+                field->k.len = _key->end - _key->start;
 
                 /* skip Key token */
                 offset += 1;
 
-                /* _key->size > 0 means either an Object or Array */
-                if (_key->size > 0) {
-                    const struct jsmntok *_value = tok + 1 + offset;
-                    struct jsmnf_pair *found = NULL;
-
-                    value.pos = _value->start;
-                    value.len = _value->end - _value->start;
+                /* _key->size > 0 means it has a value */
+                if (!_key->size) continue;
+            }
 
-                    chash_assign(curr, key, value, _JSMNF_TABLE);
-                    (void)chash_lookup_bucket(curr, key, found, _JSMNF_TABLE);
+            _value = tok + 1 + offset;
+            field->v.pos = _value->start;
+            field->v.len = _value->end - _value->start;
 
-                    ret = _jsmnf_load_pairs(loader, js, found, _value,
-                                            num_tokens - offset, pairs,
-                                            num_pairs);
-                    if (ret < 0) return ret;
+            ret = _jsmnf_load_pairs(loader, js, field, _value,
+                                    num_tokens - offset, pairs, num_pairs);
+            if (ret < 0) return ret;
 
-                    offset += ret;
-                }
-                else {
-                    chash_assign(curr, key, value, _JSMNF_TABLE);
-                }
-            }
-        }
-        else if (JSMN_ARRAY == tok->type) {
-            for (; curr->size < tok->size; ++curr->size) {
-                const struct jsmntok *_value = tok + 1 + offset;
-                struct jsmnf_pair *element = curr->fields + curr->size;
-                struct jsmnftok value;
-
-                value.pos = _value->start;
-                value.len = _value->end - _value->start;
-
-                /* assign array element */
-                element->v = value;
-                element->state = CHASH_FILLED;
-                /* unused for array elements */
-                element->k.pos = 0;
-                element->k.len = 0;
-
-                ret = _jsmnf_load_pairs(loader, js, element, _value,
-                                        num_tokens - offset, pairs, num_pairs);
-                if (ret < 0) return ret;
-
-                offset += ret;
-            }
+            offset += ret;
         }
         break;
     }
@@ -313,9 +352,6 @@ _jsmnf_load_pairs(struct jsmnf_loader *loader,
     return offset + 1;
 }
 
-#undef _JSMNF_STRING_A
-#undef _JSMNF_STRING_B
-
 JSMN_API int
 jsmnf_load(struct jsmnf_loader *loader,
            const char *js,
@@ -326,13 +362,12 @@ jsmnf_load(struct jsmnf_loader *loader,
 {
     int ret;
 
-    if (!loader->pairnext) { /* first run, initialize pairs */
+    if (!loader->pairnext) { /* first run, initialize root */
         static const struct jsmnf_pair blank_pair = { 0 };
-        unsigned i = 0;
 
-        for (; i < num_pairs; ++i)
-            pairs[i] = blank_pair;
-        /* root */
+        if (!num_pairs) return JSMN_ERROR_NOMEM;
+
+        pairs[0] = blank_pair;
         pairs[0].v.pos = tokens->start;
         pairs[0].v.len = tokens->end - tokens->start;
 
@@ -348,6 +383,39 @@ jsmnf_load(struct jsmnf_loader *loader,
     return ret;
 }
 
+#define _JSMNF_STRING_A js
+#define _JSMNF_STRING_B js
+
+/* move `head`'s fields from their loading order into a hash table, stays
+ *      unhashed if the temporary copy can't be allocated */
+static void
+_jsmnf_hash_fields(struct jsmnf_pair *head, const char *js)
+{
+    const int size = head->size;
+    struct jsmnf_pair *fields = head->fields, *tmp;
+    int i;
+
+    if (!(tmp = malloc(size * sizeof *tmp))) return;
+
+    memcpy(tmp, fields, size * sizeof *tmp);
+    memset(fields, 0, head->capacity * sizeof *fields);
+
+    (void)chash_init_stack(head, fields, head->capacity, _JSMNF_TABLE);
+    for (i = 0; i < size; ++i) {
+        struct jsmnf_pair *found = NULL;
+
+        chash_assign(head, tmp[i].k, tmp[i].v, _JSMNF_TABLE);
+        (void)chash_lookup_bucket(head, tmp[i].k, found, _JSMNF_TABLE);
+        *found = tmp[i];
+    }
+    head->hashed = 1;
+
+    free(tmp);
+}
+
+#undef _JSMNF_STRING_A
+#undef _JSMNF_STRING_B
+
 #define _JSMNF_STRING_A js
 #define _JSMNF_STRING_B key
 
@@ -362,15 +430,35 @@ jsmnf_find(const struct jsmnf_pair *head,
     if (!key || !head) return NULL;
 
     if (JSMN_OBJECT == head->type) {
-        struct jsmnftok _key;
-        int contains;
+        if (!head->hashed && head->size > JSMNF_LINEAR_MAX)
+            _jsmnf_hash_fields((struct jsmnf_pair *)head, js);
+
+        if (head->hashed) {
+            struct jsmnftok _key;
+            int contains;
 
-        _key.pos = 0;
-        _key.len = length;
+            _key.pos = 0;
+            _key.len = length;
 
-        contains = chash_contains(head, _key, contains, _JSMNF_TABLE);
-        if (contains) {
-            (void)chash_lookup_bucket(head, _key, found, _JSMNF_TABLE);
+            contains = chash_contains(head, _key, contains, _JSMNF_TABLE);
+            if (contains) {
+                (void)chash_lookup_bucket(head, _key, found, _JSMNF_TABLE);
+            }
+        }
+        else {
+            int i;
+
+            /* last one wins on duplicate keys, same as the hash table */
+            for (i = head->size - 1; i >= 0; --i) {
+                struct jsmnf_pair *f = head->fields + i;
+
+                if (f->k.len == (size_t)length
+                    && !strncmp(js + f->k.pos, key, length))
+                {
+                    found = f;
+                    break;
+                }
+            }
         }
     }
     else if (JSMN_ARRAY == head->type) {
@@ -447,44 +535,514 @@ jsmnf_load_auto(struct jsmnf_loader *loader,
                 struct jsmnf_pair **p_pairs,
                 unsigned *num_pairs)
 {
-    int ret;
+    unsigned needed = 1, i;
+
+    /* every object or array takes a bucket per field plus a spare one */
+    for (i = 0; i < num_tokens; ++i)
+        if (JSMN_OBJECT == tokens[i].type || JSMN_ARRAY == tokens[i].type)
+            needed += 1 + tokens[i].size;
 
-    if (NULL == *p_pairs || !*num_pairs) {
-        *p_pairs = calloc(1, sizeof **p_pairs);
-        *num_pairs = 1;
+    /* grow geometrically so a reused buffer settles quickly */
+    if (NULL == *p_pairs || *num_pairs < needed) {
+        unsigned new_size = *p_pairs ? *num_pairs * 2 : 0;
+        void *tmp;
+
+        if (new_size < needed) new_size = needed;
+        if (!(tmp = realloc(*p_pairs, new_size * sizeof **p_pairs)))
+            return JSMN_ERROR_NOMEM;
+
+        *p_pairs = tmp;
+        *num_pairs = new_size;
     }
+    return jsmnf_load(loader, js, tokens, num_tokens, *p_pairs, *num_pairs);
+}
 
-    while (1) {
-        ret = jsmnf_load(loader, js, tokens, num_tokens, *p_pairs, *num_pairs);
-        if (ret != JSMN_ERROR_NOMEM)
+#undef RECALLOC_OR_ERROR
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define _JSMNF_X86
+#endif
+
+#ifdef __GNUC__
+#define _JSMNF_CTZ64(x) (unsigned)__builtin_ctzll(x)
+#else
+static unsigned
+_JSMNF_CTZ64(uint64_t x)
+{
+    unsigned n = 0;
+    for (; !(x & 1); x >>= 1)
+        ++n;
+    return n;
+}
+#endif
+
+/* deeper documents are left to jsmn_parse() */
+#define _JSMNF_FAST_MAX_DEPTH 256
+
+/* a 64-byte block's classification, one bit per byte */
+struct _jsmnf_block {
+    uint64_t quote;
+    uint64_t backslash;
+    /** `{`, `}`, `[`, `]`, `:` and `,` */
+    uint64_t op;
+    /** whitespace */
+    uint64_t ws;
+};
+
+static void
+_jsmnf_classify_scalar(const char s[], struct _jsmnf_block *b)
+{
+    unsigned i;
+
+    memset(b, 0, sizeof *b);
+    for (i = 0; i < 64; ++i) {
+        const uint64_t bit = (uint64_t)1 << i;
+
+        switch (s[i]) {
+        case '"':
+            b->quote |= bit;
             break;
-        else
-            RECALLOC_OR_ERROR(*p_pairs, num_pairs);
+        case '\\':
+            b->backslash |= bit;
+            break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            b->op |= bit;
+            break;
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            b->ws |= bit;
+            break;
+        default:
+            break;
+        }
     }
-    return ret;
 }
 
-#undef RECALLOC_OR_ERROR
+/* amount of leading bytes jsmnf_unescape() can copy as they are: ASCII
+ *      other than backslashes and control characters */
+static size_t
+_jsmnf_plain_span_scalar(const char s[], size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+        if ((signed char)s[i] < 0x20 || s[i] == '\\') break;
+    return i;
+}
+
+#ifdef _JSMNF_X86
+/* '{' | 0x20 == '{' and '[' | 0x20 == '{', the same goes for '}' and ']' */
+#define _JSMNF_CLASSIFY(_vec, _set1, _eq, _or, _movemask)                     \
+    do {                                                                      \
+        const _vec curly = _or(v, _set1(0x20));                               \
+        b->quote |= (uint64_t)(uint32_t)_movemask(_eq(v, _set1('"'))) << i;   \
+        b->backslash |= (uint64_t)(uint32_t)_movemask(_eq(v, _set1('\\')))    \
+                        << i;                                                 \
+        b->op |= (uint64_t)(uint32_t)_movemask(                               \
+                     _or(_or(_eq(curly, _set1('{')), _eq(curly, _set1('}'))), \
+                         _or(_eq(v, _set1(':')), _eq(v, _set1(',')))))        \
+                 << i;                                                        \
+        b->ws |= (uint64_t)(uint32_t)_movemask(                               \
+                     _or(_or(_eq(v, _set1(' ')), _eq(v, _set1('\t'))),       \
+                         _or(_eq(v, _set1('\r')), _eq(v, _set1('\n')))))      \
+                 << i;                                                        \
+    } while (0)
+
+__attribute__((target("sse2"))) static void
+_jsmnf_classify_sse2(const char s[], struct _jsmnf_block *b)
+{
+    unsigned i;
+
+    memset(b, 0, sizeof *b);
+    for (i = 0; i < 64; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        _JSMNF_CLASSIFY(__m128i, _mm_set1_epi8, _mm_cmpeq_epi8,
+                        _mm_or_si128, _mm_movemask_epi8);
+    }
+}
+
+__attribute__((target("avx2"))) static void
+_jsmnf_classify_avx2(const char s[], struct _jsmnf_block *b)
+{
+    unsigned i;
+
+    memset(b, 0, sizeof *b);
+    for (i = 0; i < 64; i += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)(s + i));
+        _JSMNF_CLASSIFY(__m256i, _mm256_set1_epi8, _mm256_cmpeq_epi8,
+                        _mm256_or_si256, _mm256_movemask_epi8);
+    }
+}
+
+#undef _JSMNF_CLASSIFY
 
+/* as signed bytes, control characters and non-ASCII are all below 0x20 */
+__attribute__((target("sse2"))) static size_t
+_jsmnf_plain_span_sse2(const char s[], size_t n)
+{
+    const __m128i backslash = _mm_set1_epi8('\\'), space = _mm_set1_epi8(0x20);
+    size_t i;
+
+    for (i = 0; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        const unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(
+            _mm_cmpeq_epi8(v, backslash), _mm_cmplt_epi8(v, space)));
+
+        if (mask) return i + _JSMNF_CTZ64(mask);
+    }
+    return i + _jsmnf_plain_span_scalar(s + i, n - i);
+}
+
+__attribute__((target("avx2"))) static size_t
+_jsmnf_plain_span_avx2(const char s[], size_t n)
+{
+    const __m256i backslash = _mm256_set1_epi8('\\'),
+                  space = _mm256_set1_epi8(0x20);
+    size_t i;
+
+    for (i = 0; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)(s + i));
+        const unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(
+            _mm256_cmpeq_epi8(v, backslash), _mm256_cmpgt_epi8(space, v)));
+
+        if (mask) return i + _JSMNF_CTZ64(mask);
+    }
+    /* the tail stays in here, calling into the legacy-encoded SSE2 kernel
+     *      with dirty upper halves costs more than the span itself */
+    for (; i < n; ++i)
+        if ((signed char)s[i] < 0x20 || s[i] == '\\') break;
+    return i;
+}
+#endif /* _JSMNF_X86 */
+
+static void (*_jsmnf_classify)(const char s[], struct _jsmnf_block *b);
+static size_t (*_jsmnf_plain_span)(const char s[], size_t n);
+/* the default instruction set is picked once, by whichever thread parses
+ *      first */
+static pthread_once_t _jsmnf_select_once = PTHREAD_ONCE_INIT;
+
+static enum jsmn_isa
+_jsmnf_select(enum jsmn_isa isa)
+{
+    int has_sse2 = 0, has_avx2 = 0;
+
+#ifdef _JSMNF_X86
+    __builtin_cpu_init();
+    has_sse2 = __builtin_cpu_supports("sse2");
+    has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    if ((JSMN_ISA_SSE2 == isa && !has_sse2)
+        || (JSMN_ISA_AVX2 == isa && !has_avx2))
+        isa = JSMN_ISA_AUTO;
+    if (JSMN_ISA_AUTO == isa)
+        isa = has_avx2   ? JSMN_ISA_AVX2
+              : has_sse2 ? JSMN_ISA_SSE2
+                         : JSMN_ISA_SCALAR;
+
+    switch (isa) {
+#ifdef _JSMNF_X86
+    case JSMN_ISA_AVX2:
+        _jsmnf_classify = &_jsmnf_classify_avx2;
+        _jsmnf_plain_span = &_jsmnf_plain_span_avx2;
+        break;
+    case JSMN_ISA_SSE2:
+        _jsmnf_classify = &_jsmnf_classify_sse2;
+        _jsmnf_plain_span = &_jsmnf_plain_span_sse2;
+        break;
+#endif
+    default:
+        _jsmnf_classify = &_jsmnf_classify_scalar;
+        _jsmnf_plain_span = &_jsmnf_plain_span_scalar;
+        break;
+    }
+    return isa;
+}
+
+static void
+_jsmnf_select_auto(void)
+{
+    (void)_jsmnf_select(JSMN_ISA_AUTO);
+}
+
+JSMN_API enum jsmn_isa
+jsmn_fast_select(enum jsmn_isa isa)
+{
+    /* so that a later default selection can't override this one */
+    pthread_once(&_jsmnf_select_once, &_jsmnf_select_auto);
+    return _jsmnf_select(isa);
+}
+
+/* bytes escaped by an odd run of backslashes, `p_carry` tells if the next
+ *      block's first byte is escaped */
+static uint64_t
+_jsmnf_escaped(uint64_t backslash, uint64_t *p_carry)
+{
+    const uint64_t even = 0x5555555555555555ULL;
+    uint64_t follows, odd_starts, sum;
+
+    backslash &= ~*p_carry;
+    follows = (backslash << 1) | *p_carry;
+    odd_starts = backslash & ~even & ~follows;
+    sum = odd_starts + backslash;
+    *p_carry = sum < odd_starts;
+
+    return (even ^ (sum << 1)) & follows;
+}
+
+/* sets every bit from an opening quote up to (excluding) its closing one */
+static uint64_t
+_jsmnf_prefix_xor(uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/* same escape sequences accepted by jsmn_parse_string() */
 static int
-_jsmnf_read_4_digits(char *s, const char *end, unsigned *p_hex)
+_jsmnf_escapes_valid(const char *s, const char *end)
 {
-    char buf[5] = { 0 };
+    int i;
+
+    for (; s < end; ++s) {
+        if (*s != '\\') continue;
+        if (++s >= end) return 0;
+
+        switch (*s) {
+        case '"':
+        case '/':
+        case '\\':
+        case 'b':
+        case 'f':
+        case 'r':
+        case 'n':
+        case 't':
+            break;
+        case 'u':
+            for (i = 0; i < 4; ++i) {
+                const char c = *++s;
+
+                if (s >= end
+                    || !(('0' <= c && c <= '9') || ('A' <= c && c <= 'F')
+                         || ('a' <= c && c <= 'f')))
+                    return 0;
+            }
+            break;
+        default:
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static struct jsmntok *
+_jsmnf_fast_token(struct jsmntok **p_tokens,
+                  unsigned *num_tokens,
+                  unsigned toknext)
+{
+    if (toknext >= *num_tokens) {
+        const unsigned new_size = *num_tokens * 2;
+        void *tmp = realloc(*p_tokens, new_size * sizeof **p_tokens);
+
+        if (!tmp) return NULL;
+        *p_tokens = tmp;
+        *num_tokens = new_size;
+    }
+    return *p_tokens + toknext;
+}
+
+JSMN_API int
+jsmn_parse_fast(struct jsmn_parser *parser,
+                const char *js,
+                size_t length,
+                struct jsmntok **p_tokens,
+                unsigned *num_tokens)
+{
+#if defined(JSMN_STRICT) || defined(JSMN_PARENT_LINKS)
+    return jsmn_parse_auto(parser, js, length, p_tokens, num_tokens);
+#else
+    int stack[_JSMNF_FAST_MAX_DEPTH], depth = 0;
+    int toksuper = -1, str_start = -1;
+    unsigned toknext = 0;
+    uint64_t esc_carry = 0, str_carry = 0, scalar_carry = 0;
+    const char *nul;
+    size_t len = length, offset;
+
+    if (parser->pos || parser->toknext || length > INT_MAX) goto _fallback;
+    /* jsmn_parse() stops at the first NUL */
+    if ((nul = memchr(js, '\0', len))) len = (size_t)(nul - js);
+
+    pthread_once(&_jsmnf_select_once, &_jsmnf_select_auto);
+
+    if (NULL == *p_tokens || !*num_tokens) {
+        /* about a token per dozen bytes on Discord payloads */
+        const unsigned size = (unsigned)(len / 16) + 16;
+        void *tmp = realloc(*p_tokens, size * sizeof **p_tokens);
+
+        if (!tmp) return JSMN_ERROR_NOMEM;
+        *p_tokens = tmp;
+        *num_tokens = size;
+    }
+
+    for (offset = 0; offset < len; offset += 64) {
+        uint64_t quote, in_string, scalar, bits;
+        struct _jsmnf_block b;
+
+        if (len - offset >= 64) {
+            _jsmnf_classify(js + offset, &b);
+        }
+        else { /* pad the tail with whitespace */
+            char tail[64];
+
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, js + offset, len - offset);
+            _jsmnf_classify(tail, &b);
+        }
+
+        quote = b.quote & ~_jsmnf_escaped(b.backslash, &esc_carry);
+        in_string = _jsmnf_prefix_xor(quote) ^ str_carry;
+        str_carry = (uint64_t)0 - (in_string >> 63);
+        /* primitives start at the first byte of a run of these */
+        scalar = ~(b.ws | b.op | quote | in_string);
+        bits = (b.op & ~in_string) | quote
+               | (scalar & ~((scalar << 1) | scalar_carry));
+        scalar_carry = scalar >> 63;
+
+        for (; bits; bits &= bits - 1) {
+            const int pos = (int)(offset + _JSMNF_CTZ64(bits));
+            const char c = js[pos];
+            struct jsmntok *tok;
+
+            switch (c) {
+            case '{':
+            case '[':
+                if (depth == _JSMNF_FAST_MAX_DEPTH) goto _fallback;
+                if (!(tok = _jsmnf_fast_token(p_tokens, num_tokens, toknext)))
+                    return JSMN_ERROR_NOMEM;
+
+                tok->type = (c == '{' ? JSMN_OBJECT : JSMN_ARRAY);
+                tok->start = pos;
+                tok->end = -1;
+                tok->size = 0;
+                if (toksuper != -1) ++(*p_tokens)[toksuper].size;
+                toksuper = stack[depth++] = (int)toknext++;
+                break;
+            case '}':
+            case ']':
+                if (!depth
+                    || (*p_tokens)[stack[depth - 1]].type
+                           != (c == '}' ? JSMN_OBJECT : JSMN_ARRAY))
+                    goto _fallback;
+
+                (*p_tokens)[stack[--depth]].end = pos + 1;
+                toksuper = depth ? stack[depth - 1] : -1;
+                break;
+            case ':':
+                toksuper = (int)toknext - 1;
+                break;
+            case ',':
+                if (toksuper != -1 && depth
+                    && (*p_tokens)[toksuper].type != JSMN_ARRAY
+                    && (*p_tokens)[toksuper].type != JSMN_OBJECT)
+                    toksuper = stack[depth - 1];
+                break;
+            case '"':
+                if (str_start == -1) {
+                    str_start = pos;
+                    break;
+                }
+                if (memchr(js + str_start + 1, '\\', pos - str_start - 1)
+                    && !_jsmnf_escapes_valid(js + str_start + 1, js + pos))
+                    goto _fallback;
+                if (!(tok = _jsmnf_fast_token(p_tokens, num_tokens, toknext)))
+                    return JSMN_ERROR_NOMEM;
+
+                tok->type = JSMN_STRING;
+                tok->start = str_start + 1;
+                tok->end = pos;
+                tok->size = 0;
+                if (toksuper != -1) ++(*p_tokens)[toksuper].size;
+                ++toknext;
+                str_start = -1;
+                break;
+            default: {
+                size_t end = pos;
+
+                /* jsmn_parse_primitive() would take quotes and brackets in */
+                for (; end < len; ++end) {
+                    const unsigned char p = js[end];
+
+                    if (p == ':' || p == '\t' || p == '\r' || p == '\n'
+                        || p == ' ' || p == ',' || p == ']' || p == '}')
+                        break;
+                    if (p < 32 || p >= 127 || p == '"' || p == '{'
+                        || p == '[')
+                        goto _fallback;
+                }
+                if (!(tok = _jsmnf_fast_token(p_tokens, num_tokens, toknext)))
+                    return JSMN_ERROR_NOMEM;
+
+                tok->type = JSMN_PRIMITIVE;
+                tok->start = pos;
+                tok->end = (int)end;
+                tok->size = 0;
+                if (toksuper != -1) ++(*p_tokens)[toksuper].size;
+                ++toknext;
+            } break;
+            }
+        }
+    }
+    if (str_start != -1 || depth) goto _fallback;
+
+    parser->pos = (unsigned)len;
+    parser->toknext = toknext;
+    parser->toksuper = toksuper;
+    return (int)toknext;
+#endif /* JSMN_STRICT || JSMN_PARENT_LINKS */
+
+_fallback:
+    jsmn_init(parser);
+    return jsmn_parse_auto(parser, js, length, p_tokens, num_tokens);
+}
+
+#undef _JSMNF_CTZ64
+#undef _JSMNF_FAST_MAX_DEPTH
+
+static int
+_jsmnf_read_4_digits(const char *s, const char *end, unsigned *p_hex)
+{
+    unsigned hex = 0;
     int i;
 
     if (end - s < 4) return JSMN_ERROR_PART;
 
     for (i = 0; i < 4; i++) {
-        buf[i] = s[i];
-        if (('0' <= s[i] && s[i] <= '9') || ('A' <= s[i] && s[i] <= 'F')
-            || ('a' <= s[i] && s[i] <= 'f'))
-        {
-            continue;
-        }
-        return JSMN_ERROR_INVAL;
+        const char c = s[i];
+
+        if ('0' <= c && c <= '9')
+            hex = (hex << 4) | (unsigned)(c - '0');
+        else if ('A' <= c && c <= 'F')
+            hex = (hex << 4) | (unsigned)(c - 'A' + 10);
+        else if ('a' <= c && c <= 'f')
+            hex = (hex << 4) | (unsigned)(c - 'a' + 10);
+        else
+            return JSMN_ERROR_INVAL;
     }
 
-    *p_hex = (unsigned)strtoul(buf, NULL, 16);
+    *p_hex = hex;
 
     return 4;
 }
@@ -578,17 +1136,6 @@ _jsmnf_utf8_next(char **p, const char *end)
     return c;
 }
 
-static long
-_jsmnf_utf8_validate(char *p, const char *end)
-{
-    const char *start = p;
-    while (p != end) {
-        if (_jsmnf_utf8_next(&p, end) == _JSMNF_UTF_ILLEGAL)
-            return JSMN_ERROR_INVAL;
-    }
-    return (long)(end - start);
-}
-
 static unsigned
 _jsmnf_utf8_encode(unsigned long value, char utf8_seq[4])
 {
@@ -637,30 +1184,47 @@ _jsmnf_utf8_append(unsigned long hex, char *buf_tok, const char *buf_end)
 JSMN_API long
 jsmnf_unescape(char buf[], size_t bufsize, const char src[], size_t len)
 {
-    char *src_tok = (char *)src, *const src_end = src_tok + len;
+    const char *src_tok = src, *const src_end = src + len;
     char *buf_tok = buf, *const buf_end = buf + bufsize;
-    int second_surrogate_expected = 0;
-    unsigned first_surrogate = 0;
 
-    while (*src_tok && src_tok < src_end) {
-        char c = *src_tok++;
+    pthread_once(&_jsmnf_select_once, &_jsmnf_select_auto);
 
-        if (0 <= c && c <= 0x1F) return JSMN_ERROR_INVAL;
+    while (src_tok < src_end) {
+        size_t n = (size_t)(src_end - src_tok);
+        unsigned char c;
 
-        if (c != '\\') {
-            if (second_surrogate_expected) return JSMN_ERROR_INVAL;
-            BUF_PUSH(buf_tok, c, buf_end);
+        /* runs of plain ASCII are copied as they are */
+        if (n > (size_t)(buf_end - buf_tok)) n = (size_t)(buf_end - buf_tok);
+        n = _jsmnf_plain_span(src_tok, n);
+        memcpy(buf_tok, src_tok, n);
+        src_tok += n;
+        buf_tok += n;
+
+        if (src_tok == src_end) break;
+
+        c = (unsigned char)*src_tok;
+        if (!c) break;
+        if (c <= 0x1F) return JSMN_ERROR_INVAL;
+
+        if (c >= 0x80) { /* validate and copy a whole UTF-8 sequence */
+            char *next = (char *)src_tok;
+
+            if (_jsmnf_utf8_next(&next, src_end) == _JSMNF_UTF_ILLEGAL)
+                return JSMN_ERROR_INVAL;
+            if (next - src_tok > buf_end - buf_tok) return JSMN_ERROR_NOMEM;
+
+            memcpy(buf_tok, src_tok, next - src_tok);
+            buf_tok += next - src_tok;
+            src_tok = next;
             continue;
         }
+        /* a plain character the buffer has no more room for */
+        if (c != '\\') return JSMN_ERROR_NOMEM;
 
         /* expects escaping but src is a well-formed string */
-        if (!*src_tok || src_tok >= src_end) return JSMN_ERROR_PART;
-
-        c = *src_tok++;
+        if (++src_tok >= src_end || !*src_tok) return JSMN_ERROR_PART;
 
-        if (second_surrogate_expected && c != 'u') return JSMN_ERROR_INVAL;
-
-        switch (c) {
+        switch (c = *src_tok++) {
         case '"':
         case '\\':
         case '/':
@@ -682,42 +1246,45 @@ jsmnf_unescape(char buf[], size_t bufsize, const char src[], size_t len)
             BUF_PUSH(buf_tok, '\t', buf_end);
             break;
         case 'u': {
-            unsigned hex;
+            unsigned long value;
+            unsigned hex, second;
             int ret = _jsmnf_read_4_digits(src_tok, src_end, &hex);
 
             if (ret != 4) return ret;
 
             src_tok += ret;
-
-            if (second_surrogate_expected) {
-                if (!_JSMNF_UTF16_IS_SECOND_SURROGATE(hex))
+            value = hex;
+
+            if (_JSMNF_UTF16_IS_SECOND_SURROGATE(hex)) return JSMN_ERROR_INVAL;
+
+            if (_JSMNF_UTF16_IS_FIRST_SURROGATE(hex)) {
+                /* the pair's second half must follow right away, a first
+                 *      half ending the string is dropped */
+                if (src_tok >= src_end || !*src_tok) break;
+                if (*src_tok != '\\') return JSMN_ERROR_INVAL;
+                if (src_tok + 1 >= src_end || !src_tok[1])
+                    return JSMN_ERROR_PART;
+                if (src_tok[1] != 'u') return JSMN_ERROR_INVAL;
+
+                ret = _jsmnf_read_4_digits(src_tok + 2, src_end, &second);
+                if (ret != 4) return ret;
+                if (!_JSMNF_UTF16_IS_SECOND_SURROGATE(second))
                     return JSMN_ERROR_INVAL;
 
-                ret = _jsmnf_utf8_append(
-                    _JSMNF_UTF16_JOIN_SURROGATE(first_surrogate, hex), buf_tok,
-                    buf_end);
-                if (ret < 0) return ret;
-
-                buf_tok += ret;
-
-                second_surrogate_expected = 0;
+                src_tok += 2 + ret;
+                value = _JSMNF_UTF16_JOIN_SURROGATE(hex, second);
             }
-            else if (_JSMNF_UTF16_IS_FIRST_SURROGATE(hex)) {
-                second_surrogate_expected = 1;
-                first_surrogate = hex;
-            }
-            else {
-                ret = _jsmnf_utf8_append(hex, buf_tok, buf_end);
-                if (ret < 0) return ret;
 
-                buf_tok += ret;
-            }
+            ret = _jsmnf_utf8_append(value, buf_tok, buf_end);
+            if (ret < 0) return ret;
+
+            buf_tok += ret;
         } break;
         default:
             return JSMN_ERROR_INVAL;
         }
     }
-    return _jsmnf_utf8_validate(buf, buf_tok);
+    return (long)(buf_tok - buf);
 }
 
 #undef BUF_PUSH
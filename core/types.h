@@ -5,6 +5,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 /** @defgroup ConcordTypes Primitives
  *  @brief Commonly used datatypes
@@ -69,6 +70,22 @@ struct ccord_szbuf_reusable {
     size_t realsize;
 };
 
+/**
+ * @brief Bump allocator, its allocations are released all at once
+ * @see cog_arena_init()
+ */
+struct ccord_arena {
+    /** the block allocations are taken from, starts with a pointer to the
+     *      previous block */
+    char *block;
+    /** bytes taken from the current block */
+    size_t size;
+    /** bytes available at the current block */
+    size_t realsize;
+    /** the block was given by the user and can't grow */
+    bool fixed;
+};
+
 /** @} ConcordTypes */
 
 #endif /* CONCORD_TYPES_H */
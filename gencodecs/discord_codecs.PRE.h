@@ -2,6 +2,7 @@
 
 #ifdef GENCODECS_HEADER
 PP_INCLUDE(<inttypes.h>)
+PP_INCLUDE(<limits.h>)
 PP_INCLUDE("carray.h")
 PP_INCLUDE("cog-utils.h")
 PP_INCLUDE("types.h")
@@ -41,20 +42,49 @@ PP_INCLUDE("types.h")
 /* Custom JSON decoding macros */
 #define GENCODECS_JSON_DECODER_PTR_json_char(_f, _js, _var, _type)            \
     if (_f) {                                                                 \
-        _var = _gc_strndup(js + _f->v.pos, _f->v.len);                        \
+        GENCODECS_JSON_DECODER_RELEASE(_var, (void)0);                        \
+        _var = GENCODECS_JSON_DECODER_ALLOC(_f->v.len + 1);                   \
+        if (NULL == _var) return JSMN_ERROR_NOMEM;                            \
+        memcpy(_var, js + _f->v.pos, _f->v.len);                              \
         ret += _f->v.len;                                                     \
     }
+#define GENCODECS_JSON_FLAT_SIZE_PTR_json_char(_f, _size)                     \
+    if (_f) _size += COG_ARENA_SIZEOF(_f->v.len + 1)
 #define GENCODECS_JSON_DECODER_size_t(_f, _js, _var, _type)                   \
-    if (_f && _f->type == JSMN_PRIMITIVE)                                     \
-        _var = (size_t)strtoull(_js + _f->v.pos, NULL, 10)
+    if (_f && _f->type == JSMN_PRIMITIVE) {                                   \
+        uint64_t _u64 = 0;                                                    \
+        cog_strtou64(_js + _f->v.pos, _f->v.len, &_u64);                      \
+        _var = (size_t)_u64;                                                  \
+    }
 #define GENCODECS_JSON_DECODER_uint64_t(_f, _js, _var, _type)                 \
-    if (_f) sscanf(_js + _f->v.pos, "%" SCNu64, &_var)
+    if (_f) cog_strtou64(_js + _f->v.pos, _f->v.len, &_var)
 #define GENCODECS_JSON_DECODER_u64snowflake GENCODECS_JSON_DECODER_uint64_t
 #define GENCODECS_JSON_DECODER_u64bitmask GENCODECS_JSON_DECODER_uint64_t
 #define GENCODECS_JSON_DECODER_u64unix_ms(_f, _js, _var, _type)               \
     if (_f && _f->type == JSMN_STRING)                                        \
         cog_iso8601_to_unix_ms(_js + _f->v.pos, _f->v.len, &_var)
 
+/* Custom binary encoding macros */
+#define GENCODECS_BIN_ENCODER_PTR_json_char GENCODECS_BIN_ENCODER_PTR_char
+#define GENCODECS_BIN_ENCODER_uint64_t(_var) GENCODECS_BIN_PUT(_var)
+#define GENCODECS_BIN_ENCODER_u64snowflake GENCODECS_BIN_ENCODER_uint64_t
+#define GENCODECS_BIN_ENCODER_u64bitmask GENCODECS_BIN_ENCODER_uint64_t
+#define GENCODECS_BIN_ENCODER_u64unix_ms GENCODECS_BIN_ENCODER_uint64_t
+
+/* Custom binary decoding macros */
+#define GENCODECS_BIN_DECODER_PTR_json_char GENCODECS_BIN_DECODER_PTR_char
+#define GENCODECS_BIN_DECODER_uint64_t(_var) { GENCODECS_BIN_GET(_var); }
+#define GENCODECS_BIN_DECODER_u64snowflake GENCODECS_BIN_DECODER_uint64_t
+#define GENCODECS_BIN_DECODER_u64bitmask GENCODECS_BIN_DECODER_uint64_t
+#define GENCODECS_BIN_DECODER_u64unix_ms GENCODECS_BIN_DECODER_uint64_t
+
+/* Custom JSON view getters */
+#define GENCODECS_JSON_VIEW_GETTERS(_getter)                                  \
+    _getter(size_t)                                                           \
+    _getter(u64snowflake)                                                     \
+    _getter(u64bitmask)                                                       \
+    _getter(u64unix_ms)
+
 /* Custom field macros */
 #define FIELD_SNOWFLAKE(_name)                                                \
     FIELD_PRINTF(_name, u64snowflake, "\"%" PRIu64 "\"", "%" SCNu64)
@@ -11,10 +11,26 @@
 #include "recipes/struct.h"
 #undef GENCODECS_RECIPE
 
+#define GENCODECS_RECIPE DATA
+#include "recipes/copy.h"
+#undef GENCODECS_RECIPE
+
+#define GENCODECS_RECIPE DATA
+#include "recipes/binary.h"
+#undef GENCODECS_RECIPE
+
 #define GENCODECS_RECIPE JSON_DECODER
 #include "recipes/json-decoder.h"
 #undef GENCODECS_RECIPE
 
+#define GENCODECS_RECIPE JSON_DECODER
+#include "recipes/json-decoder-flat.h"
+#undef GENCODECS_RECIPE
+
+#define GENCODECS_RECIPE JSON_DECODER
+#include "recipes/json-view.h"
+#undef GENCODECS_RECIPE
+
 #define GENCODECS_RECIPE JSON_ENCODER
 #include "recipes/json-encoder.h"
 #undef GENCODECS_RECIPE
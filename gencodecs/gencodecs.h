@@ -42,16 +42,6 @@ GENCODECS_PP_INCLUDE(<string.h>)
 #       ifdef GENCODECS_INIT
 GENCODECS_PP_INCLUDE("carray.h")
 #       endif
-#       if defined(GENCODECS_JSON_DECODER) && defined(GENCODECS_FORWARD)
-static char *
-_gc_strndup(const char *src, size_t len)
-{
-    char *dest = malloc(len + 1);
-    memcpy(dest, src, len);
-    dest[len] = '\0';
-    return dest;
-}
-#       endif /* GENCODECS_JSON_DECODER && GENCODECS_FORWARD */
 #   endif /* GENCODECS_DATA */
 #else
 GENCODECS_PP_INCLUDE(<stddef.h>)
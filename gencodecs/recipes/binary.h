@@ -0,0 +1,220 @@
+/* compact binary form: fields are written in declaration order without
+ *      keys, integers as varints and strings/lists prefixed by their
+ *      length plus one (0 stands for NULL). The layout follows the specs,
+ *      so it is only meant to be read back by the same library version */
+#define GENCODECS_BIN_PUT(_value)                                             \
+    do {                                                                      \
+        if (0 > cog_varint_put(buf, size, pos, (uint64_t)(_value)))           \
+            return -1;                                                        \
+    } while (0)
+#define GENCODECS_BIN_GET(_value)                                             \
+    do {                                                                      \
+        if (0 > cog_varint_get(buf, size, pos, &_value)) return -1;           \
+    } while (0)
+
+#define GENCODECS_BIN_ENCODER_int(_var)                                       \
+    GENCODECS_BIN_PUT(((uint64_t)(_var) << 1)                                 \
+                      ^ (uint64_t)((_var) < 0 ? -1 : 0))
+#define GENCODECS_BIN_ENCODER_bool(_var) GENCODECS_BIN_PUT((_var) ? 1 : 0)
+#define GENCODECS_BIN_ENCODER_size_t(_var) GENCODECS_BIN_PUT(_var)
+#define GENCODECS_BIN_ENCODER_PTR_char(_var)                                  \
+    if (!(_var))                                                              \
+        GENCODECS_BIN_PUT(0);                                                 \
+    else {                                                                    \
+        const size_t _len = strlen(_var);                                     \
+        GENCODECS_BIN_PUT(_len + 1);                                          \
+        if (_len > size - *pos) return -1;                                    \
+        memcpy(buf + *pos, _var, _len);                                       \
+        *pos += _len;                                                         \
+    }
+
+#define GENCODECS_BIN_DECODER_int(_var)                                       \
+    {                                                                         \
+        uint64_t _v;                                                          \
+        GENCODECS_BIN_GET(_v);                                                \
+        _var = (int)((int64_t)(_v >> 1) ^ -(int64_t)(_v & 1));                \
+    }
+#define GENCODECS_BIN_DECODER_bool(_var)                                      \
+    {                                                                         \
+        uint64_t _v;                                                          \
+        GENCODECS_BIN_GET(_v);                                                \
+        _var = (_v != 0);                                                     \
+    }
+#define GENCODECS_BIN_DECODER_size_t(_var)                                    \
+    {                                                                         \
+        uint64_t _v;                                                          \
+        GENCODECS_BIN_GET(_v);                                                \
+        _var = (size_t)_v;                                                    \
+    }
+#define GENCODECS_BIN_DECODER_PTR_char(_var)                                  \
+    {                                                                         \
+        uint64_t _v;                                                          \
+        GENCODECS_BIN_GET(_v);                                                \
+        if (_v) {                                                             \
+            if (_v - 1 > size - *pos) return -1;                              \
+            if (NULL == (_var = malloc(_v))) return -1;                       \
+            memcpy(_var, buf + *pos, _v - 1);                                 \
+            _var[_v - 1] = '\0';                                              \
+            *pos += _v - 1;                                                   \
+        }                                                                     \
+    }
+
+#ifdef GENCODECS_BINARY
+#ifdef GENCODECS_INIT
+#ifdef GENCODECS_HEADER
+
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    int _type##_to_binb(char buf[], size_t size, size_t *pos,                 \
+                        const struct _type *self);                            \
+    size_t _type##_to_bin(char buf[], size_t size, const struct _type *self); \
+    int _type##_from_binb(const char buf[], size_t size, size_t *pos,         \
+                          struct _type *self);                                \
+    size_t _type##_from_bin(const char buf[], size_t size,                    \
+                            struct _type *self);
+#define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#elif defined(GENCODECS_FORWARD)
+
+#define GENCODECS_STRUCT(_type)                                               \
+    static int _type##_to_binb(char buf[], size_t size, size_t *pos,          \
+                               const struct _type *self);                     \
+    static int _type##_from_binb(const char buf[], size_t size, size_t *pos,  \
+                                 struct _type *self);
+#define GENCODECS_LIST(_type) GENCODECS_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#else
+
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    int _type##_to_binb(char buf[], size_t size, size_t *pos,                 \
+                        const struct _type *self)                             \
+    {
+#define GENCODECS_STRUCT(_type)                                               \
+    static GENCODECS_PUB_STRUCT(_type)
+#define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
+                               _encoder, _decoder, _default_value)            \
+        GENCODECS_BIN_ENCODER_##_type(self->_name);
+#define GENCODECS_FIELD_PRINTF(_name, _type, _printf_type, _scanf_type)       \
+        GENCODECS_BIN_PUT(self->_name);
+#define GENCODECS_FIELD_PTR(_name, _type, _decor)                             \
+        GENCODECS_BIN_ENCODER_PTR_##_type(self->_name);
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+        GENCODECS_BIN_PUT(self->_name != NULL);                               \
+        if (self->_name && 0 > _type##_to_binb(buf, size, pos, self->_name))  \
+            return -1;
+#define GENCODECS_STRUCT_END                                                  \
+        return 0;                                                             \
+    }
+
+#define GENCODECS_PUB_LIST(_type)                                             \
+    int _type##_to_binb(char buf[], size_t size, size_t *pos,                 \
+                        const struct _type *self)                             \
+    {                                                                         \
+        int i;                                                                \
+        GENCODECS_BIN_PUT(self->size > 0 ? self->size : 0);
+#define GENCODECS_LIST(_type)                                                 \
+    static GENCODECS_PUB_LIST(_type)
+#define GENCODECS_LISTTYPE(_type)                                             \
+        for (i = 0; i < self->size; ++i)                                      \
+            GENCODECS_BIN_ENCODER_##_type(self->array[i]);
+#define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
+        for (i = 0; i < self->size; ++i)                                      \
+            if (0 > _type##_to_binb(buf, size, pos, self->array + i))         \
+                return -1;
+#define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
+        for (i = 0; i < self->size; ++i)                                      \
+            GENCODECS_BIN_ENCODER_PTR_##_type(self->array[i]);
+#define GENCODECS_LIST_END                                                    \
+        return 0;                                                             \
+    }
+
+#include "gencodecs-gen.PRE.h"
+
+/* on failure `self` may be partially filled, and should be cleaned up */
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    int _type##_from_binb(const char buf[], size_t size, size_t *pos,         \
+                          struct _type *self)                                 \
+    {                                                                         \
+        memset(self, 0, sizeof *self);
+#define GENCODECS_STRUCT(_type)                                               \
+    static GENCODECS_PUB_STRUCT(_type)
+#define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
+                               _encoder, _decoder, _default_value)            \
+        GENCODECS_BIN_DECODER_##_type(self->_name)
+#define GENCODECS_FIELD_PRINTF(_name, _type, _printf_type, _scanf_type)       \
+        {                                                                     \
+            uint64_t _v;                                                      \
+            GENCODECS_BIN_GET(_v);                                            \
+            self->_name = (_type)_v;                                          \
+        }
+#define GENCODECS_FIELD_PTR(_name, _type, _decor)                             \
+        GENCODECS_BIN_DECODER_PTR_##_type(self->_name)
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+        {                                                                     \
+            uint64_t _v;                                                      \
+            GENCODECS_BIN_GET(_v);                                            \
+            if (_v) {                                                         \
+                if (NULL == (self->_name = malloc(sizeof *self->_name)))      \
+                    return -1;                                                \
+                if (0 > _type##_from_binb(buf, size, pos, self->_name))       \
+                    return -1;                                                \
+            }                                                                 \
+        }
+#define GENCODECS_STRUCT_END                                                  \
+        return 0;                                                             \
+    }
+
+/* every element takes at least a byte, which bounds the allocation */
+#define GENCODECS_PUB_LIST(_type)                                             \
+    int _type##_from_binb(const char buf[], size_t size, size_t *pos,         \
+                          struct _type *self)                                 \
+    {                                                                         \
+        uint64_t _n;                                                          \
+        int i;                                                                \
+        memset(self, 0, sizeof *self);                                        \
+        GENCODECS_BIN_GET(_n);                                                \
+        if (_n > size - *pos || _n > INT_MAX) return -1;                      \
+        if (!_n) return 0;                                                    \
+        if (NULL == (self->array = calloc(_n, sizeof *self->array)))          \
+            return -1;                                                        \
+        self->size = self->realsize = (int)_n;
+#define GENCODECS_LIST(_type)                                                 \
+    static GENCODECS_PUB_LIST(_type)
+#define GENCODECS_LISTTYPE(_type)                                             \
+        for (i = 0; i < self->size; ++i)                                      \
+            GENCODECS_BIN_DECODER_##_type(self->array[i])
+#define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
+        for (i = 0; i < self->size; ++i)                                      \
+            if (0 > _type##_from_binb(buf, size, pos, self->array + i))       \
+                return -1;
+#define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
+        for (i = 0; i < self->size; ++i)                                      \
+            GENCODECS_BIN_DECODER_PTR_##_type(self->array[i])
+#define GENCODECS_LIST_END                                                    \
+        return 0;                                                             \
+    }
+
+#include "gencodecs-gen.PRE.h"
+
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    size_t _type##_to_bin(char buf[], size_t size, const struct _type *self)  \
+    {                                                                         \
+        size_t pos = 0;                                                       \
+        return _type##_to_binb(buf, size, &pos, self) < 0 ? 0 : pos;          \
+    }                                                                         \
+    size_t _type##_from_bin(const char buf[], size_t size,                    \
+                            struct _type *self)                               \
+    {                                                                         \
+        size_t pos = 0;                                                       \
+        return _type##_from_binb(buf, size, &pos, self) < 0 ? 0 : pos;        \
+    }
+#define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#endif /* GENCODECS_HEADER */
+#endif /* GENCODECS_INIT */
+#endif /* GENCODECS_BINARY */
@@ -0,0 +1,95 @@
+/* deep copies duplicate every field without going through a serialized
+ *      form, `dst` can always be released with its cleanup method, even if
+ *      the copy fails halfway */
+#define GENCODECS_COPY_STR(_dst, _src)                                        \
+    if (_src) {                                                               \
+        const size_t _len = strlen(_src) + 1;                                 \
+        if (NULL == (_dst = malloc(_len))) return false;                      \
+        memcpy(_dst, _src, _len);                                             \
+    }
+
+#ifdef GENCODECS_INIT
+#ifdef GENCODECS_HEADER
+
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    bool _type##_copy(struct _type *dst, const struct _type *src);            \
+    void _type##_move(struct _type *dst, struct _type *src);
+#define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#elif defined(GENCODECS_FORWARD)
+
+#define GENCODECS_STRUCT(_type)                                               \
+    static bool _type##_copy(struct _type *dst, const struct _type *src);
+#define GENCODECS_LIST(_type) GENCODECS_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#else
+
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    bool _type##_copy(struct _type *dst, const struct _type *src)             \
+    {                                                                         \
+        memset(dst, 0, sizeof *dst);
+#define GENCODECS_STRUCT(_type)                                               \
+    static GENCODECS_PUB_STRUCT(_type)
+#define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
+                               _encoder, _decoder, _default_value)            \
+        dst->_name = src->_name;
+#define GENCODECS_FIELD_PRINTF(_name, _type, printf_type, _scanf_type)        \
+        dst->_name = src->_name;
+#define GENCODECS_FIELD_PTR(_name, _type, _decor)                             \
+        GENCODECS_COPY_STR(dst->_name, src->_name)
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+        if (src->_name) {                                                     \
+            if (NULL == (dst->_name = malloc(sizeof *dst->_name)))            \
+                return false;                                                 \
+            if (!_type##_copy(dst->_name, src->_name)) return false;          \
+        }
+#define GENCODECS_STRUCT_END                                                  \
+        return true;                                                          \
+    }
+
+#define GENCODECS_PUB_LIST(_type)                                             \
+    bool _type##_copy(struct _type *dst, const struct _type *src)             \
+    {                                                                         \
+        int i;                                                                \
+        memset(dst, 0, sizeof *dst);                                          \
+        if (src->size <= 0) return true;                                      \
+        if (NULL == (dst->array = calloc(src->size, sizeof *dst->array)))     \
+            return false;                                                     \
+        dst->size = dst->realsize = src->size;                                \
+        (void)i;
+#define GENCODECS_LIST(_type)                                                 \
+    static GENCODECS_PUB_LIST(_type)
+#define GENCODECS_LISTTYPE(_type)                                             \
+        memcpy(dst->array, src->array, sizeof *dst->array * src->size);
+#define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
+        for (i = 0; i < src->size; ++i)                                       \
+            if (!_type##_copy(dst->array + i, src->array + i)) return false;
+#define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
+        for (i = 0; i < src->size; ++i) {                                     \
+            GENCODECS_COPY_STR(dst->array[i], src->array[i])                  \
+        }
+#define GENCODECS_LIST_END                                                    \
+        return true;                                                          \
+    }
+
+#include "gencodecs-gen.PRE.h"
+
+/* the ownership of `src` fields is handed over to `dst` */
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    void _type##_move(struct _type *dst, struct _type *src)                   \
+    {                                                                         \
+        *dst = *src;                                                          \
+        memset(src, 0, sizeof *src);                                          \
+    }
+#define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#endif /* GENCODECS_HEADER */
+#endif /* GENCODECS_INIT */
+
+#undef GENCODECS_COPY_STR
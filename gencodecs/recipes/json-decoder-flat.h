@@ -0,0 +1,170 @@
+/* Flat decoding: a first pass sums up the bytes the decoded object graph
+ *      takes, a second pass lays it out in a single block starting with the
+ *      struct itself, so it can be released with a single free() or copied
+ *      with memcpy() followed by a relocation of its pointers */
+
+#define GENCODECS_JSON_FLAT_SIZE_PTR_char(_f, _size)                          \
+    if (_f && _f->type == JSMN_STRING)                                        \
+        _size += COG_ARENA_SIZEOF(_f->v.len + 1)
+#define GENCODECS_JSON_FLAT_RELOCATE(_var, _delta)                            \
+    _var = (void *)((char *)_var + _delta)
+
+#ifdef GENCODECS_JSON_DECODER
+#ifdef GENCODECS_HEADER
+
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    size_t _type##_flat_size(jsmnf_pair *root, const char *js);               \
+    long _type##_from_jsmnf_flat(jsmnf_pair *root, const char *js,            \
+                                 struct _type **p_self);                      \
+    void _type##_flat_relocate(struct _type *self, ptrdiff_t delta);
+#define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#elif defined(GENCODECS_FORWARD)
+
+#define GENCODECS_STRUCT(_type)                                               \
+    static size_t _type##_flat_size(jsmnf_pair *root, const char *js);        \
+    static void _type##_flat_relocate(struct _type *self, ptrdiff_t delta);
+#define GENCODECS_LIST(_type) GENCODECS_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#else
+
+/* first pass, mirrors the allocations of _type##_from_jsmnf_arena() */
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    size_t _type##_flat_size(jsmnf_pair *root, const char *js)                \
+    {                                                                         \
+        size_t size = COG_ARENA_SIZEOF(sizeof(struct _type));                 \
+        int i;                                                                \
+        for (i = 0; i < root->capacity; ++i) {                                \
+            jsmnf_pair *f = root->fields + i;                                 \
+            if (!f->k.len) continue;
+#define GENCODECS_STRUCT(_type)                                               \
+    static GENCODECS_PUB_STRUCT(_type)
+#define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
+                               _encoder, _decoder, _default_value)
+#define GENCODECS_FIELD_PTR(_name, _type, _decor)                             \
+            if (GENCODECS_JSON_DECODER_KEY(f, js, #_name)) {                  \
+                GENCODECS_JSON_FLAT_SIZE_PTR_##_type(f, size);                \
+                continue;                                                     \
+            }
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+            if (GENCODECS_JSON_DECODER_KEY(f, js, #_name)) {                  \
+                if (f->type == JSMN_OBJECT || f->type == JSMN_ARRAY)          \
+                    size += _type##_flat_size(f, js);                         \
+                continue;                                                     \
+            }
+#define GENCODECS_STRUCT_END                                                  \
+        }                                                                     \
+        return size;                                                          \
+    }
+
+#define GENCODECS_PUB_LIST(_type)                                             \
+    size_t _type##_flat_size(jsmnf_pair *root, const char *js)                \
+    {                                                                         \
+        size_t size = COG_ARENA_SIZEOF(sizeof(struct _type));                 \
+        (void)js;                                                             \
+        if (!root->size) return size;
+#define GENCODECS_LIST(_type)                                                 \
+    static GENCODECS_PUB_LIST(_type)
+#define GENCODECS_LISTTYPE(_type)                                             \
+        size += COG_ARENA_SIZEOF(sizeof(_type) * root->size);
+#define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
+        size += COG_ARENA_SIZEOF(sizeof(struct _type) * root->size);          \
+        {                                                                     \
+            int i;                                                            \
+            for (i = 0; i < root->size; ++i)                                  \
+                size += _type##_flat_size(root->fields + i, js)               \
+                        - COG_ARENA_SIZEOF(sizeof(struct _type));             \
+        }
+#define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
+        size += COG_ARENA_SIZEOF(sizeof(_type _decor) * root->size);          \
+        {                                                                     \
+            int i;                                                            \
+            for (i = 0; i < root->size; ++i) {                                \
+                jsmnf_pair *f = root->fields + i;                             \
+                GENCODECS_JSON_FLAT_SIZE_PTR_##_type(f, size);                \
+            }                                                                 \
+        }
+#define GENCODECS_LIST_END                                                    \
+        return size;                                                          \
+    }
+
+#include "gencodecs-gen.PRE.h"
+
+/* pointers of a copied block still refer to the original one */
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    void _type##_flat_relocate(struct _type *self, ptrdiff_t delta)           \
+    {
+#define GENCODECS_STRUCT(_type)                                               \
+    static GENCODECS_PUB_STRUCT(_type)
+#define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
+                               _encoder, _decoder, _default_value)
+#define GENCODECS_FIELD_PTR(_name, _type, _decor)                             \
+        if (self->_name) GENCODECS_JSON_FLAT_RELOCATE(self->_name, delta);
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+        if (self->_name) {                                                    \
+            GENCODECS_JSON_FLAT_RELOCATE(self->_name, delta);                 \
+            _type##_flat_relocate(self->_name, delta);                        \
+        }
+#define GENCODECS_STRUCT_END                                                  \
+        (void)self;                                                           \
+        (void)delta;                                                          \
+    }
+
+#define GENCODECS_PUB_LIST(_type)                                             \
+    void _type##_flat_relocate(struct _type *self, ptrdiff_t delta)           \
+    {                                                                         \
+        if (!self->array) return;                                             \
+        GENCODECS_JSON_FLAT_RELOCATE(self->array, delta);
+#define GENCODECS_LIST(_type)                                                 \
+    static GENCODECS_PUB_LIST(_type)
+#define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
+        {                                                                     \
+            int i;                                                            \
+            for (i = 0; i < self->size; ++i)                                  \
+                _type##_flat_relocate(self->array + i, delta);                \
+        }
+#define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
+        {                                                                     \
+            int i;                                                            \
+            for (i = 0; i < self->size; ++i)                                  \
+                if (self->array[i])                                           \
+                    GENCODECS_JSON_FLAT_RELOCATE(self->array[i], delta);      \
+        }
+#define GENCODECS_LIST_END                                                    \
+    }
+
+#include "gencodecs-gen.PRE.h"
+
+/* second pass, the block is taken in full by the arena decoder */
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    long _type##_from_jsmnf_flat(jsmnf_pair *root, const char *js,            \
+                                 struct _type **p_self)                       \
+    {                                                                         \
+        const size_t size = _type##_flat_size(root, js);                      \
+        struct ccord_arena arena;                                             \
+        struct _type *self;                                                   \
+        long ret;                                                             \
+        if (NULL == (self = malloc(size))) return JSMN_ERROR_NOMEM;           \
+        cog_arena_init_fixed(&arena, self, size);                             \
+        cog_arena_alloc(&arena, sizeof *self);                                \
+        ret = _type##_from_jsmnf_arena(root, js, self, &arena);               \
+        if (ret < 0) {                                                        \
+            free(self);                                                       \
+            return ret;                                                       \
+        }                                                                     \
+        *p_self = self;                                                       \
+        return (long)size;                                                    \
+    }
+#define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#endif /* GENCODECS_HEADER */
+#endif /* GENCODECS_JSON_DECODER */
+
+#undef GENCODECS_JSON_FLAT_SIZE_PTR_char
+#undef GENCODECS_JSON_FLAT_RELOCATE
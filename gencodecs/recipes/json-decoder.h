@@ -1,24 +1,59 @@
+/* decoders walk the object's fields once, matching each key against the
+ *      ones known at codegen time rather than looking every field up */
+#define GENCODECS_JSON_DECODER_KEY(_f, _js, _key)                             \
+    ((_f)->k.len == sizeof(_key) - 1                                          \
+     && 0 == memcmp(_js + (_f)->k.pos, _key, sizeof(_key) - 1))
+
+/* memory is taken from `arena` if given, otherwise from calloc() */
+#define GENCODECS_JSON_DECODER_ALLOC(_size)                                   \
+    (arena ? cog_arena_alloc(arena, _size) : calloc(1, _size))
+#define GENCODECS_JSON_DECODER_ARRAY_INIT(_type)                              \
+    if (arena) {                                                              \
+        self->realsize = root->size;                                          \
+        self->size = 0;                                                       \
+        self->array = cog_arena_alloc(arena, sizeof(_type) * root->size);     \
+        if (NULL == self->array) return JSMN_ERROR_NOMEM;                     \
+    }                                                                         \
+    else {                                                                    \
+        __carray_init(self, root->size, _type, , );                           \
+    }
+/* a duplicated key is decoded again and the last one wins (as with
+ *      jsmnf_find()), so release the value taken by the previous one, arena
+ *      memory goes away with the arena */
+#define GENCODECS_JSON_DECODER_RELEASE(_var, _cleanup)                        \
+    if (_var && !arena) {                                                     \
+        _cleanup;                                                             \
+        free(_var);                                                           \
+    }
+/* a field is decoded if there's no mask, or if its mask member is set */
+#define GENCODECS_JSON_DECODER_WANTS(_member) (!mask || mask->_member)
+
 #define GENCODECS_JSON_DECODER_int(_f, _js, _var, _type)                      \
-    if (_f && _f->type == JSMN_PRIMITIVE)                                     \
-        _var = (int)strtol(_js + _f->v.pos, NULL, 10)
+    if (_f && _f->type == JSMN_PRIMITIVE) {                                   \
+        int64_t _i64 = 0;                                                     \
+        cog_strtoi64(_js + _f->v.pos, _f->v.len, &_i64);                      \
+        _var = (int)_i64;                                                     \
+    }
 #define GENCODECS_JSON_DECODER_bool(_f, _js, _var, _type)                     \
     if (_f && _f->type == JSMN_PRIMITIVE)                                     \
         _var = ('t' == _js[_f->v.pos])
 #define GENCODECS_JSON_DECODER_PTR_char(_f, _js, _var, _type)                 \
     if (_f && _f->type == JSMN_STRING) {                                      \
         long _ret;                                                            \
-        _var = calloc(1, _f->v.len + 1);                                      \
+        GENCODECS_JSON_DECODER_RELEASE(_var, (void)0);                        \
+        _var = GENCODECS_JSON_DECODER_ALLOC(_f->v.len + 1);                   \
         if (NULL == _var) return JSMN_ERROR_NOMEM;                            \
         _ret = jsmnf_unescape(_var, _f->v.len, _js + _f->v.pos, _f->v.len);   \
         if (_ret < 0) return _ret;                                            \
         ret += _ret;                                                          \
     }
-#define GENCODECS_JSON_DECODER_STRUCT_PTR(_f, _js, _var, _type)               \
+#define GENCODECS_JSON_DECODER_STRUCT_PTR(_f, _js, _var, _type, _mask)        \
     if (_f && (_f->type == JSMN_OBJECT || _f->type == JSMN_ARRAY)) {          \
         long _ret;                                                            \
-        _var = calloc(1, sizeof *_var);                                       \
+        GENCODECS_JSON_DECODER_RELEASE(_var, _type##_cleanup(_var));          \
+        _var = GENCODECS_JSON_DECODER_ALLOC(sizeof *_var);                    \
         if (NULL == _var) return JSMN_ERROR_NOMEM;                            \
-        _ret = _type##_from_jsmnf(_f, _js, _var);                             \
+        _ret = _type##_from_jsmnf_masked(_f, _js, _var, _mask, arena);        \
         if (_ret < 0) return _ret;                                            \
         ret += sizeof *_var + _ret;                                           \
     }
@@ -26,11 +61,58 @@
 #ifdef GENCODECS_JSON_DECODER
 #ifdef GENCODECS_HEADER
 
+/* field masks, a member for each field of the type */
+#define GENCODECS_STRUCT(_type)                                               \
+    struct _type##_mask {
+#define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
+                               _encoder, _decoder, _default_value)            \
+        bool _name;
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+        const struct _type##_mask *_name;
+#define GENCODECS_FIELD_PRINTF(_name, _type, _printf_type, _scanf_type)       \
+        bool _name;
+#define GENCODECS_STRUCT_END                                                  \
+    };
+
+#define GENCODECS_LIST(_type)                                                 \
+    struct _type##_mask {
+#define GENCODECS_LISTTYPE(_type)                                             \
+        bool array;
+#define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
+        const struct _type##_mask *array;
+#define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
+        bool array;
+#define GENCODECS_LIST_END                                                    \
+    };
+
+#define GENCODECS_PUB_STRUCT(_type) GENCODECS_STRUCT(_type)
+#define GENCODECS_PUB_LIST(_type) GENCODECS_LIST(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#define GENCODECS_STRUCT(_type)                                               \
+    extern const struct _type##_mask _type##_mask_all;
+#define GENCODECS_LIST(_type) GENCODECS_STRUCT(_type)
+#define GENCODECS_PUB_STRUCT(_type) GENCODECS_STRUCT(_type)
+#define GENCODECS_PUB_LIST(_type) GENCODECS_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
 #define GENCODECS_PUB_STRUCT(_type)                                           \
+    long _type##_from_jsmnf_masked(jsmnf_pair *root, const char *js,          \
+                                   struct _type *self,                        \
+                                   const struct _type##_mask *mask,           \
+                                   struct ccord_arena *arena);                \
     long _type##_from_jsmnf(jsmnf_pair *root, const char *js,                 \
                             struct _type *self);                              \
+    long _type##_from_jsmnf_arena(jsmnf_pair *root, const char *js,           \
+                                  struct _type *self,                         \
+                                  struct ccord_arena *arena);                 \
     size_t _type##_from_json(const char buf[], size_t size,                   \
-                             struct _type *self);
+                             struct _type *self);                             \
+    size_t _type##_from_json_masked(const char buf[], size_t size,            \
+                                    struct _type *self,                       \
+                                    const struct _type##_mask *mask);
 #define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
 
 #include "gencodecs-gen.PRE.h"
@@ -38,44 +120,96 @@
 #elif defined(GENCODECS_FORWARD)
 
 #define GENCODECS_STRUCT(_type)                                               \
-    static long _type##_from_jsmnf(jsmnf_pair *root, const char *js,          \
-                                   struct _type *self);
+    static long _type##_from_jsmnf_masked(                                    \
+        jsmnf_pair *root, const char *js, struct _type *self,                 \
+        const struct _type##_mask *mask, struct ccord_arena *arena);
 #define GENCODECS_LIST(_type) GENCODECS_STRUCT(_type)
 
 #include "gencodecs-gen.PRE.h"
 
 #else
 
+/* every mask member set, nested masks included */
+#define GENCODECS_STRUCT(_type)                                               \
+    const struct _type##_mask _type##_mask_all = {
+#define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
+                               _encoder, _decoder, _default_value)            \
+        true,
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+        &_type##_mask_all,
+#define GENCODECS_FIELD_PRINTF(_name, _type, _printf_type, _scanf_type)       \
+        true,
+#define GENCODECS_STRUCT_END                                                  \
+    };
+#define GENCODECS_LIST(_type) GENCODECS_STRUCT(_type)
+#define GENCODECS_LISTTYPE(_type)                                             \
+        true
+#define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
+        &_type##_mask_all
+#define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
+        true
+#define GENCODECS_LIST_END GENCODECS_STRUCT_END
+#define GENCODECS_PUB_STRUCT(_type) GENCODECS_STRUCT(_type)
+#define GENCODECS_PUB_LIST(_type) GENCODECS_LIST(_type)
+
+#include "gencodecs-gen.PRE.h"
+
 #define GENCODECS_PUB_STRUCT(_type)                                           \
-    long _type##_from_jsmnf(jsmnf_pair *root, const char *js,                 \
-                            struct _type *self)                               \
+    long _type##_from_jsmnf_masked(jsmnf_pair *root, const char *js,          \
+                                   struct _type *self,                        \
+                                   const struct _type##_mask *mask,           \
+                                   struct ccord_arena *arena)                 \
     {                                                                         \
-        jsmnf_pair *f;                                                        \
-        long ret = 0;
+        long ret = 0;                                                         \
+        int i;                                                                \
+        for (i = 0; i < root->capacity; ++i) {                                \
+            jsmnf_pair *f = root->fields + i;                                 \
+            if (!f->k.len) continue;
 #define GENCODECS_STRUCT(_type)                                               \
     static GENCODECS_PUB_STRUCT(_type)
 #define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
                                _encoder, _decoder, _default_value)            \
-        f = jsmnf_find(root, js, _key, sizeof(_key) - 1);                     \
-        _decoder(f, js, self->_name, _type);
+            if (GENCODECS_JSON_DECODER_KEY(f, js, _key)) {                    \
+                if (GENCODECS_JSON_DECODER_WANTS(_name)) {                    \
+                    _decoder(f, js, self->_name, _type);                      \
+                }                                                             \
+                continue;                                                     \
+            }
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+            if (GENCODECS_JSON_DECODER_KEY(f, js, #_name)) {                  \
+                if (GENCODECS_JSON_DECODER_WANTS(_name)) {                    \
+                    GENCODECS_JSON_DECODER_STRUCT_PTR(                        \
+                        f, js, self->_name, _type,                            \
+                        mask ? mask->_name : NULL);                           \
+                }                                                             \
+                continue;                                                     \
+            }
 #define GENCODECS_FIELD_PRINTF(_name, _type, _printf_type, _scanf_type)       \
-        f = jsmnf_find(root, js, #_name, sizeof(#_name) - 1);                 \
-        if (f) sscanf(js + f->v.pos, _scanf_type, &self->_name);
+            if (GENCODECS_JSON_DECODER_KEY(f, js, #_name)) {                  \
+                if (GENCODECS_JSON_DECODER_WANTS(_name)) {                    \
+                    GENCODECS_JSON_DECODER_##_type(f, js, self->_name,        \
+                                                   _type);                    \
+                }                                                             \
+                continue;                                                     \
+            }
 #define GENCODECS_STRUCT_END                                                  \
+        }                                                                     \
         return ret;                                                           \
     }
 
 #define GENCODECS_PUB_LIST(_type)                                             \
-    long _type##_from_jsmnf(jsmnf_pair *root, const char *js,                 \
-                            struct _type *self)                               \
+    long _type##_from_jsmnf_masked(jsmnf_pair *root, const char *js,          \
+                                   struct _type *self,                        \
+                                   const struct _type##_mask *mask,           \
+                                   struct ccord_arena *arena)                 \
     {                                                                         \
         long ret = sizeof *self * root->size;                                 \
         int i;                                                                \
-        if (!ret) return 0;
+        if (!ret || !GENCODECS_JSON_DECODER_WANTS(array)) return 0;
 #define GENCODECS_LIST(_type)                                                 \
     static GENCODECS_PUB_LIST(_type)
 #define GENCODECS_LISTTYPE(_type)                                             \
-        __carray_init(self, root->size, _type, , );                           \
+        GENCODECS_JSON_DECODER_ARRAY_INIT(_type);                             \
         for (i = 0; i < root->size; ++i) {                                    \
             jsmnf_pair *f = root->fields + i;                                 \
             _type o;                                                          \
@@ -84,20 +218,21 @@
         }
 
 #define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
-        __carray_init(self, root->size, struct _type, , );                    \
+        GENCODECS_JSON_DECODER_ARRAY_INIT(struct _type);                      \
         for (i = 0; i < root->size; ++i) {                                    \
             jsmnf_pair *f = root->fields + i;                                 \
             struct _type o = { 0 };                                           \
-            long _ret = _type##_from_jsmnf(f, js, &o);                        \
+            long _ret = _type##_from_jsmnf_masked(                            \
+                f, js, &o, mask ? mask->array : NULL, arena);                 \
             if (_ret < 0) return _ret;                                        \
             ret += _ret;                                                      \
             carray_insert(self, i, o);                                        \
         }
 #define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
-        __carray_init(self, root->size, _type _decor, , );                    \
+        GENCODECS_JSON_DECODER_ARRAY_INIT(_type _decor);                      \
         for (i = 0; i < root->size; ++i) {                                    \
             jsmnf_pair *f = root->fields + i;                                 \
-            _type *o;                                                         \
+            _type *o = NULL;                                                  \
             GENCODECS_JSON_DECODER_PTR_##_type(f, js, o, _type);              \
             carray_insert(self, i, o);                                        \
         }
@@ -108,15 +243,27 @@
 #include "gencodecs-gen.PRE.h"
 
 #define GENCODECS_PUB_STRUCT(_type)                                           \
-    size_t _type##_from_json(const char buf[], size_t size,                   \
-                             struct _type *self)                              \
+    long _type##_from_jsmnf(jsmnf_pair *root, const char *js,                 \
+                            struct _type *self)                               \
+    {                                                                         \
+        return _type##_from_jsmnf_masked(root, js, self, NULL, NULL);         \
+    }                                                                         \
+    long _type##_from_jsmnf_arena(jsmnf_pair *root, const char *js,           \
+                                  struct _type *self,                         \
+                                  struct ccord_arena *arena)                  \
+    {                                                                         \
+        return _type##_from_jsmnf_masked(root, js, self, NULL, arena);        \
+    }                                                                         \
+    size_t _type##_from_json_masked(const char buf[], size_t size,            \
+                                    struct _type *self,                       \
+                                    const struct _type##_mask *mask)          \
     {                                                                         \
         size_t nbytes = 0;                                                    \
         jsmn_parser parser;                                                   \
         jsmntok_t *tokens = NULL;                                             \
         unsigned tmp = 0;                                                     \
         jsmn_init(&parser);                                                   \
-        if (0 < jsmn_parse_auto(&parser, buf, size, &tokens, &tmp)) {         \
+        if (0 < jsmn_parse_fast(&parser, buf, size, &tokens, &tmp)) {         \
             jsmnf_loader loader;                                              \
             jsmnf_pair *pairs = NULL;                                         \
             tmp = 0;                                                          \
@@ -124,13 +271,19 @@
             if (0 < jsmnf_load_auto(&loader, buf, tokens, parser.toknext,     \
                                     &pairs, &tmp)) {                          \
                 long ret;                                                     \
-                if (0 < (ret = _type##_from_jsmnf(pairs, buf, self)))         \
+                if (0 < (ret = _type##_from_jsmnf_masked(pairs, buf, self,    \
+                                                         mask, NULL)))        \
                     nbytes = ret;                                             \
                 free(pairs);                                                  \
             }                                                                 \
             free(tokens);                                                     \
         }                                                                     \
         return nbytes;                                                        \
+    }                                                                         \
+    size_t _type##_from_json(const char buf[], size_t size,                   \
+                             struct _type *self)                              \
+    {                                                                         \
+        return _type##_from_json_masked(buf, size, self, NULL);               \
     }
 #define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
 
@@ -0,0 +1,144 @@
+/* Read-only views over an already parsed JSON object: a view holds the
+ *      object's jsmnf_pair tree and fetches a field's value only when it is
+ *      requested, nothing is allocated or decoded ahead of time */
+
+#define GENCODECS_JSON_VIEW_GETTER(_type)                                     \
+    static _type _gc_view_##_type(jsmnf_pair *f, const char *js)              \
+    {                                                                         \
+        _type value = 0;                                                      \
+        GENCODECS_JSON_DECODER_##_type(f, js, value, _type);                  \
+        return value;                                                         \
+    }
+#define GENCODECS_JSON_VIEW_GETTER_PTR(_type, _jsmntype)                      \
+    static struct ccord_szbuf_readonly _gc_view_PTR_##_type(jsmnf_pair *f,    \
+                                                            const char *js)   \
+    {                                                                         \
+        struct ccord_szbuf_readonly value = { NULL, 0 };                      \
+        if (f && (!(_jsmntype) || f->type == (_jsmntype))) {                  \
+            value.start = js + f->v.pos;                                      \
+            value.size = (size_t)f->v.len;                                    \
+        }                                                                     \
+        return value;                                                         \
+    }
+
+#ifdef GENCODECS_JSON_DECODER
+#ifdef GENCODECS_HEADER
+
+#define GENCODECS_JSON_VIEW_MEMBER(_name, _ret)                               \
+        struct {                                                              \
+            const char *key;                                                  \
+            int len;                                                          \
+            _ret (*fn)(jsmnf_pair *f, const char *js);                        \
+        } _name;
+
+#define GENCODECS_JSON_VIEW_TYPE(_type)                                       \
+    struct _type##_view {                                                     \
+        const struct _type##_view_fields *get;                                \
+        jsmnf_pair *root;                                                     \
+        const char *js;                                                       \
+    };
+
+#define GENCODECS_STRUCT(_type)                                               \
+    GENCODECS_JSON_VIEW_TYPE(_type)                                           \
+    struct _type##_view_fields {
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    GENCODECS_JSON_VIEW_TYPE(_type)                                           \
+    extern const struct _type##_view_fields _type##_view_fields;              \
+    struct _type##_view _type##_view_of(jsmnf_pair *f, const char *js);       \
+    struct _type##_view_fields {
+#define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
+                               _encoder, _decoder, _default_value)            \
+        GENCODECS_JSON_VIEW_MEMBER(_name, _type)
+#define GENCODECS_FIELD_PRINTF(_name, _type, _printf_type, _scanf_type)       \
+        GENCODECS_JSON_VIEW_MEMBER(_name, _type)
+#define GENCODECS_FIELD_PTR(_name, _type, _decor)                             \
+        GENCODECS_JSON_VIEW_MEMBER(_name, struct ccord_szbuf_readonly)
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+        GENCODECS_JSON_VIEW_MEMBER(_name, struct _type##_view)
+#define GENCODECS_STRUCT_END                                                  \
+    };
+
+#define GENCODECS_LIST(_type) GENCODECS_STRUCT(_type)
+#define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
+#define GENCODECS_LISTTYPE(_type)                                             \
+        _type (*at)(jsmnf_pair *f, const char *js);
+#define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
+        struct _type##_view (*at)(jsmnf_pair *f, const char *js);
+#define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
+        struct ccord_szbuf_readonly (*at)(jsmnf_pair *f, const char *js);
+#define GENCODECS_LIST_END                                                    \
+    };
+
+#include "gencodecs-gen.PRE.h"
+
+#undef GENCODECS_JSON_VIEW_TYPE
+#undef GENCODECS_JSON_VIEW_MEMBER
+
+#elif defined(GENCODECS_FORWARD)
+
+GENCODECS_JSON_VIEW_GETTER(int)
+GENCODECS_JSON_VIEW_GETTER(bool)
+GENCODECS_JSON_VIEW_GETTER_PTR(char, JSMN_STRING)
+GENCODECS_JSON_VIEW_GETTER_PTR(json_char, JSMN_UNDEFINED)
+#ifdef GENCODECS_JSON_VIEW_GETTERS
+GENCODECS_JSON_VIEW_GETTERS(GENCODECS_JSON_VIEW_GETTER)
+#endif
+
+#define GENCODECS_STRUCT(_type)                                               \
+    static struct _type##_view _type##_view_of(jsmnf_pair *f,                 \
+                                               const char *js);
+#define GENCODECS_LIST(_type) GENCODECS_STRUCT(_type)
+
+#include "gencodecs-gen.PRE.h"
+
+#else
+
+#define GENCODECS_JSON_VIEW_OF(_type)                                         \
+    struct _type##_view _type##_view_of(jsmnf_pair *f, const char *js)        \
+    {                                                                         \
+        struct _type##_view view;                                             \
+        view.get = &_type##_view_fields;                                      \
+        view.root = f;                                                        \
+        view.js = js;                                                         \
+        return view;                                                          \
+    }
+
+#define GENCODECS_PUB_STRUCT(_type)                                           \
+    GENCODECS_JSON_VIEW_OF(_type)                                             \
+    const struct _type##_view_fields _type##_view_fields = {
+#define GENCODECS_STRUCT(_type)                                               \
+    static const struct _type##_view_fields _type##_view_fields;              \
+    static GENCODECS_JSON_VIEW_OF(_type)                                      \
+    static const struct _type##_view_fields _type##_view_fields = {
+#define GENCODECS_FIELD_CUSTOM(_name, _key, _type, _decor, _init, _cleanup,   \
+                               _encoder, _decoder, _default_value)            \
+        { _key, sizeof(_key) - 1, &_gc_view_##_type },
+#define GENCODECS_FIELD_PRINTF(_name, _type, _printf_type, _scanf_type)       \
+        { #_name, sizeof(#_name) - 1, &_gc_view_##_type },
+#define GENCODECS_FIELD_PTR(_name, _type, _decor)                             \
+        { #_name, sizeof(#_name) - 1, &_gc_view_PTR_##_type },
+#define GENCODECS_FIELD_STRUCT_PTR(_name, _type, _decor)                      \
+        { #_name, sizeof(#_name) - 1, &_type##_view_of },
+#define GENCODECS_STRUCT_END                                                  \
+    };
+
+#define GENCODECS_PUB_LIST(_type) GENCODECS_PUB_STRUCT(_type)
+#define GENCODECS_LIST(_type) GENCODECS_STRUCT(_type)
+#define GENCODECS_LISTTYPE(_type)                                             \
+        &_gc_view_##_type
+#define GENCODECS_LISTTYPE_STRUCT(_type)                                      \
+        &_type##_view_of
+#define GENCODECS_LISTTYPE_PTR(_type, _decor)                                 \
+        &_gc_view_PTR_##_type
+#define GENCODECS_LIST_END                                                    \
+    };
+
+#include "gencodecs-gen.PRE.h"
+
+#undef GENCODECS_JSON_VIEW_OF
+
+#endif /* GENCODECS_HEADER */
+#endif /* GENCODECS_JSON_DECODER */
+
+#undef GENCODECS_JSON_VIEW_GETTER
+#undef GENCODECS_JSON_VIEW_GETTER_PTR
@@ -142,7 +142,13 @@ typedef enum discord_event_scheduler {
      * handle this event in a worker thread
      * @deprecated functionality will be removed in the future
      */
-    DISCORD_EVENT_WORKER_THREAD
+    DISCORD_EVENT_WORKER_THREAD,
+    /**
+     * handle this event in the worker lane assigned to its guild or channel,
+     *      after every earlier event of the same lane
+     * @see discord_set_event_lanes()
+     */
+    DISCORD_EVENT_ORDERED_THREAD
 } discord_event_scheduler_t;
 
 /**
@@ -172,6 +178,74 @@ typedef enum discord_event_scheduler (*discord_ev_scheduler)(
 void discord_set_event_scheduler(struct discord *client,
                                  discord_ev_scheduler callback);
 
+/**
+ * @brief The id an event is keyed by for @ref DISCORD_EVENT_ORDERED_THREAD
+ * @see discord_set_event_lane_key()
+ */
+enum discord_event_lane_key {
+    /** key by the event's guild, or its channel if it has none (default) */
+    DISCORD_EVENT_LANE_GUILD,
+    /** key by the event's channel, or its guild if it has none */
+    DISCORD_EVENT_LANE_CHANNEL
+};
+
+/**
+ * @brief Start the ordered worker lanes for
+ *      @ref DISCORD_EVENT_ORDERED_THREAD
+ *
+ * Each lane is a queue served by a single thread: events of the same key are
+ *      handled one at a time in the order they were received, while events of
+ *      different keys may be handled in parallel by different lanes
+ * @note events without a guild or channel id go to the first lane
+ * @note if no lanes have been started, ordered events are handled in the main
+ *      thread
+ * @note the current lanes are joined, so this can't be called from within a
+ *      lane's callback (@ref CCORD_BAD_PARAMETER is returned)
+ * @param client the client created with discord_init()
+ * @param count amount of lanes, `0` stops the current ones
+ * @CCORD_return
+ */
+CCORDcode discord_set_event_lanes(struct discord *client, int count);
+
+/**
+ * @brief Set the id an event is keyed by for
+ *      @ref DISCORD_EVENT_ORDERED_THREAD
+ *
+ * @param client the client created with discord_init()
+ * @param event the event to be keyed
+ * @param key the event's key
+ * @CCORD_return
+ */
+CCORDcode discord_set_event_lane_key(struct discord *client,
+                                     enum discord_gateway_events event,
+                                     enum discord_event_lane_key key);
+
+/**
+ * @brief Limit the fields decoded for an event to the ones its callback needs
+ *
+ * Fields left out of the mask are skipped and remain zero-initialized
+ * @code{.c}
+ * // at file scope, so the nested mask outlives the client as well
+ * static const struct discord_message_mask mask = {
+ *     .id = true,
+ *     .channel_id = true,
+ *     .content = true,
+ *     .author = &(const struct discord_user_mask){ .id = true },
+ * };
+ * ...
+ * discord_set_event_mask(client, DISCORD_EV_MESSAGE_CREATE, &mask);
+ * @endcode
+ * @param client the client created with discord_init()
+ * @param event the event to be masked
+ * @param mask the event's `struct <type>_mask`, must outlive the client;
+ *      `NULL` decodes every field (default)
+ * @note ignored while the cache is enabled for the event
+ * @CCORD_return
+ */
+CCORDcode discord_set_event_mask(struct discord *client,
+                                 enum discord_gateway_events event,
+                                 const void *mask);
+
 /**
  * @brief Subscribe to Discord Events
  *
@@ -1021,4 +1095,230 @@ void discord_set_on_webhooks_update(
 
 /** @} DiscordEvents */
 
+/** @defgroup DiscordEventViews Event views
+ * @ingroup DiscordClient
+ * @brief Read-only views over the raw event payload
+ *
+ * A view callback receives the event's parsed JSON tree rather than its
+ *      decoded structure. Fields are fetched with DISCORD_VIEW_GET() only
+ *      when requested, so a callback that reads a couple of fields skips
+ *      the allocation and decoding of the entire event.
+ * @note A view is only valid for the callback's duration
+ * @note String fields are a slice of the raw payload, they are neither
+ *      NUL-terminated nor unescaped (see jsmnf_unescape())
+ *  @{ */
+
+/**
+ * @brief Fetch a view's field
+ *
+ * @param view the view, e.g. a `struct discord_message_view *`
+ * @param field the field's name, e.g. `channel_id`
+ * @return the field's value, or `0`, an empty string or an empty view if
+ *      missing from the payload
+ */
+#define DISCORD_VIEW_GET(view, field)                                         \
+    ((view)->get->field.fn(jsmnf_find((view)->root, (view)->js,               \
+                                      (view)->get->field.key,                 \
+                                      (view)->get->field.len),                \
+                           (view)->js))
+
+/**
+ * @brief Amount of elements in a list view
+ *
+ * @param view the list view, e.g. a `struct discord_embeds_view *`
+ * @return the list's length, `0` if missing from the payload
+ */
+#define DISCORD_VIEW_SIZE(view)                                               \
+    ((view)->root && (view)->root->type == JSMN_ARRAY ? (view)->root->size : 0)
+
+/**
+ * @brief Fetch a list view's element
+ *
+ * @param view the list view, e.g. a `struct discord_embeds_view *`
+ * @param index the element's index, must be less than DISCORD_VIEW_SIZE()
+ * @return the element's value, or an element view for lists of structures
+ */
+#define DISCORD_VIEW_AT(view, index)                                          \
+    ((view)->get->at((view)->root->fields + (index), (view)->js))
+
+/**
+ * @brief Triggers when a message is created, with a view over its payload
+ * @note This implicitly sets @ref DISCORD_GATEWAY_GUILD_MESSAGES and
+ *      @ref DISCORD_GATEWAY_DIRECT_MESSAGES intents
+ * @note Can be set alongside discord_set_on_message_create(), the view
+ *      callback will be triggered first
+ *
+ * @param client the client created with discord_init()
+ * @param callback the callback to be triggered on event
+ */
+void discord_set_on_message_create_view(
+    struct discord *client,
+    void (*callback)(struct discord *client,
+                     const struct discord_message_view *event));
+
+/**
+ * @brief Triggers when a message is updated, with a view over its payload
+ * @note This implicitly sets @ref DISCORD_GATEWAY_GUILD_MESSAGES and
+ *      @ref DISCORD_GATEWAY_DIRECT_MESSAGES intents
+ *
+ * @param client the client created with discord_init()
+ * @param callback the callback to be triggered on event
+ */
+void discord_set_on_message_update_view(
+    struct discord *client,
+    void (*callback)(struct discord *client,
+                     const struct discord_message_view *event));
+
+/**
+ * @brief Triggers when user has triggered an interaction, with a view over
+ *      its payload
+ *
+ * @param client the client created with discord_init()
+ * @param callback the callback to be triggered on event
+ */
+void discord_set_on_interaction_create_view(
+    struct discord *client,
+    void (*callback)(struct discord *client,
+                     const struct discord_interaction_view *event));
+
+/**
+ * @brief Triggers when user presence is updated, with a view over its
+ *      payload
+ * @note This implicitly sets @ref DISCORD_GATEWAY_GUILD_PRESENCES intent
+ *
+ * @param client the client created with discord_init()
+ * @param callback the callback to be triggered on event
+ */
+void discord_set_on_presence_update_view(
+    struct discord *client,
+    void (*callback)(struct discord *client,
+                     const struct discord_presence_update_view *event));
+
+/** @} DiscordEventViews */
+
+/** @defgroup DiscordEventFilters Event filters
+ * @ingroup DiscordClient
+ * @brief Discard events before they're decoded
+ *
+ * Filters are evaluated over the event's raw payload as soon as it's read
+ *      from the Gateway. A rejected event is never decoded, refcounted or
+ *      scheduled, none of its callbacks (including message commands and the
+ *      cache) are triggered.
+ *  @{ */
+
+/**
+ * @brief Event filter predicate
+ *
+ * @param client the client created with discord_init()
+ * @param event the event being evaluated
+ * @param data the event's parsed payload (the `d` field)
+ * @param js the raw JSON payload `data` points to
+ * @param arg user arbitrary data assigned at discord_add_event_filter()
+ * @return `true` to keep the event, `false` to discard it
+ */
+typedef bool (*discord_ev_filter)(struct discord *client,
+                                  enum discord_gateway_events event,
+                                  const jsmnf_pair *data,
+                                  const char js[],
+                                  void *arg);
+
+/**
+ * @brief Assign a filter to an event
+ * @note Filters are evaluated in the order they were added, the event is
+ *      discarded at the first one that rejects it
+ *
+ * @param client the client created with discord_init()
+ * @param event the event to be filtered
+ * @param predicate the predicate to be evaluated
+ * @param arg user arbitrary data passed to `predicate`, must remain valid for
+ *      as long as the client is running
+ * @CCORD_return
+ */
+CCORDcode discord_add_event_filter(struct discord *client,
+                                   enum discord_gateway_events event,
+                                   discord_ev_filter predicate,
+                                   void *arg);
+
+/** @brief A hashtable of snowflakes, for the built-in filters */
+struct discord_id_set;
+
+/**
+ * @brief Create an empty set of ids
+ *
+ * @return the set, free it with discord_id_set_cleanup()
+ */
+struct discord_id_set *discord_id_set_init(void);
+
+/**
+ * @brief Free a set of ids
+ *
+ * @param set the set created with discord_id_set_init()
+ */
+void discord_id_set_cleanup(struct discord_id_set *set);
+
+/**
+ * @brief Add an id to the set
+ * @note The set shouldn't be modified while its filters are being evaluated
+ *
+ * @param set the set created with discord_id_set_init()
+ * @param id the id to be added
+ */
+void discord_id_set_add(struct discord_id_set *set, u64snowflake id);
+
+/**
+ * @brief Check if an id is in the set
+ *
+ * @param set the set created with discord_id_set_init()
+ * @param id the id to be searched for
+ * @return `true` if found
+ */
+bool discord_id_set_contains(const struct discord_id_set *set,
+                             u64snowflake id);
+
+/**
+ * @brief Built-in filter that only keeps events from guilds in the
+ *      @ref discord_id_set passed as `arg`
+ * @note Events that aren't guild-specific are kept
+ */
+bool discord_filter_guilds(struct discord *client,
+                           enum discord_gateway_events event,
+                           const jsmnf_pair *data,
+                           const char js[],
+                           void *arg);
+
+/**
+ * @brief Built-in filter that only keeps events from channels in the
+ *      @ref discord_id_set passed as `arg`
+ * @note Events that aren't channel-specific are kept
+ */
+bool discord_filter_channels(struct discord *client,
+                             enum discord_gateway_events event,
+                             const jsmnf_pair *data,
+                             const char js[],
+                             void *arg);
+
+/**
+ * @brief Built-in filter that only keeps events triggered by users in the
+ *      @ref discord_id_set passed as `arg`
+ * @note The user is read from `author.id`, `user.id` or `user_id`, events
+ *      that carry neither are kept
+ */
+bool discord_filter_users(struct discord *client,
+                          enum discord_gateway_events event,
+                          const jsmnf_pair *data,
+                          const char js[],
+                          void *arg);
+
+/**
+ * @brief Built-in filter that discards events whose `author.bot` is set
+ * @note `arg` is unused
+ */
+bool discord_filter_no_bots(struct discord *client,
+                            enum discord_gateway_events event,
+                            const jsmnf_pair *data,
+                            const char js[],
+                            void *arg);
+
+/** @} DiscordEventFilters */
+
 #endif /* DISCORD_EVENTS_H */
@@ -13,6 +13,9 @@ extern "C" {
 #endif /* __cplusplus */
 
 #include <pthread.h>
+#ifdef CCORD_ZLIB
+#include <zlib.h>
+#endif /* CCORD_ZLIB */
 
 #define JSONB_HEADER
 #include "json-build.h"
@@ -47,6 +50,14 @@ extern "C" {
 
 /** @brief Get client from its nested field */
 #define CLIENT(ptr, path) CONTAINEROF(ptr, struct discord, path)
+/**
+ * @brief Get the gateway handle of one of the client's shards
+ *
+ * @param[in] client the Discord client
+ * @param[in] index the shard's index, `0` being the client's first shard
+ */
+#define SHARD(client, index)                                                  \
+    ((index) ? &(client)->shards.extra[(index)-1] : &(client)->gw)
 
 /**
  * @brief log and return `code` if `expect` condition is false
@@ -79,6 +90,8 @@ extern "C" {
 #define DISCORD_ENDPT_LEN 512
 /** Route's unique key threshold length */
 #define DISCORD_ROUTE_LEN 256
+/** Request body's initial length, doubled until the encoded body fits */
+#define DISCORD_BODY_INITIAL_SIZE 1024
 
 /** @defgroup DiscordInternalTimer Timer API
  * @brief Callback scheduling API
@@ -397,6 +410,8 @@ struct discord_ret_dispatch {
      * perform on-spot. On success the response object will be written to
      * the address. */
     void *sync;
+    /** optional `struct <type>_mask` limiting the response's decoded fields */
+    const void *mask;
 };
 
 /** @brief Attributes of response datatype */
@@ -409,10 +424,26 @@ struct discord_ret_response {
     void (*init)(void *data);
     /** populate datatype with JSON values */
     size_t (*from_json)(const char *json, size_t len, void *data);
+    /** populate datatype with the JSON values set at a field mask */
+    size_t (*from_json_masked)(const char *json,
+                               size_t len,
+                               void *data,
+                               const void *mask);
     /** cleanup function for datatype */
     void (*cleanup)(void *data);
 };
 
+/** @brief Attributes of request's JSON body */
+struct discord_ret_body {
+    /** the parameters to be encoded */
+    const void *params;
+    /** encode parameters with a JSON builder */
+    jsonbcode (*to_jsonb)(jsonb *b,
+                          char buf[],
+                          size_t size,
+                          const void *params);
+};
+
 /**
  * @brief Macro containing @ref discord_attributes fields
  * @note this exists for @ref discord_request alignment purposes
@@ -422,6 +453,8 @@ struct discord_ret_response {
     struct discord_ret_dispatch dispatch;                                     \
     /** information for parsing response into a datatype (if possible) */     \
     struct discord_ret_response response;                                     \
+    /** if set, encode body straight into the request's own buffer */        \
+    struct discord_ret_body body_params;                                      \
     /** if @ref HTTP_MIMEPOST provide attachments for file transfer */        \
     struct discord_attachments attachments;                                   \
     /** indicated reason to why the action was taken @note when used at       \
@@ -500,6 +533,25 @@ struct discord_requestor {
         /** finished queue lock */
         pthread_mutex_t finished;
     } * qlocks;
+
+    /**
+     * HTTP/2 multiplexing settings and transfer counters
+     * @note malloc'd so they're shared with clients cloned by discord_clone()
+     */
+    struct {
+        /** `true` if requests should be multiplexed over HTTP/2 */
+        bool enabled;
+        /** max amount of connections to Discord, `0` for no limit */
+        long max_connections;
+        /** `true` if the settings above have yet to reach `mhandle` */
+        bool dirty;
+        /** `CURLOPT_HTTP_VERSION` for new transfers (`REST` thread only) */
+        long version;
+        /** counters updated as transfers complete */
+        struct discord_rest_stats stats;
+        /** lock for the fields above */
+        pthread_mutex_t lock;
+    } * http2;
 };
 
 /**
@@ -522,6 +574,20 @@ void discord_requestor_init(struct discord_requestor *rqtor,
  */
 void discord_requestor_cleanup(struct discord_requestor *rqtor);
 
+/**
+ * @brief Multiplex requests over HTTP/2
+ * @note takes effect from the next batch of requests started by the `REST`
+ *      thread
+ *
+ * @param rqtor the handle initialized with discord_requestor_init()
+ * @param enable `true` to multiplex requests, `false` for libcurl's defaults
+ * @param max_connections max amount of connections to Discord, `0` for no
+ *      limit
+ */
+void discord_requestor_set_http2(struct discord_requestor *rqtor,
+                                 bool enable,
+                                 long max_connections);
+
 /**
  * @brief Check for and start pending bucket's requests
  *
@@ -554,6 +620,16 @@ void discord_requestor_dispatch_responses(struct discord_requestor *rqtor);
 void discord_request_cancel(struct discord_requestor *rqtor,
                             struct discord_request *req);
 
+/**
+ * @brief Encode a request's JSON body, its buffer grows until the body fits
+ *
+ * @param body the buffer to be written to, kept and reused between requests
+ * @param params the parameters to be encoded and their encoder
+ * @return the body's length, `0` if it couldn't be encoded
+ */
+size_t discord_request_body_encode(struct ccord_szbuf_reusable *body,
+                                   const struct discord_ret_body *params);
+
 /**
  * @brief Begin a new request
  *
@@ -561,7 +637,7 @@ void discord_request_cancel(struct discord_requestor *rqtor,
  * @param rqtor the requestor handle initialized with discord_requestor_init()
  * @param req the request containing preliminary information for its dispatch
  * and response's parsing
- * @param body the request's body
+ * @param body the request's body, ignored if `attr->body_params` is set
  * @param method the request's HTTP method
  * @param endpoint the request's endpoint
  * @param key the request bucket's group for ratelimiting
@@ -675,10 +751,8 @@ struct discord_gateway_session {
     char resume_url[256];
     /** session limits */
     struct discord_session_start_limit start_limit;
-    /** active concurrent sessions */
-    int concurrent;
-    /** event counter to avoid reaching limit of 120 events per 60 sec */
-    int event_count;
+    /** whether the session is waiting on the identify queue */
+    bool identify_queued;
     /** @ref DiscordInternalGatewaySessionStatus */
     unsigned status;
 
@@ -715,24 +789,79 @@ struct discord_gateway_payload {
     enum discord_gateway_opcodes opcode;
     /** field 's' */
     int seq;
-    /** field 't' */
-    char name[32];
+    /** field 't' (empty if not a recognized event) */
+    const char *name;
     /** field 't' enumerator value */
     enum discord_gateway_events event;
     /** field 'd' */
     jsmnf_pair *data;
 };
 
+/** @brief A Gateway command waiting for the send rate limit */
+struct discord_gateway_command {
+    /** the command's opcode */
+    enum discord_gateway_opcodes opcode;
+    /** the command's name for logging */
+    const char *name;
+    /** entry for @ref discord_gateway_outbound queue */
+    QUEUE entry;
+    /** the encoded command length */
+    size_t size;
+    /** the encoded command */
+    char text[];
+};
+
+/**
+ * @brief The handle for rate limiting commands sent to the Gateway
+ *
+ * Discord disconnects a client that sends more than 120 commands in 60
+ *      seconds. Heartbeats, identifies and resumes are always sent and draw
+ *      from a reserved part of that budget, every other command is queued
+ *      once the rest of the budget runs out, and sent when the window resets
+ */
+struct discord_gateway_outbound {
+    /** commands that can still be sent in the current window */
+    int remaining;
+    /** when the current window resets */
+    u64unix_ms reset_at;
+    /** @ref discord_gateway_command queue */
+    QUEUE(struct discord_gateway_command) queue;
+    /** the queued presence update, replaced by newer ones */
+    struct discord_gateway_command *presence;
+    /** timer id for draining `queue` */
+    unsigned timer;
+    /** synchronize commands sent from worker threads */
+    pthread_mutex_t lock;
+};
+
 /** A generic event callback for casting */
 typedef void (*discord_ev_event)(struct discord *client, const void *event);
 /** An event callback for @ref DISCORD_EV_MESSAGE_CREATE */
 typedef void (*discord_ev_message)(struct discord *client,
                                    const struct discord_message *event);
 
+#ifdef CCORD_ZLIB
+/** @brief The handle for inflating `zlib-stream` compressed payloads */
+struct discord_gateway_zlib {
+    /** the streaming inflate context, shared by the entire connection */
+    z_stream stream;
+    /** compressed frames accumulated until a `Z_SYNC_FLUSH` suffix */
+    struct ccord_szbuf_reusable in;
+    /** reusable buffer for the inflated payload */
+    struct ccord_szbuf_reusable out;
+    /** inflate counters */
+    struct discord_zlib_stats stats;
+    /** stats rwlock */
+    pthread_rwlock_t rwlock;
+};
+#endif /* CCORD_ZLIB */
+
 /** @brief The handle used for interfacing with Discord's Gateway API */
 struct discord_gateway {
     /** `DISCORD_GATEWAY` logging module */
     struct logconf conf;
+    /** the client this gateway shard belongs to */
+    struct discord *client;
     /** the websockets handle that connects to Discord */
     struct websockets *ws;
     /** curl_multi handle for non-blocking transfer over websockets */
@@ -761,11 +890,6 @@ struct discord_gateway {
          * @note updated at discord_gateway_send_identify()
          */
         u64unix_ms identify_last;
-        /**
-         * timestamp of last succesful event
-         * @note resets every 60s
-         */
-        u64unix_ms event;
         /** timer id for heartbeat timer */
         unsigned hbeat_timer;
 
@@ -783,18 +907,39 @@ struct discord_gateway {
 
     /** on-going session structure */
     struct discord_gateway_session *session;
+    /** outbound commands rate limiting */
+    struct discord_gateway_outbound *outbound;
 
     /** response-payload structure */
     struct discord_gateway_payload payload;
     /**
      * the user's callbacks for Discord events
      * @note index 0 for cache callbacks, index 1 for user callbacks
+     * @note only the client's first shard (`client->gw`) tables are filled,
+     *      every shard dispatches its events through them
      * @todo should be cast to the original callback signature before calling,
      *      otherwise its UB
      */
     discord_ev_event cbs[2][DISCORD_EV_MAX];
+    /**
+     * the user's view callbacks for Discord events, triggered before the
+     *      event is decoded
+     * @see discord_gateway_dispatch()
+     */
+    discord_ev_event views[DISCORD_EV_MAX];
+    /**
+     * the user's field masks for Discord events, a `struct <type>_mask`
+     *      limiting the fields decoded for the event's callback
+     * @see discord_set_event_mask()
+     */
+    const void *masks[DISCORD_EV_MAX];
     /** the event scheduler callback */
     discord_ev_scheduler scheduler;
+
+#ifdef CCORD_ZLIB
+    /** `zlib-stream` inflate context, reset at every new connection */
+    struct discord_gateway_zlib *zlib;
+#endif /* CCORD_ZLIB */
 };
 
 /**
@@ -802,10 +947,12 @@ struct discord_gateway {
  *
  * Structure used for interfacing with the Discord's Gateway API
  * @param gw the gateway handle to be initialized
+ * @param client the client the gateway shard belongs to
  * @param conf pointer to @ref discord logging module
  * @param token the bot token
  */
 void discord_gateway_init(struct discord_gateway *gw,
+                          struct discord *client,
                           struct logconf *conf,
                           const char token[]);
 
@@ -816,13 +963,50 @@ void discord_gateway_init(struct discord_gateway *gw,
  */
 void discord_gateway_cleanup(struct discord_gateway *gw);
 
+/**
+ * @brief Assign a shard to the Gateway handle
+ *
+ * @param gw the handle initialized with discord_gateway_init()
+ * @param shard_id the shard's id
+ * @param total_shards the total amount of shards
+ */
+void discord_gateway_set_shard(struct discord_gateway *gw,
+                               int shard_id,
+                               int total_shards);
+
+/**
+ * @brief Get the client's shard responsible for a guild
+ * @note fallbacks to the client's first shard if the guild isn't handled by
+ *      this client
+ *
+ * @param client the client created with discord_init()
+ * @param guild_id the guild's id
+ * @return the shard's gateway handle
+ */
+struct discord_gateway *discord_gateway_get_shard(struct discord *client,
+                                                  u64snowflake guild_id);
+
 /**
  * @brief Initialize handle with the new session primitives
  *
  * @param gw the handle initialized with discord_gateway_init()
+ * @param peer a shard started before this one, whose Gateway Bot
+ *      information is reused rather than fetched again, or `NULL` to fetch
+ *      it
  * @CCORD_return
  */
-CCORDcode discord_gateway_start(struct discord_gateway *gw);
+CCORDcode discord_gateway_start(struct discord_gateway *gw,
+                                const struct discord_gateway *peer);
+
+/**
+ * @brief Asynchronously restart a shard whose connection is over
+ *
+ * Doesn't block the event loop: the Gateway Bot information is fetched as a
+ *      regular REST request, failures are retried with a backoff until
+ *      `retry.limit` is reached, at which point the shard stops running
+ * @param gw the handle initialized with discord_gateway_init()
+ */
+void discord_gateway_restart(struct discord_gateway *gw);
 
 /**
  * @brief Cleanup and reset `gw` session primitives
@@ -857,6 +1041,66 @@ void discord_gateway_shutdown(struct discord_gateway *gw);
  */
 void discord_gateway_reconnect(struct discord_gateway *gw, bool resume);
 
+/**
+ * @brief Handle a recorded Gateway payload as if it had just been received
+ * @see discord_replay_traffic()
+ *
+ * Only `DISPATCH` payloads are handled, and the shard's session state is left
+ *      untouched
+ * @param gw the handle initialized with discord_gateway_init()
+ * @param text the payload, must be kept alive until the next one is replayed
+ * @param len the payload length
+ * @return `false` if the payload couldn't be parsed
+ */
+bool discord_gateway_replay(struct discord_gateway *gw,
+                            const char text[],
+                            size_t len);
+
+/**
+ * @brief Encode the shard's resumable session state
+ * @see discord_set_session_file()
+ *
+ * @param gw the handle initialized with discord_gateway_init()
+ * @param b the JSON builder
+ * @param buf the JSON buffer
+ * @param bufsize the JSON buffer size
+ * @return a negative @ref jsonbcode if @p buf is too small, otherwise the
+ *      session is encoded if it's resumable
+ */
+jsonbcode discord_gateway_session_save(struct discord_gateway *gw,
+                                       jsonb *b,
+                                       char buf[],
+                                       size_t bufsize);
+
+/**
+ * @brief Restore the shard's session state, so that its next connection
+ *      attempts to resume it
+ * @see discord_set_session_file()
+ *
+ * @param gw the handle initialized with discord_gateway_init()
+ * @param f the session's JSON object encoded by
+ *      discord_gateway_session_save()
+ * @param js the JSON text
+ */
+void discord_gateway_session_load(struct discord_gateway *gw,
+                                  jsmnf_pair *f,
+                                  const char js[]);
+
+/**
+ * @brief Restore the shards' sessions from the client's session file
+ * @note sessions saved too long ago are ignored
+ *
+ * @param client the client created with discord_init()
+ */
+void discord_session_file_load(struct discord *client);
+
+/**
+ * @brief Save the shards' resumable sessions to the client's session file
+ *
+ * @param client the client created with discord_init()
+ */
+void discord_session_file_save(struct discord *client);
+
 /**
  * @brief Trigger the initial handshake with the gateway
  *
@@ -866,6 +1110,15 @@ void discord_gateway_reconnect(struct discord_gateway *gw, bool resume);
 void discord_gateway_send_identify(struct discord_gateway *gw,
                                    struct discord_identify *event);
 
+/**
+ * @brief Queue the gateway for an `IDENTIFY`
+ *
+ * Identifies are grouped into `shard_id % max_concurrency` rate limit
+ *      buckets, each bucket being released once every 5 seconds
+ * @param gw the handle initialized with discord_gateway_init()
+ */
+void discord_gateway_queue_identify(struct discord_gateway *gw);
+
 /**
  * @brief Replay missed events when a disconnected client resumes
  *
@@ -911,12 +1164,79 @@ void discord_gateway_send_update_voice_state(
 void discord_gateway_send_presence_update(
     struct discord_gateway *gw, struct discord_presence_update *event);
 
+/**
+ * @brief Get the event enumerator matching a Gateway event name
+ *
+ * @param name the event name (field 't'), not required to be NUL-terminated
+ * @param len the event name length
+ * @return the matching event, or @ref DISCORD_EV_NONE if there's no match
+ */
+enum discord_gateway_events discord_gateway_event_eval(const char name[],
+                                                       size_t len);
+
 /**
  * @brief Dispatch user callback matched to event
  *
  * @param gw the handle initialized with discord_gateway_init()
+ * @param payload the event payload, either `gw->payload` or one parsed from
+ *      a @ref discord_gateway_event
+ */
+void discord_gateway_dispatch(struct discord_gateway *gw,
+                              struct discord_gateway_payload *payload);
+
+/**
+ * @brief A Gateway event handed to a worker thread
+ *
+ * Holds a single copy of the event's `d` field, so that the worker doesn't
+ *      depend on the shard's payload buffers (which get overwritten by the
+ *      next event). Its lifetime is managed by the client's
+ *      @ref discord_refcounter
+ */
+struct discord_gateway_event {
+    /** the shard that received the event */
+    struct discord_gateway *gw;
+    /** the id of the shard that received the event */
+    int shard_id;
+    /** field 't' */
+    const char *name;
+    /** field 't' enumerator value */
+    enum discord_gateway_events event;
+    /** entry for a @ref discord_event_lane queue */
+    QUEUE entry;
+    /** field 'd' length */
+    size_t size;
+    /** field 'd' raw JSON, NUL-terminated */
+    char json[];
+};
+
+/**
+ * @brief Copy the shard's current event into a new
+ *      @ref discord_gateway_event
+ * @note The event is referenced once, release it with
+ *      discord_refcounter_decr()
+ *
+ * @param gw the handle initialized with discord_gateway_init()
+ * @return the event
  */
-void discord_gateway_dispatch(struct discord_gateway *gw);
+struct discord_gateway_event *discord_gateway_event_init(
+    struct discord_gateway *gw);
+
+/**
+ * @brief Parse and dispatch a @ref discord_gateway_event, then release its
+ *      reference
+ *
+ * @param event the event created with discord_gateway_event_init()
+ */
+void discord_gateway_event_dispatch(struct discord_gateway_event *event);
+
+/**
+ * @brief Get the id of the shard whose @ref discord_gateway_event is being
+ *      dispatched by the calling thread
+ *
+ * @return the shard id, or `-1` if the calling thread isn't dispatching a
+ *      @ref discord_gateway_event
+ */
+int discord_gateway_event_shard_id(void);
 
 /** @} DiscordInternalGateway */
 
@@ -1147,6 +1467,219 @@ bool discord_message_commands_try_perform(
 
 /** @} DiscordInternalMessageCommands */
 
+/** @defgroup DiscordInternalEventFilters Event Filters API
+ * @brief The Event Filters API for discarding events before they're decoded
+ *  @{ */
+
+/** @brief The filters assigned to a single event */
+struct discord_event_filters_list {
+    /**
+     * filter entries
+     * @note datatype declared at discord-eventfilters.c
+     */
+    struct _discord_event_filter *array;
+    /** amount of filters assigned */
+    int size;
+    /** filters cap before increase */
+    int realsize;
+};
+
+/**
+ * @brief The handle for storing user's event filters
+ * @see discord_add_event_filter()
+ */
+struct discord_event_filters {
+    /** `DISCORD_EVENT_FILTERS` logging module */
+    struct logconf conf;
+    /** the filters assigned to each event */
+    struct discord_event_filters_list events[DISCORD_EV_MAX];
+};
+
+/**
+ * @brief Initialize an Event Filters handle
+ *
+ * @param filters the event filters handle to be initialized
+ * @param conf pointer to @ref discord logging module
+ */
+void discord_event_filters_init(struct discord_event_filters *filters,
+                                struct logconf *conf);
+
+/**
+ * @brief Free an Event Filters handle
+ *
+ * @param filters the handle initialized with discord_event_filters_init()
+ */
+void discord_event_filters_cleanup(struct discord_event_filters *filters);
+
+/**
+ * @brief Assign a new filter to an event
+ *
+ * @param filters the handle initialized with discord_event_filters_init()
+ * @param event the event to be filtered
+ * @param predicate the predicate to be evaluated
+ * @param data user arbitrary data passed to `predicate`
+ */
+void discord_event_filters_append(struct discord_event_filters *filters,
+                                  enum discord_gateway_events event,
+                                  discord_ev_filter predicate,
+                                  void *data);
+
+/**
+ * @brief Evaluate the current payload against its event filters
+ *
+ * @param filters the handle initialized with discord_event_filters_init()
+ * @param payload the event payload to read from
+ * @return `true` if every filter accepts the event, `false` if it should be
+ *      discarded
+ */
+bool discord_event_filters_pass(struct discord_event_filters *filters,
+                                struct discord_gateway_payload *payload);
+
+/** @} DiscordInternalEventFilters */
+
+/** @defgroup DiscordInternalEventLanes Event Lanes API
+ * @brief The Event Lanes API for handling events of the same key in order
+ *  @{ */
+
+/** @brief A single-consumer queue of events served by its own thread */
+struct discord_event_lane {
+    /** the lanes this lane belongs to */
+    struct discord_event_lanes *lanes;
+    /** the lane's thread */
+    pthread_t tid;
+    /** synchronize `queue` and `shutdown` */
+    pthread_mutex_t lock;
+    /** notify of a new event or shutdown */
+    pthread_cond_t cond;
+    /** pending @ref discord_gateway_event queue */
+    QUEUE(struct discord_gateway_event) queue;
+    /** if true the thread exits once `queue` is empty */
+    bool shutdown;
+};
+
+/**
+ * @brief The handle for ordered worker lanes
+ * @see discord_set_event_lanes()
+ */
+struct discord_event_lanes {
+    /** `DISCORD_EVENT_LANES` logging module */
+    struct logconf conf;
+    /** the lanes */
+    struct discord_event_lane *array;
+    /** amount of lanes */
+    int size;
+    /** lock for `array` and `size` */
+    pthread_mutex_t lock;
+    /** the id each event is keyed by */
+    enum discord_event_lane_key keys[DISCORD_EV_MAX];
+};
+
+/**
+ * @brief Initialize an Event Lanes handle
+ * @note no lanes are started until discord_event_lanes_start() is called
+ *
+ * @param lanes the event lanes handle to be initialized
+ * @param conf pointer to @ref discord logging module
+ */
+void discord_event_lanes_init(struct discord_event_lanes *lanes,
+                              struct logconf *conf);
+
+/**
+ * @brief Stop the lanes after their pending events are handled, and free the
+ *      Event Lanes handle
+ *
+ * @param lanes the handle initialized with discord_event_lanes_init()
+ */
+void discord_event_lanes_cleanup(struct discord_event_lanes *lanes);
+
+/**
+ * @brief Check if the calling thread is one of the lanes
+ *
+ * @param lanes the handle initialized with discord_event_lanes_init()
+ * @return `true` if called from within a lane
+ */
+bool discord_event_lanes_is_lane(struct discord_event_lanes *lanes);
+
+/**
+ * @brief Replace the current lanes with `count` new ones
+ * @note fails with @ref CCORD_BAD_PARAMETER if called from within a lane,
+ *      which would have to join itself
+ *
+ * @param lanes the handle initialized with discord_event_lanes_init()
+ * @param count amount of lanes, `0` stops the current ones
+ * @CCORD_return
+ */
+CCORDcode discord_event_lanes_start(struct discord_event_lanes *lanes,
+                                    int count);
+
+/**
+ * @brief Get the lane an event belongs to
+ *
+ * @param lanes the handle initialized with discord_event_lanes_init()
+ * @param payload the event payload to read the key from
+ * @return the lane index, or `-1` if no lanes have been started
+ */
+int discord_event_lanes_get(struct discord_event_lanes *lanes,
+                            struct discord_gateway_payload *payload);
+
+/**
+ * @brief Queue the shard's current event to its lane
+ *
+ * @param lanes the handle initialized with discord_event_lanes_init()
+ * @param gw the shard that received the event
+ * @return CCORD_UNAVAILABLE if no lanes have been started
+ */
+CCORDcode discord_event_lanes_add(struct discord_event_lanes *lanes,
+                                  struct discord_gateway *gw);
+
+/** @} DiscordInternalEventLanes */
+
+/** @defgroup DiscordInternalRecorder Traffic Recorder API
+ * @brief The Traffic Recorder API for saving received Gateway payloads
+ *  @{ */
+
+/**
+ * @brief The handle for recording received Gateway payloads
+ * @see discord_set_traffic_recorder()
+ */
+struct discord_recorder {
+    /** `DISCORD_RECORDER` logging module */
+    struct logconf conf;
+    /** the recording file, `NULL` if not recording */
+    FILE *fp;
+};
+
+/**
+ * @brief Initialize a Traffic Recorder handle
+ *
+ * @param recorder the traffic recorder handle to be initialized
+ * @param conf pointer to @ref discord logging module
+ */
+void discord_recorder_init(struct discord_recorder *recorder,
+                           struct logconf *conf);
+
+/**
+ * @brief Close the recording file, and free the Traffic Recorder handle
+ *
+ * @param recorder the handle initialized with discord_recorder_init()
+ */
+void discord_recorder_cleanup(struct discord_recorder *recorder);
+
+/**
+ * @brief Append a received payload to the recording file
+ *
+ * @param recorder the handle initialized with discord_recorder_init()
+ * @param shard_id the shard that received the payload
+ * @param text the payload
+ * @param len the payload length
+ */
+void discord_recorder_append(struct discord_recorder *recorder,
+                             int shard_id,
+                             const char text[],
+                             size_t len);
+
+/** @} DiscordInternalRecorder */
+
 /** @defgroup DiscordInternalCache Cache API
  * @brief The Cache API for storage and retrieval of Discord data
  *  @{ */
@@ -1185,11 +1718,19 @@ struct discord {
     bool is_original;
     /** the bot token */
     char *token;
+    /** the file sessions are saved to @see discord_set_session_file() */
+    char *session_file;
     /** the io poller for listening to file descriptors */
     struct io_poller *io_poller;
 
     /** the user's message commands @see discord_set_on_command() */
     struct discord_message_commands commands;
+    /** the user's event filters @see discord_add_event_filter() */
+    struct discord_event_filters filters;
+    /** the ordered worker lanes @see discord_set_event_lanes() */
+    struct discord_event_lanes lanes;
+    /** the traffic recorder @see discord_set_traffic_recorder() */
+    struct discord_recorder recorder;
     /** user's data reference counter for automatic cleanup */
     struct discord_refcounter refcounter;
 
@@ -1197,6 +1738,34 @@ struct discord {
     struct discord_rest rest;
     /** the handle for interfacing with Discord's Gateway API */
     struct discord_gateway gw;
+    /** the shards handled by this client @see discord_set_shards() */
+    struct {
+        /** the id of the first shard (the one at `gw`) */
+        int first;
+        /** amount of shards handled by this client */
+        int count;
+        /** total amount of shards across all clients */
+        int total;
+        /** amount of shards that are still running (or retrying) */
+        int running;
+        /** why the last shard to stop has given up */
+        CCORDcode code;
+        /** the shard that triggered the event being dispatched */
+        int current;
+        /** identify scheduling shared by all shards */
+        struct {
+            /** `session_start_limit` fields tracked locally */
+            struct discord_session_start_limit limit;
+            /** timestamp of when `limit.remaining` resets */
+            u64unix_ms reset_at;
+            /** last identify timestamp of each rate limit bucket */
+            u64unix_ms *buckets;
+            /** timer id for releasing queued identifies */
+            unsigned timer;
+        } identify;
+        /** the remaining `count - 1` shards */
+        struct discord_gateway *extra;
+    } shards;
     /** the client's user structure */
     struct discord_user self;
     /** the handle for registering and retrieving Discord data */
@@ -15,6 +15,11 @@ typedef void (*cast_done_typed)(struct discord *,
 typedef void (*cast_init)(void *);
 typedef void (*cast_cleanup)(void *);
 typedef size_t (*cast_from_json)(const char *, size_t, void *);
+typedef size_t (*cast_from_json_masked)(const char *,
+                                        size_t,
+                                        void *,
+                                        const void *);
+typedef jsonbcode (*cast_to_jsonb)(jsonb *, char[], size_t, const void *);
 
 /* helper typedef for getting sizeof of `struct discord_ret` common fields */
 typedef struct {
@@ -27,6 +32,7 @@ typedef struct {
         (dest).has_type = true;                                               \
         (dest).done.typed = (cast_done_typed)(src).done;                      \
         (dest).sync = (src).sync;                                             \
+        (dest).mask = (src).mask;                                             \
     } while (0)
 
 #define _RET_COPY_TYPELESS(dest, src)                                         \
@@ -50,6 +56,8 @@ typedef struct {
         (attr).response.size = sizeof(struct type);                           \
         (attr).response.init = (cast_init)type##_init;                        \
         (attr).response.from_json = (cast_from_json)type##_from_json;         \
+        (attr).response.from_json_masked =                                    \
+            (cast_from_json_masked)type##_from_json_masked;                   \
         (attr).response.cleanup = (cast_cleanup)type##_cleanup;               \
         (attr).reason = _reason;                                              \
         if (ret) _RET_COPY_TYPED(attr.dispatch, *ret);                        \
@@ -67,6 +75,8 @@ typedef struct {
     do {                                                                      \
         (attr).response.size = sizeof(struct type);                           \
         (attr).response.from_json = (cast_from_json)type##_from_json;         \
+        (attr).response.from_json_masked =                                    \
+            (cast_from_json_masked)type##_from_json_masked;                   \
         (attr).response.cleanup = (cast_cleanup)type##_cleanup;               \
         (attr).reason = _reason;                                              \
         if (ret) _RET_COPY_TYPED(attr.dispatch, *ret);                        \
@@ -86,6 +96,21 @@ typedef struct {
         if (ret) _RET_COPY_TYPELESS(attr.dispatch, *ret);                     \
     } while (0)
 
+/**
+ * @brief Helper for encoding a specs-generated struct as the request's body
+ *
+ * The body is encoded straight into the request's reusable buffer, which
+ *      grows as needed
+ * @param[out] attr @ref discord_attributes handler to be initialized
+ * @param[in] type datatype of the struct
+ * @param[in] _params the struct to be encoded
+ */
+#define DISCORD_ATTR_BODY_INIT(attr, type, _params)                           \
+    do {                                                                      \
+        (attr).body_params.params = _params;                                  \
+        (attr).body_params.to_jsonb = (cast_to_jsonb)type##_to_jsonb;         \
+    } while (0)
+
 /**
  * @brief Helper for initializing attachments ids
  *
@@ -53,6 +53,9 @@ struct discord_response {
            On success the response object will be written to the address,     \
            unless enabled with @ref DISCORD_SYNC_FLAG */                      \
         struct discord_##_type *sync;                                         \
+        /** optional fields to be decoded from the response, the ones left    \
+           out remain zero-initialized. Must outlive the request */           \
+        const struct discord_##_type##_mask *mask;                            \
     }
 
 /** @brief Request's return context */
@@ -32,7 +32,12 @@ extern "C" {
 #endif
 
 #define DISCORD_API_BASE_URL       "https://discord.com/api/v" DISCORD_VERSION
+#ifdef CCORD_ZLIB
+#define DISCORD_GATEWAY_URL_SUFFIX                                            \
+    "?v=" DISCORD_VERSION "&encoding=json&compress=zlib-stream"
+#else
 #define DISCORD_GATEWAY_URL_SUFFIX "?v=" DISCORD_VERSION "&encoding=json"
+#endif /* CCORD_ZLIB */
 
 /* forward declaration */
 struct discord;
@@ -298,12 +303,178 @@ void *discord_get_data(struct discord *client);
  * @brief Get the client WebSockets ping
  * @note Only works after a connection has been established via
  * discord_run()
+ * @note when sharding, this is the ping of the client's first shard
  *
  * @param client the client created with discord_init()
  * @return the ping in milliseconds
  */
 int discord_get_ping(struct discord *client);
 
+/**
+ * @brief Run multiple Gateway shards from a single client
+ * @note must be called before discord_run() and discord_cache_enable()
+ * @see https://discord.com/developers/docs/topics/gateway#sharding
+ *
+ * The shards share the client's REST handle, reference counter and cache,
+ *      while each keep their own session and heartbeat
+ * @param client the client created with discord_init()
+ * @param first the id of the first shard handled by this client
+ * @param count amount of shards handled by this client, starting at `first`
+ * @param total total amount of shards across all processes
+ * @CCORD_return
+ */
+CCORDcode discord_set_shards(struct discord *client,
+                             int first,
+                             int count,
+                             int total);
+
+/**
+ * @brief Get the id of the shard that triggered the current event
+ * @note meant to be called from within an event callback, including the ones
+ *      ran by worker threads or event lanes
+ *
+ * @param client the client created with discord_init()
+ * @return the shard id
+ */
+int discord_get_shard_id(struct discord *client);
+
+/**
+ * @brief Get a shard's WebSockets ping
+ * @see discord_get_ping()
+ *
+ * @param client the client created with discord_init()
+ * @param shard_id the shard's id
+ * @return the ping in milliseconds, or `-1` if the shard isn't handled by
+ *      this client
+ */
+int discord_get_shard_ping(struct discord *client, int shard_id);
+
+/**
+ * @brief Keep the Gateway sessions resumable across process restarts
+ * @note may also be set with the config file's `discord.session_file` field
+ *
+ * discord_run() resumes the sessions saved to `filename` if they're recent
+ *      enough, skipping the initial `READY` and `GUILD_CREATE` events.
+ *      discord_shutdown() then keeps the sessions open on Discord's side, and
+ *      they are saved back to `filename` once discord_run() returns
+ * @warning the cache isn't saved, and is populated only by events received
+ *      after resuming
+ * @param client the client created with discord_init()
+ * @param filename the sessions file, `NULL` to disable
+ */
+void discord_set_session_file(struct discord *client, const char filename[]);
+
+/**
+ * @brief Record every payload received from the Gateway to a file
+ * @see discord_replay_traffic()
+ *
+ * Payloads are stored as they are received (after decompression), along with
+ *      their receive timestamp and shard id
+ * @param client the client created with discord_init()
+ * @param filename the recording file, overwritten if it already exists.
+ *      `NULL` to stop recording
+ * @CCORD_return
+ */
+CCORDcode discord_set_traffic_recorder(struct discord *client,
+                                       const char filename[]);
+
+/** @brief Statistics collected by discord_replay_traffic() */
+struct discord_replay_stats {
+    /** amount of payloads replayed */
+    size_t payloads;
+    /** amount of payload bytes replayed */
+    size_t bytes;
+    /** time spent replaying, in microseconds */
+    uint64_t elapsed_us;
+};
+
+/**
+ * @brief Replay a recording made with discord_set_traffic_recorder()
+ *
+ * Each `DISPATCH` payload goes through the client's event filters, scheduler,
+ *      cache and callbacks as if it had been received from the Gateway, but
+ *      no connection is made
+ * @note shards missing from the client replay through its first shard
+ * @note events scheduled to worker threads may still be running once this
+ *      returns
+ * @param client the client created with discord_init()
+ * @param filename the recording file
+ * @param paced if `true` payloads are replayed at their recorded pace,
+ *      otherwise as fast as possible
+ * @param stats (nullable) the replay statistics
+ * @CCORD_return
+ */
+CCORDcode discord_replay_traffic(struct discord *client,
+                                 const char filename[],
+                                 bool paced,
+                                 struct discord_replay_stats *stats);
+
+/**
+ * @brief Multiplex REST requests over HTTP/2
+ * @note may also be set with the config file's `discord.http2.enable` and
+ *      `discord.http2.max_connections` fields
+ *
+ * Requests are sent as streams of a few long-lived TLS connections, instead
+ *      of a connection each. New requests wait for a connection that is
+ *      still being established rather than opening another, and responses
+ *      may be compressed
+ * @param client the client created with discord_init()
+ * @param enable `true` to multiplex requests, `false` for libcurl's defaults
+ * @param max_connections max amount of connections to Discord, `0` for no
+ *      limit
+ */
+void discord_set_http2(struct discord *client,
+                       bool enable,
+                       long max_connections);
+
+/** @brief REST transfer counters */
+struct discord_rest_stats {
+    /** amount of requests performed, retries included */
+    uint64_t requests;
+    /** amount of connections opened to perform them */
+    uint64_t connections;
+    /** amount of requests performed as a stream of a HTTP/2 connection */
+    uint64_t streams;
+};
+
+/**
+ * @brief Get the REST transfer counters
+ * @note `streams / connections` is how many requests share a connection
+ *
+ * @param client the client created with discord_init()
+ * @param stats where the counters will be copied to
+ */
+void discord_get_rest_stats(struct discord *client,
+                            struct discord_rest_stats *stats);
+
+/** @brief Gateway `zlib-stream` transport compression counters */
+struct discord_zlib_stats {
+    /** amount of compressed payloads inflated */
+    uint64_t payloads;
+    /** total compressed bytes received over the wire */
+    uint64_t bytes_in;
+    /** total bytes after inflating */
+    uint64_t bytes_out;
+    /** total time spent inflating (in microseconds) */
+    uint64_t inflate_us;
+};
+
+/**
+ * @brief Get the Gateway's `zlib-stream` compression counters
+ * @note compression is only available if Concord has been built with
+ *      `-DCCORD_ZLIB`, in which case bots must also be linked with `-lz`
+ * @note the compression ratio can be obtained from `bytes_out / bytes_in`
+ * @note counters are summed across all of the client's shards
+ *
+ * @param client the client created with discord_init()
+ * @param stats where the counters will be copied to, zeroed if compression
+ *      is unavailable
+ * @CCORD_return
+ * @retval CCORD_UNAVAILABLE Concord has been built without `-DCCORD_ZLIB`
+ */
+CCORDcode discord_get_zlib_stats(struct discord *client,
+                                 struct discord_zlib_stats *stats);
+
 /**
  * @brief Get the current timestamp (in milliseconds)
  *
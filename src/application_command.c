@@ -31,8 +31,6 @@ discord_create_global_application_command(
     struct discord_ret_application_command *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
@@ -42,11 +40,10 @@ discord_create_global_application_command(
 
     DISCORD_ATTR_INIT(attr, discord_application_command, ret, NULL);
 
-    body.size = discord_create_global_application_command_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_global_application_command,
+                           params);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/applications/%" PRIu64 "/commands",
                             application_id);
 }
@@ -79,19 +76,16 @@ discord_edit_global_application_command(
     struct discord_ret_application_command *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, command_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_edit_global_application_command_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_edit_global_application_command,
+                           params);
 
     DISCORD_ATTR_INIT(attr, discord_application_command, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/applications/%" PRIu64 "/commands/%" PRIu64,
                             application_id, command_id);
 }
@@ -122,18 +116,15 @@ discord_bulk_overwrite_global_application_commands(
     struct discord_ret_application_commands *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[8192];
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_application_commands_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_application_commands, params);
 
     DISCORD_ATTR_LIST_INIT(attr, discord_application_commands, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PUT,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PUT,
                             "/applications/%" PRIu64 "/commands",
                             application_id);
 }
@@ -167,8 +158,6 @@ discord_create_guild_application_command(
     struct discord_ret_application_command *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
@@ -177,13 +166,12 @@ discord_create_guild_application_command(
     CCORD_EXPECT(client, NOT_EMPTY_STR(params->description),
                  CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_create_guild_application_command_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_guild_application_command,
+                           params);
 
     DISCORD_ATTR_INIT(attr, discord_application_command, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/applications/%" PRIu64 "/guilds/%" PRIu64
                             "/commands",
                             application_id, guild_id);
@@ -221,20 +209,17 @@ discord_edit_guild_application_command(
     struct discord_ret_application_command *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, command_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_edit_guild_application_command_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_edit_guild_application_command,
+                           params);
 
     DISCORD_ATTR_INIT(attr, discord_application_command, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/applications/%" PRIu64 "/guilds/%" PRIu64
                             "/commands/%" PRIu64,
                             application_id, guild_id, command_id);
@@ -270,20 +255,17 @@ discord_bulk_overwrite_guild_application_commands(
     struct discord_ret_application_commands *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[8192];
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_bulk_overwrite_guild_application_commands_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(
+        attr, discord_bulk_overwrite_guild_application_commands, params);
 
     DISCORD_ATTR_LIST_INIT(attr, discord_application_commands, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PUT,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PUT,
                             "/applications/%" PRIu64 "/guilds/%" PRIu64
                             "/commands",
                             application_id, guild_id);
@@ -342,20 +324,17 @@ discord_edit_application_command_permissions(
     struct discord_ret_application_command_permission *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[8192];
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, command_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_edit_application_command_permissions_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_edit_application_command_permissions,
+                           params);
 
     DISCORD_ATTR_INIT(attr, discord_application_command_permission, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PUT,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PUT,
                             "/applications/%" PRIu64 "/guilds/%" PRIu64
                             "/commands/%" PRIu64 "/permissions",
                             application_id, guild_id, command_id);
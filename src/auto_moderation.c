@@ -51,8 +51,6 @@ discord_create_auto_moderation_rule(
     struct discord_ret_auto_moderation_rule *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
@@ -63,11 +61,9 @@ discord_create_auto_moderation_rule(
 
     DISCORD_ATTR_INIT(attr, discord_auto_moderation_rule, ret, params->reason);
 
-    body.size =
-        discord_create_auto_moderation_rule_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_auto_moderation_rule, params);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/guilds/%" PRIu64 "/auto-moderation/rules",
                             guild_id);
 }
@@ -81,8 +77,6 @@ discord_modify_auto_moderation_rule(
     struct discord_ret_auto_moderation_rule *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, auto_moderation_rule_id != 0, CCORD_BAD_PARAMETER,
@@ -94,11 +88,9 @@ discord_modify_auto_moderation_rule(
 
     DISCORD_ATTR_INIT(attr, discord_auto_moderation_rule, ret, params->reason);
 
-    body.size =
-        discord_modify_auto_moderation_rule_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_auto_moderation_rule, params);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64
                             "/auto-moderation/rules/%" PRIu64,
                             guild_id, auto_moderation_rule_id);
@@ -118,18 +118,15 @@ discord_modify_channel(struct discord *client,
                        struct discord_ret_channel *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_channel_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_channel, params);
 
     DISCORD_ATTR_INIT(attr, discord_channel, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/channels/%" PRIu64, channel_id);
 }
 
@@ -221,9 +218,7 @@ discord_create_message(struct discord *client,
                        struct discord_ret_message *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
     enum http_method method;
-    char buf[16384]; /**< @todo dynamic buffer */
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
@@ -237,12 +232,11 @@ discord_create_message(struct discord *client,
         method = HTTP_POST;
     }
 
-    body.size = discord_create_message_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_message, params);
 
     DISCORD_ATTR_INIT(attr, discord_message, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, method,
+    return discord_rest_run(&client->rest, &attr, NULL, method,
                             "/channels/%" PRIu64 "/messages", channel_id);
 }
 
@@ -502,19 +496,16 @@ discord_edit_message(struct discord *client,
                      struct discord_ret_message *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[16384]; /**< @todo dynamic buffer */
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, message_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_edit_message_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_edit_message, params);
 
     DISCORD_ATTR_INIT(attr, discord_message, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/channels/%" PRIu64 "/messages/%" PRIu64,
                             channel_id, message_id);
 }
@@ -547,8 +538,6 @@ discord_bulk_delete_messages(struct discord *client,
 {
     const u64unix_ms now = discord_timestamp(client);
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096] = "";
 
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params->messages != NULL, CCORD_BAD_PARAMETER, "");
@@ -564,12 +553,11 @@ discord_bulk_delete_messages(struct discord *client,
                      "Messages should not be older than 2 weeks.");
     }
 
-    body.size = discord_bulk_delete_messages_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_bulk_delete_messages, params);
 
     DISCORD_ATTR_BLANK_INIT(attr, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/channels/%" PRIu64 "/messages/bulk-delete",
                             channel_id);
 }
@@ -583,20 +571,16 @@ discord_edit_channel_permissions(
     struct discord_ret *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, overwrite_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_edit_channel_permissions_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_edit_channel_permissions, params);
 
     DISCORD_ATTR_BLANK_INIT(attr, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PUT,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PUT,
                             "/channels/%" PRIu64 "/permissions/%" PRIu64,
                             channel_id, overwrite_id);
 }
@@ -623,19 +607,15 @@ discord_create_channel_invite(struct discord *client,
                               struct discord_ret_invite *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_create_channel_invite_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_channel_invite, params);
 
     DISCORD_ATTR_INIT(attr, discord_invite, ret,
                       params ? params->reason : NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/channels/%" PRIu64 "/invites", channel_id);
 }
 
@@ -666,20 +646,17 @@ discord_follow_news_channel(struct discord *client,
                             struct discord_ret_followed_channel *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[256]; /* should be more than enough for this */
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params->webhook_channel_id != 0, CCORD_BAD_PARAMETER,
                  "");
 
-    body.size = discord_follow_news_channel_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_follow_news_channel, params);
 
     DISCORD_ATTR_INIT(attr, discord_channel, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/channels/%" PRIu64 "/followers", channel_id);
 }
 
@@ -759,20 +736,16 @@ discord_group_dm_add_recipient(struct discord *client,
                                struct discord_ret *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, user_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_group_dm_add_recipient_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_group_dm_add_recipient, params);
 
     DISCORD_ATTR_BLANK_INIT(attr, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PUT,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PUT,
                             "/channels/%" PRIu64 "/recipients/%" PRIu64,
                             channel_id, user_id);
 }
@@ -804,20 +777,16 @@ discord_start_thread_with_message(
     struct discord_ret_channel *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, message_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_start_thread_with_message_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_start_thread_with_message, params);
 
     DISCORD_ATTR_INIT(attr, discord_channel, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/channels/%" PRIu64 "/messages/%" PRIu64
                             "/threads",
                             channel_id, message_id);
@@ -831,19 +800,15 @@ discord_start_thread_without_message(
     struct discord_ret_channel *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_start_thread_without_message_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_start_thread_without_message, params);
 
     DISCORD_ATTR_INIT(attr, discord_channel, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/channels/%" PRIu64 "/threads", channel_id);
 }
 
@@ -115,15 +115,12 @@ _on_shard_disconnected(struct discord *client,
 
 #define GUILD_BEGIN(guild)                                                    \
     struct discord_guild *guild = calloc(1, sizeof *guild);                   \
-    memcpy(guild, ev, sizeof *guild);                                         \
-    guild->channels = NULL;                                                   \
-    guild->members = NULL;                                                    \
-    guild->roles = NULL;                                                      \
     do {                                                                      \
-        char buf[0x40000];                                                    \
-        const size_t size = discord_guild_to_json(buf, sizeof buf, guild);    \
-        memset(guild, 0, sizeof *guild);                                      \
-        discord_guild_from_json(buf, size, guild);                            \
+        struct discord_guild shallow = *ev;                                   \
+        shallow.channels = NULL;                                              \
+        shallow.members = NULL;                                               \
+        shallow.roles = NULL;                                                 \
+        ASSERT_S(discord_guild_copy(guild, &shallow), "Out of memory");       \
         discord_refcounter_add_internal(                                      \
             &client->refcounter, guild,                                       \
             (void (*)(void *))discord_guild_cleanup, true);                   \
@@ -263,7 +260,7 @@ discord_cache_enable(struct discord *client,
         client->cache.cleanup = _discord_cache_cleanup;
         data = client->cache.data = calloc(1, sizeof *data);
 
-        size_t nshards = (size_t)(data->total_shards = 1);
+        size_t nshards = (size_t)(data->total_shards = client->shards.total);
         data->caches = calloc(nshards, sizeof *data->caches);
         for (int i = 0; i < data->total_shards; i++) {
             struct _discord_shard_cache *cache = &data->caches[i];
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
 
 #include "discord.h"
 #include "discord-internal.h"
@@ -66,9 +67,13 @@ _discord_init(struct discord *new_client)
 
     discord_refcounter_init(&new_client->refcounter, &new_client->conf);
     discord_message_commands_init(&new_client->commands, &new_client->conf);
+    discord_event_filters_init(&new_client->filters, &new_client->conf);
+    discord_event_lanes_init(&new_client->lanes, &new_client->conf);
+    discord_recorder_init(&new_client->recorder, &new_client->conf);
     discord_rest_init(&new_client->rest, &new_client->conf, new_client->token);
-    discord_gateway_init(&new_client->gw, &new_client->conf,
+    discord_gateway_init(&new_client->gw, new_client, &new_client->conf,
                          new_client->token);
+    new_client->shards.count = new_client->shards.total = 1;
 #ifdef CCORD_VOICE
     discord_voice_connections_init(new_client);
 #endif
@@ -162,6 +167,51 @@ discord_config_init(const char config_file[])
         }
     }
 
+    /* check for a session file in config file */
+    field = discord_config_get_field(
+        new_client, (char *[2]){ "discord", "session_file" }, 2);
+    if (field.size) {
+        char filename[4096];
+
+        snprintf(filename, sizeof(filename), "%.*s", (int)field.size,
+                 field.start);
+        discord_set_session_file(new_client, filename);
+    }
+
+    /* check for HTTP/2 multiplexing in config file */
+    field = discord_config_get_field(new_client,
+                                     (char *[2]){ "discord", "http2" }, 2);
+    if (field.size) {
+        jsmn_parser parser;
+        jsmntok_t tokens[16];
+
+        jsmn_init(&parser);
+        if (0 < jsmn_parse(&parser, field.start, field.size, tokens,
+                           sizeof(tokens) / sizeof *tokens))
+        {
+            jsmnf_loader loader;
+            jsmnf_pair pairs[16];
+
+            jsmnf_init(&loader);
+            if (0 < jsmnf_load(&loader, field.start, tokens, parser.toknext,
+                               pairs, sizeof(pairs) / sizeof *pairs))
+            {
+                long max_connections = 0;
+                jsmnf_pair *f;
+
+                if ((f = jsmnf_find(pairs, field.start, "enable", 6))
+                    && 't' == field.start[f->v.pos])
+                {
+                    if ((f = jsmnf_find(pairs, field.start, "max_connections",
+                                        15)))
+                        max_connections =
+                            strtol(field.start + f->v.pos, NULL, 10);
+                    discord_set_http2(new_client, true, max_connections);
+                }
+            }
+        }
+    }
+
     return new_client;
 }
 
@@ -189,6 +239,7 @@ discord_clone(const struct discord *orig)
     memcpy(clone, orig, sizeof(struct discord));
     clone->is_original = false;
 
+    clone->gw.client = clone;
     _discord_clone_gateway(&clone->gw, &orig->gw);
 
     return clone;
@@ -215,9 +266,16 @@ discord_cleanup(struct discord *client)
     }
     else {
         discord_worker_join(client);
+        discord_event_lanes_cleanup(&client->lanes);
+        discord_recorder_cleanup(&client->recorder);
         discord_rest_cleanup(&client->rest);
         discord_gateway_cleanup(&client->gw);
+        for (int i = 1; i < client->shards.count; ++i)
+            discord_gateway_cleanup(SHARD(client, i));
+        free(client->shards.extra);
+        free(client->shards.identify.buckets);
         discord_message_commands_cleanup(&client->commands);
+        discord_event_filters_cleanup(&client->filters);
 #ifdef CCORD_VOICE
         discord_voice_connections_cleanup(client);
 #endif
@@ -229,6 +287,7 @@ discord_cleanup(struct discord *client)
         io_poller_destroy(client->io_poller);
         logconf_cleanup(&client->conf);
         if (client->token) free(client->token);
+        if (client->session_file) free(client->session_file);
         pthread_mutex_destroy(&client->workers->lock);
         pthread_cond_destroy(&client->workers->cond);
         free(client->workers);
@@ -317,6 +376,256 @@ discord_get_ping(struct discord *client)
     return ping_ms;
 }
 
+CCORDcode
+discord_set_shards(struct discord *client, int first, int count, int total)
+{
+    if (total < 1 || count < 1 || first < 0 || first + count > total) {
+        logconf_error(&client->conf,
+                      "Invalid shards range (first: %d, count: %d, total: %d)",
+                      first, count, total);
+        return CCORD_BAD_PARAMETER;
+    }
+    if (client->shards.running) {
+        logconf_error(&client->conf, "Can't set shards to a running client.");
+        return CCORD_BAD_PARAMETER;
+    }
+    if (client->cache.data) {
+        logconf_error(&client->conf, "Shards must be set before enabling "
+                                     "the cache with discord_cache_enable()");
+        return CCORD_BAD_PARAMETER;
+    }
+
+    for (int i = 1; i < client->shards.count; ++i)
+        discord_gateway_cleanup(SHARD(client, i));
+    free(client->shards.extra);
+    client->shards.extra = NULL;
+
+    client->shards.first = client->shards.current = first;
+    client->shards.count = count;
+    client->shards.total = total;
+    if (count > 1)
+        client->shards.extra =
+            calloc((size_t)count - 1, sizeof *client->shards.extra);
+
+    for (int i = 0; i < count; ++i) {
+        struct discord_gateway *gw = SHARD(client, i);
+
+        if (i) discord_gateway_init(gw, client, &client->conf, client->token);
+        discord_gateway_set_shard(gw, first + i, total);
+    }
+    return CCORD_OK;
+}
+
+int
+discord_get_shard_id(struct discord *client)
+{
+    /* worker threads can't rely on what the main thread is dispatching */
+    const int shard_id = discord_gateway_event_shard_id();
+
+    return shard_id != -1 ? shard_id : client->shards.current;
+}
+
+int
+discord_get_shard_ping(struct discord *client, int shard_id)
+{
+    const int index = shard_id - client->shards.first;
+    struct discord_gateway *gw;
+    int ping_ms;
+
+    if (index < 0 || index >= client->shards.count) return -1;
+
+    gw = SHARD(client, index);
+    pthread_rwlock_rdlock(&gw->timer->rwlock);
+    ping_ms = gw->timer->ping_ms;
+    pthread_rwlock_unlock(&gw->timer->rwlock);
+
+    return ping_ms;
+}
+
+void
+discord_set_session_file(struct discord *client, const char filename[])
+{
+    if (client->session_file) free(client->session_file);
+    client->session_file = NULL;
+    if (filename && *filename)
+        cog_strndup(filename, strlen(filename), &client->session_file);
+}
+
+/* sessions are kept by Discord for a short while after disconnecting */
+#define SESSION_FILE_MAX_AGE_MS 60000
+
+void
+discord_session_file_load(struct discord *client)
+{
+    jsmnf_pair *pairs = NULL, *sessions, *f;
+    jsmntok_t *tokens = NULL;
+    unsigned ntokens = 0, npairs = 0;
+    jsmnf_loader loader;
+    jsmn_parser parser;
+    size_t size = 0;
+    char *js = NULL;
+    FILE *fp;
+
+    if (!(fp = fopen(client->session_file, "rb"))) return;
+
+    js = cog_load_whole_file_fp(fp, &size);
+    fclose(fp);
+
+    jsmn_init(&parser);
+    if (!js || jsmn_parse_auto(&parser, js, size, &tokens, &ntokens) <= 0)
+        goto _cleanup;
+    jsmnf_init(&loader);
+    if (jsmnf_load_auto(&loader, js, tokens, parser.toknext, &pairs, &npairs)
+        <= 0)
+        goto _cleanup;
+
+    if (!(f = jsmnf_find(pairs, js, "saved_at", 8))
+        || discord_timestamp(client)
+               > strtoull(js + f->v.pos, NULL, 10) + SESSION_FILE_MAX_AGE_MS)
+    {
+        logconf_info(&client->conf, "Sessions at '%s' are too old to resume",
+                     client->session_file);
+        goto _cleanup;
+    }
+
+    if ((sessions = jsmnf_find(pairs, js, "sessions", 8))) {
+        for (int i = 0; i < sessions->size; ++i) {
+            const int index =
+                (f = jsmnf_find(sessions->fields + i, js, "shard", 5))
+                    ? (int)strtol(js + f->v.pos, NULL, 10)
+                          - client->shards.first
+                    : -1;
+
+            if (index >= 0 && index < client->shards.count)
+                discord_gateway_session_load(SHARD(client, index),
+                                             sessions->fields + i, js);
+        }
+    }
+
+_cleanup:
+    free(pairs);
+    free(tokens);
+    free(js);
+}
+
+static jsonbcode
+_discord_session_file_encode(struct discord *client,
+                             jsonb *b,
+                             char buf[],
+                             size_t bufsize)
+{
+    jsonbcode code;
+
+    jsonb_init(b);
+    if (0 > (code = jsonb_object(b, buf, bufsize))) return code;
+    if (0 > (code = jsonb_key(b, buf, bufsize, "saved_at", 8))) return code;
+    if (0 > (code = jsonb_number(b, buf, bufsize,
+                                 (double)discord_timestamp(client))))
+        return code;
+    if (0 > (code = jsonb_key(b, buf, bufsize, "sessions", 8))) return code;
+    if (0 > (code = jsonb_array(b, buf, bufsize))) return code;
+    for (int i = 0; i < client->shards.count; ++i)
+        if (0 > (code = discord_gateway_session_save(SHARD(client, i), b, buf,
+                                                     bufsize)))
+            return code;
+    if (0 > (code = jsonb_array_pop(b, buf, bufsize))) return code;
+    return jsonb_object_pop(b, buf, bufsize);
+}
+
+/* the sessions are written to a temporary file that then replaces the
+ *      original, so a crash mid-write can't leave a truncated file behind */
+void
+discord_session_file_save(struct discord *client)
+{
+    size_t bufsize = 64 + (size_t)client->shards.count * 512;
+    char *buf = malloc(bufsize), *tmppath = NULL;
+    jsonbcode code;
+    FILE *fp;
+    jsonb b;
+
+    ASSERT_S(buf != NULL, "Out of memory");
+    while (JSONB_ERROR_NOMEM
+           == (code = _discord_session_file_encode(client, &b, buf, bufsize)))
+    {
+        void *tmp = realloc(buf, 2 * bufsize);
+        ASSERT_S(tmp != NULL, "Out of memory");
+
+        buf = tmp;
+        bufsize *= 2;
+    }
+    if (code < 0) {
+        logconf_error(&client->conf, "Couldn't encode sessions for '%s'",
+                      client->session_file);
+        goto _cleanup;
+    }
+
+    cog_asprintf(&tmppath, "%s.tmp", client->session_file);
+    if (!(fp = fopen(tmppath, "wb"))) {
+        logconf_error(&client->conf, "Couldn't open '%s': %s", tmppath,
+                      strerror(errno));
+        goto _cleanup;
+    }
+    if (fwrite(buf, 1, b.pos, fp) != b.pos || fflush(fp) != 0
+        || fsync(fileno(fp)) != 0)
+    {
+        logconf_error(&client->conf, "Couldn't write '%s': %s", tmppath,
+                      strerror(errno));
+        fclose(fp);
+        remove(tmppath);
+        goto _cleanup;
+    }
+    if (fclose(fp) != 0 || rename(tmppath, client->session_file) != 0) {
+        logconf_error(&client->conf, "Couldn't replace '%s': %s",
+                      client->session_file, strerror(errno));
+        remove(tmppath);
+    }
+
+_cleanup:
+    free(tmppath);
+    free(buf);
+}
+
+void
+discord_set_http2(struct discord *client, bool enable, long max_connections)
+{
+    discord_requestor_set_http2(&client->rest.requestor, enable,
+                                max_connections);
+}
+
+void
+discord_get_rest_stats(struct discord *client,
+                       struct discord_rest_stats *stats)
+{
+    struct discord_requestor *rqtor = &client->rest.requestor;
+
+    pthread_mutex_lock(&rqtor->http2->lock);
+    *stats = rqtor->http2->stats;
+    pthread_mutex_unlock(&rqtor->http2->lock);
+}
+
+CCORDcode
+discord_get_zlib_stats(struct discord *client,
+                       struct discord_zlib_stats *stats)
+{
+    memset(stats, 0, sizeof *stats);
+#ifdef CCORD_ZLIB
+    for (int i = 0; i < client->shards.count; ++i) {
+        struct discord_gateway_zlib *zlib = SHARD(client, i)->zlib;
+
+        pthread_rwlock_rdlock(&zlib->rwlock);
+        stats->payloads += zlib->stats.payloads;
+        stats->bytes_in += zlib->stats.bytes_in;
+        stats->bytes_out += zlib->stats.bytes_out;
+        stats->inflate_us += zlib->stats.inflate_us;
+        pthread_rwlock_unlock(&zlib->rwlock);
+    }
+    return CCORD_OK;
+#else
+    (void)client;
+    return CCORD_UNAVAILABLE;
+#endif /* CCORD_ZLIB */
+}
+
 uint64_t
 discord_timestamp(struct discord *client)
 {
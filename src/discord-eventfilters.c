@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#define CHASH_KEY_FIELD     id
+#define CHASH_BUCKETS_FIELD entries
+#include "chash.h"
+
+/* spread the snowflake's timestamp and sequence bits */
+#define _id_hash(key, hash) (long)(((key) ^ ((key) >> 22)) & 0x7fffffff)
+
+/* chash heap-mode (auto-increase hashtable) */
+#define IDS_TABLE_HEAP                   1
+#define IDS_TABLE_BUCKET                 struct _discord_id_set_entry
+#define IDS_TABLE_FREE_KEY(_key)
+#define IDS_TABLE_HASH(_key, _hash)      _id_hash(_key, _hash)
+#define IDS_TABLE_FREE_VALUE(_value)
+#define IDS_TABLE_COMPARE(_cmp_a, _cmp_b) ((_cmp_a) == (_cmp_b))
+#define IDS_TABLE_INIT(entry, _key, _value)                                   \
+    chash_default_init(entry, _key, _value)
+
+struct _discord_id_set_entry {
+    /** the snowflake id */
+    u64snowflake id;
+    /** unused */
+    int value;
+    /** the entry state in the hashtable (see chash.h 'State enums') */
+    int state;
+};
+
+struct discord_id_set {
+    /** amount of ids stored */
+    int length;
+    /** ids cap before increase */
+    int capacity;
+    /** id entries */
+    struct _discord_id_set_entry *entries;
+};
+
+struct discord_id_set *
+discord_id_set_init(void)
+{
+    struct discord_id_set *set = malloc(sizeof *set);
+
+    __chash_init(set, IDS_TABLE);
+
+    return set;
+}
+
+void
+discord_id_set_cleanup(struct discord_id_set *set)
+{
+    __chash_free(set, IDS_TABLE);
+    free(set);
+}
+
+void
+discord_id_set_add(struct discord_id_set *set, u64snowflake id)
+{
+    chash_assign(set, id, 0, IDS_TABLE);
+}
+
+bool
+discord_id_set_contains(const struct discord_id_set *set, u64snowflake id)
+{
+    int ret;
+
+    ret = chash_contains(set, id, ret, IDS_TABLE);
+
+    return ret != 0;
+}
+
+/** @brief Where to look for an id in the event payload */
+struct _discord_filter_key {
+    /** the key path */
+    char *path[2];
+    /** the key path depth */
+    unsigned depth;
+};
+
+/* return true if the event doesn't carry any of `keys`, otherwise whether
+ *      the first match is in `set` */
+static bool
+_discord_filter_ids(const jsmnf_pair *data,
+                    const char js[],
+                    const struct _discord_filter_key keys[],
+                    size_t nkeys,
+                    const struct discord_id_set *set)
+{
+    for (size_t i = 0; i < nkeys; ++i) {
+        const jsmnf_pair *f =
+            jsmnf_find_path(data, js, keys[i].path, keys[i].depth);
+
+        if (f && f->type == JSMN_STRING)
+            return discord_id_set_contains(
+                set, (u64snowflake)strtoull(js + f->v.pos, NULL, 10));
+    }
+    return true;
+}
+
+#define FILTER(keys)                                                          \
+    _discord_filter_ids(data, js, keys, sizeof(keys) / sizeof *keys, set)
+
+static const struct _discord_filter_key ID_KEY[] = { { { "id" }, 1 } };
+
+bool
+discord_filter_guilds(struct discord *client,
+                      enum discord_gateway_events event,
+                      const jsmnf_pair *data,
+                      const char js[],
+                      void *set)
+{
+    static const struct _discord_filter_key keys[] = {
+        { { "guild_id" }, 1 },
+    };
+    (void)client;
+
+    switch (event) {
+    case DISCORD_EV_GUILD_CREATE:
+    case DISCORD_EV_GUILD_UPDATE:
+    case DISCORD_EV_GUILD_DELETE:
+        return FILTER(ID_KEY);
+    default:
+        return FILTER(keys);
+    }
+}
+
+bool
+discord_filter_channels(struct discord *client,
+                        enum discord_gateway_events event,
+                        const jsmnf_pair *data,
+                        const char js[],
+                        void *set)
+{
+    static const struct _discord_filter_key keys[] = {
+        { { "channel_id" }, 1 },
+    };
+    (void)client;
+
+    switch (event) {
+    case DISCORD_EV_CHANNEL_CREATE:
+    case DISCORD_EV_CHANNEL_UPDATE:
+    case DISCORD_EV_CHANNEL_DELETE:
+    case DISCORD_EV_THREAD_CREATE:
+    case DISCORD_EV_THREAD_UPDATE:
+    case DISCORD_EV_THREAD_DELETE:
+        return FILTER(ID_KEY);
+    default:
+        return FILTER(keys);
+    }
+}
+
+bool
+discord_filter_users(struct discord *client,
+                     enum discord_gateway_events event,
+                     const jsmnf_pair *data,
+                     const char js[],
+                     void *set)
+{
+    static const struct _discord_filter_key keys[] = {
+        { { "author", "id" }, 2 },
+        { { "user", "id" }, 2 },
+        { { "user_id" }, 1 },
+    };
+    (void)client;
+
+    switch (event) {
+    case DISCORD_EV_USER_UPDATE:
+        return FILTER(ID_KEY);
+    default:
+        return FILTER(keys);
+    }
+}
+
+#undef FILTER
+
+bool
+discord_filter_no_bots(struct discord *client,
+                       enum discord_gateway_events event,
+                       const jsmnf_pair *data,
+                       const char js[],
+                       void *unused)
+{
+    char *const path[] = { "author", "bot" };
+    const jsmnf_pair *f = jsmnf_find_path(data, js, path, 2);
+    (void)client;
+    (void)event;
+    (void)unused;
+
+    return !(f && f->type == JSMN_PRIMITIVE && 't' == js[f->v.pos]);
+}
+
+struct _discord_event_filter {
+    /** the predicate to be evaluated */
+    discord_ev_filter predicate;
+    /** user arbitrary data passed to `predicate` */
+    void *data;
+};
+
+void
+discord_event_filters_init(struct discord_event_filters *filters,
+                           struct logconf *conf)
+{
+    memset(filters, 0, sizeof *filters);
+
+    logconf_branch(&filters->conf, conf, "DISCORD_EVENT_FILTERS");
+}
+
+void
+discord_event_filters_cleanup(struct discord_event_filters *filters)
+{
+    for (int i = 0; i < DISCORD_EV_MAX; ++i)
+        free(filters->events[i].array);
+}
+
+void
+discord_event_filters_append(struct discord_event_filters *filters,
+                             enum discord_gateway_events event,
+                             discord_ev_filter predicate,
+                             void *data)
+{
+    struct discord_event_filters_list *list = &filters->events[event];
+
+    if (list->size == list->realsize) {
+        const int realsize = list->realsize ? list->realsize * 2 : 2;
+        void *tmp =
+            realloc(list->array, (size_t)realsize * sizeof *list->array);
+
+        ASSERT_S(tmp != NULL, "Out of memory");
+        list->array = tmp;
+        list->realsize = realsize;
+    }
+    list->array[list->size].predicate = predicate;
+    list->array[list->size].data = data;
+    ++list->size;
+}
+
+bool
+discord_event_filters_pass(struct discord_event_filters *filters,
+                           struct discord_gateway_payload *payload)
+{
+    const struct discord_event_filters_list *list =
+        &filters->events[payload->event];
+    struct discord *client = CLIENT(filters, filters);
+
+    for (int i = 0; i < list->size; ++i) {
+        if (!list->array[i].predicate(client, payload->event, payload->data,
+                                      payload->json.start,
+                                      list->array[i].data))
+        {
+            logconf_trace(&filters->conf, "Filtered out %s", payload->name);
+            return false;
+        }
+    }
+    return true;
+}
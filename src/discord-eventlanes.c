@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+/* the lanes each lane thread belongs to, so that a lane still recognizes
+ *      itself after it has been swapped out and is being joined */
+static pthread_key_t lanes_key;
+static pthread_once_t lanes_key_once = PTHREAD_ONCE_INIT;
+
+static void
+_discord_lanes_key_init(void)
+{
+    ASSERT_S(0 == pthread_key_create(&lanes_key, NULL),
+             "Couldn't create the event lanes key");
+}
+
+static void *
+_discord_event_lane_run(void *p_lane)
+{
+    struct discord_event_lane *lane = p_lane;
+
+    pthread_setspecific(lanes_key, lane->lanes);
+
+    pthread_mutex_lock(&lane->lock);
+    while (1) {
+        QUEUE(struct discord_gateway_event) *qelem;
+        struct discord_gateway_event *event;
+
+        while (QUEUE_EMPTY(&lane->queue) && !lane->shutdown)
+            pthread_cond_wait(&lane->cond, &lane->lock);
+        if (QUEUE_EMPTY(&lane->queue)) break;
+
+        qelem = QUEUE_HEAD(&lane->queue);
+        QUEUE_REMOVE(qelem);
+        event = QUEUE_DATA(qelem, struct discord_gateway_event, entry);
+        pthread_mutex_unlock(&lane->lock);
+
+        discord_gateway_event_dispatch(event);
+
+        pthread_mutex_lock(&lane->lock);
+    }
+    pthread_mutex_unlock(&lane->lock);
+
+    return NULL;
+}
+
+static void
+_discord_event_lanes_stop(struct discord_event_lane *array, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        struct discord_event_lane *lane = &array[i];
+
+        pthread_mutex_lock(&lane->lock);
+        lane->shutdown = true;
+        pthread_cond_signal(&lane->cond);
+        pthread_mutex_unlock(&lane->lock);
+    }
+    for (int i = 0; i < size; ++i) {
+        struct discord_event_lane *lane = &array[i];
+
+        pthread_join(lane->tid, NULL);
+        pthread_cond_destroy(&lane->cond);
+        pthread_mutex_destroy(&lane->lock);
+    }
+    free(array);
+}
+
+/* the old lanes are joined after they're swapped out, so new events
+ *      aren't held back while they drain */
+static void
+_discord_event_lanes_swap(struct discord_event_lanes *lanes,
+                          struct discord_event_lane *array,
+                          int size)
+{
+    struct discord_event_lane *old_array;
+    int old_size;
+
+    pthread_mutex_lock(&lanes->lock);
+    old_array = lanes->array;
+    old_size = lanes->size;
+    lanes->array = array;
+    lanes->size = size;
+    pthread_mutex_unlock(&lanes->lock);
+
+    _discord_event_lanes_stop(old_array, old_size);
+}
+
+void
+discord_event_lanes_init(struct discord_event_lanes *lanes,
+                         struct logconf *conf)
+{
+    memset(lanes, 0, sizeof *lanes);
+
+    logconf_branch(&lanes->conf, conf, "DISCORD_EVENT_LANES");
+
+    ASSERT_S(!pthread_mutex_init(&lanes->lock, NULL),
+             "Couldn't initialize lanes mutex");
+}
+
+void
+discord_event_lanes_cleanup(struct discord_event_lanes *lanes)
+{
+    _discord_event_lanes_swap(lanes, NULL, 0);
+    pthread_mutex_destroy(&lanes->lock);
+}
+
+bool
+discord_event_lanes_is_lane(struct discord_event_lanes *lanes)
+{
+    pthread_once(&lanes_key_once, &_discord_lanes_key_init);
+    return pthread_getspecific(lanes_key) == lanes;
+}
+
+CCORDcode
+discord_event_lanes_start(struct discord_event_lanes *lanes, int count)
+{
+    struct discord_event_lane *array;
+
+    /* a lane would be joining itself */
+    if (discord_event_lanes_is_lane(lanes)) {
+        logconf_error(&lanes->conf,
+                      "Lanes can't be changed from within a lane");
+        return CCORD_BAD_PARAMETER;
+    }
+
+    _discord_event_lanes_swap(lanes, NULL, 0);
+
+    if (count <= 0) return CCORD_OK;
+
+    array = calloc((size_t)count, sizeof *array);
+    ASSERT_S(array != NULL, "Out of memory");
+
+    for (int i = 0; i < count; ++i) {
+        struct discord_event_lane *lane = &array[i];
+
+        lane->lanes = lanes;
+        QUEUE_INIT(&lane->queue);
+        ASSERT_S(!pthread_mutex_init(&lane->lock, NULL),
+                 "Couldn't initialize lane mutex");
+        ASSERT_S(!pthread_cond_init(&lane->cond, NULL),
+                 "Couldn't initialize lane condition");
+        if (pthread_create(&lane->tid, NULL, &_discord_event_lane_run, lane))
+        {
+            logconf_error(&lanes->conf, "Couldn't start lane #%d", i);
+            pthread_cond_destroy(&lane->cond);
+            pthread_mutex_destroy(&lane->lock);
+            _discord_event_lanes_stop(array, i);
+            return CCORD_FULL_WORKER;
+        }
+    }
+    _discord_event_lanes_swap(lanes, array, count);
+
+    logconf_info(&lanes->conf, "Started %d ordered lanes", count);
+
+    return CCORD_OK;
+}
+
+/* return the event's id under `key`, or 0 if it doesn't have one */
+static u64snowflake
+_discord_event_lanes_get_id(struct discord_gateway_payload *payload,
+                            enum discord_event_lane_key key)
+{
+    const char *js = payload->json.start;
+    jsmnf_pair *f;
+    char *name;
+
+    switch (key) {
+    case DISCORD_EVENT_LANE_GUILD:
+        switch (payload->event) {
+        case DISCORD_EV_GUILD_CREATE:
+        case DISCORD_EV_GUILD_UPDATE:
+        case DISCORD_EV_GUILD_DELETE:
+            name = "id";
+            break;
+        default:
+            name = "guild_id";
+            break;
+        }
+        break;
+    case DISCORD_EVENT_LANE_CHANNEL:
+        switch (payload->event) {
+        case DISCORD_EV_CHANNEL_CREATE:
+        case DISCORD_EV_CHANNEL_UPDATE:
+        case DISCORD_EV_CHANNEL_DELETE:
+        case DISCORD_EV_THREAD_CREATE:
+        case DISCORD_EV_THREAD_UPDATE:
+        case DISCORD_EV_THREAD_DELETE:
+            name = "id";
+            break;
+        default:
+            name = "channel_id";
+            break;
+        }
+        break;
+    default:
+        return 0;
+    }
+
+    if ((f = jsmnf_find(payload->data, js, name, (int)strlen(name)))
+        && f->type == JSMN_STRING)
+    {
+        return (u64snowflake)strtoull(js + f->v.pos, NULL, 10);
+    }
+    return 0;
+}
+
+static int
+_discord_event_lanes_get(struct discord_event_lanes *lanes,
+                         struct discord_gateway_payload *payload)
+{
+    const enum discord_event_lane_key key = lanes->keys[payload->event];
+    u64snowflake id;
+
+    if (!lanes->size) return -1;
+
+    id = _discord_event_lanes_get_id(payload, key);
+    if (!id)
+        id = _discord_event_lanes_get_id(payload,
+                                         key == DISCORD_EVENT_LANE_GUILD
+                                             ? DISCORD_EVENT_LANE_CHANNEL
+                                             : DISCORD_EVENT_LANE_GUILD);
+
+    /* spread the snowflake's timestamp and sequence bits */
+    return (int)((id ^ (id >> 22)) % (u64snowflake)lanes->size);
+}
+
+int
+discord_event_lanes_get(struct discord_event_lanes *lanes,
+                        struct discord_gateway_payload *payload)
+{
+    int index;
+
+    pthread_mutex_lock(&lanes->lock);
+    index = _discord_event_lanes_get(lanes, payload);
+    pthread_mutex_unlock(&lanes->lock);
+
+    return index;
+}
+
+CCORDcode
+discord_event_lanes_add(struct discord_event_lanes *lanes,
+                        struct discord_gateway *gw)
+{
+    struct discord_event_lane *lane;
+    struct discord_gateway_event *event;
+    int index;
+
+    /* held until the event is queued, so the lane can't be swapped out */
+    pthread_mutex_lock(&lanes->lock);
+    if ((index = _discord_event_lanes_get(lanes, &gw->payload)) < 0) {
+        pthread_mutex_unlock(&lanes->lock);
+        return CCORD_UNAVAILABLE;
+    }
+
+    lane = &lanes->array[index];
+    event = discord_gateway_event_init(gw);
+
+    logconf_trace(&lanes->conf, "Queue %s to lane #%d", event->name, index);
+
+    pthread_mutex_lock(&lane->lock);
+    QUEUE_INSERT_TAIL(&lane->queue, &event->entry);
+    pthread_cond_signal(&lane->cond);
+    pthread_mutex_unlock(&lane->lock);
+    pthread_mutex_unlock(&lanes->lock);
+
+    return CCORD_OK;
+}
@@ -8,14 +8,19 @@
 void
 discord_shutdown(struct discord *client)
 {
-    if (client->gw.session->status != DISCORD_SESSION_SHUTDOWN)
-        discord_gateway_shutdown(&client->gw);
+    for (int i = 0; i < client->shards.count; ++i) {
+        struct discord_gateway *gw = SHARD(client, i);
+
+        if (gw->session->status != DISCORD_SESSION_SHUTDOWN)
+            discord_gateway_shutdown(gw);
+    }
 }
 
 void
 discord_reconnect(struct discord *client, bool resume)
 {
-    discord_gateway_reconnect(&client->gw, resume);
+    for (int i = 0; i < client->shards.count; ++i)
+        discord_gateway_reconnect(SHARD(client, i), resume);
 }
 
 void
@@ -24,21 +29,24 @@ discord_request_guild_members(struct discord *client,
 {
     ASSERT_S(client->gw.cbs[1][DISCORD_EV_GUILD_MEMBERS_CHUNK] != NULL,
              "Missing callback for discord_set_on_guild_members_chunk()");
-    discord_gateway_send_request_guild_members(&client->gw, request);
+    discord_gateway_send_request_guild_members(
+        discord_gateway_get_shard(client, request->guild_id), request);
 }
 
 void
 discord_update_voice_state(struct discord *client,
                            struct discord_update_voice_state *update)
 {
-    discord_gateway_send_update_voice_state(&client->gw, update);
+    discord_gateway_send_update_voice_state(
+        discord_gateway_get_shard(client, update->guild_id), update);
 }
 
 void
 discord_update_presence(struct discord *client,
                         struct discord_presence_update *presence)
 {
-    discord_gateway_send_presence_update(&client->gw, presence);
+    for (int i = 0; i < client->shards.count; ++i)
+        discord_gateway_send_presence_update(SHARD(client, i), presence);
 }
 
 /* deprecated, use discord_update_presence() instead */
@@ -87,6 +95,44 @@ discord_set_event_scheduler(struct discord *client, discord_ev_scheduler cb)
     client->gw.scheduler = cb;
 }
 
+CCORDcode
+discord_set_event_lanes(struct discord *client, int count)
+{
+    CCORD_EXPECT(client, count >= 0, CCORD_BAD_PARAMETER, "");
+
+    return discord_event_lanes_start(&client->lanes, count);
+}
+
+CCORDcode
+discord_set_event_lane_key(struct discord *client,
+                           enum discord_gateway_events event,
+                           enum discord_event_lane_key key)
+{
+    CCORD_EXPECT(client, event > DISCORD_EV_NONE && event < DISCORD_EV_MAX,
+                 CCORD_BAD_PARAMETER, "");
+    CCORD_EXPECT(client,
+                 key == DISCORD_EVENT_LANE_GUILD
+                     || key == DISCORD_EVENT_LANE_CHANNEL,
+                 CCORD_BAD_PARAMETER, "");
+
+    client->lanes.keys[event] = key;
+
+    return CCORD_OK;
+}
+
+CCORDcode
+discord_set_event_mask(struct discord *client,
+                       enum discord_gateway_events event,
+                       const void *mask)
+{
+    CCORD_EXPECT(client, event > DISCORD_EV_NONE && event < DISCORD_EV_MAX,
+                 CCORD_BAD_PARAMETER, "");
+
+    client->gw.masks[event] = mask;
+
+    return CCORD_OK;
+}
+
 void
 discord_set_on_command(struct discord *client,
                        char command[],
@@ -112,6 +158,21 @@ discord_set_on_commands(struct discord *client,
         discord_set_on_command(client, commands[i], cb);
 }
 
+CCORDcode
+discord_add_event_filter(struct discord *client,
+                         enum discord_gateway_events event,
+                         discord_ev_filter predicate,
+                         void *arg)
+{
+    CCORD_EXPECT(client, event > DISCORD_EV_NONE && event < DISCORD_EV_MAX,
+                 CCORD_BAD_PARAMETER, "");
+    CCORD_EXPECT(client, predicate != NULL, CCORD_BAD_PARAMETER, "");
+
+    discord_event_filters_append(&client->filters, event, predicate, arg);
+
+    return CCORD_OK;
+}
+
 void
 discord_set_on_ready(struct discord *client,
                      void (*cb)(struct discord *client,
@@ -710,3 +771,44 @@ discord_set_on_webhooks_update(
     client->gw.cbs[1][DISCORD_EV_WEBHOOKS_UPDATE] = (discord_ev_event)cb;
     discord_add_intents(client, DISCORD_GATEWAY_GUILD_WEBHOOKS);
 }
+
+void
+discord_set_on_message_create_view(
+    struct discord *client,
+    void (*cb)(struct discord *client,
+               const struct discord_message_view *event))
+{
+    client->gw.views[DISCORD_EV_MESSAGE_CREATE] = (discord_ev_event)cb;
+    discord_add_intents(client, DISCORD_GATEWAY_GUILD_MESSAGES
+                                    | DISCORD_GATEWAY_DIRECT_MESSAGES);
+}
+
+void
+discord_set_on_message_update_view(
+    struct discord *client,
+    void (*cb)(struct discord *client,
+               const struct discord_message_view *event))
+{
+    client->gw.views[DISCORD_EV_MESSAGE_UPDATE] = (discord_ev_event)cb;
+    discord_add_intents(client, DISCORD_GATEWAY_GUILD_MESSAGES
+                                    | DISCORD_GATEWAY_DIRECT_MESSAGES);
+}
+
+void
+discord_set_on_interaction_create_view(
+    struct discord *client,
+    void (*cb)(struct discord *client,
+               const struct discord_interaction_view *event))
+{
+    client->gw.views[DISCORD_EV_INTERACTION_CREATE] = (discord_ev_event)cb;
+}
+
+void
+discord_set_on_presence_update_view(
+    struct discord *client,
+    void (*cb)(struct discord *client,
+               const struct discord_presence_update_view *event))
+{
+    client->gw.views[DISCORD_EV_PRESENCE_UPDATE] = (discord_ev_event)cb;
+    discord_add_intents(client, DISCORD_GATEWAY_GUILD_PRESENCES);
+}
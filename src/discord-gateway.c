@@ -71,6 +71,12 @@ _discord_on_hello(struct discord_gateway *gw)
         gw->timer->hbeat_interval =
             strtoll(gw->payload.json.start + f->v.pos, NULL, 10);
 
+    /* start heartbeating right away, the shard may have to wait on the
+     *  identify queue for longer than `heartbeat_interval` */
+    discord_gateway_send_heartbeat(gw, gw->payload.seq);
+
+    /* resumes don't count towards the session start limit, so they skip
+     *  ahead of any queued identify */
     if (gw->session->status & DISCORD_SESSION_RESUMABLE)
         discord_gateway_send_resume(gw, &(struct discord_resume){
                                             .token = gw->id.token,
@@ -78,130 +84,240 @@ _discord_on_hello(struct discord_gateway *gw)
                                             .seq = gw->payload.seq,
                                         });
     else
-        discord_gateway_send_identify(gw, &gw->id);
+        discord_gateway_queue_identify(gw);
 }
 
 #define RETURN_IF_MATCH(event, str)                                           \
-    if (!strcmp(#event, str)) return DISCORD_EV_##event
-
-static enum discord_gateway_events
-_discord_gateway_event_eval(const char name[])
-{
-    RETURN_IF_MATCH(READY, name);
-    RETURN_IF_MATCH(RESUMED, name);
-    RETURN_IF_MATCH(RECONNECT, name);
-    RETURN_IF_MATCH(INVALID_SESSION, name);
-    RETURN_IF_MATCH(APPLICATION_COMMAND_PERMISSIONS_UPDATE, name);
-    RETURN_IF_MATCH(AUTO_MODERATION_RULE_CREATE, name);
-    RETURN_IF_MATCH(AUTO_MODERATION_RULE_UPDATE, name);
-    RETURN_IF_MATCH(AUTO_MODERATION_RULE_DELETE, name);
-    RETURN_IF_MATCH(AUTO_MODERATION_ACTION_EXECUTION, name);
-    RETURN_IF_MATCH(CHANNEL_CREATE, name);
-    RETURN_IF_MATCH(CHANNEL_UPDATE, name);
-    RETURN_IF_MATCH(CHANNEL_DELETE, name);
-    RETURN_IF_MATCH(CHANNEL_PINS_UPDATE, name);
-    RETURN_IF_MATCH(THREAD_CREATE, name);
-    RETURN_IF_MATCH(THREAD_UPDATE, name);
-    RETURN_IF_MATCH(THREAD_DELETE, name);
-    RETURN_IF_MATCH(THREAD_LIST_SYNC, name);
-    RETURN_IF_MATCH(THREAD_MEMBER_UPDATE, name);
-    RETURN_IF_MATCH(THREAD_MEMBERS_UPDATE, name);
-    RETURN_IF_MATCH(GUILD_CREATE, name);
-    RETURN_IF_MATCH(GUILD_UPDATE, name);
-    RETURN_IF_MATCH(GUILD_DELETE, name);
-    RETURN_IF_MATCH(GUILD_BAN_ADD, name);
-    RETURN_IF_MATCH(GUILD_BAN_REMOVE, name);
-    RETURN_IF_MATCH(GUILD_EMOJIS_UPDATE, name);
-    RETURN_IF_MATCH(GUILD_STICKERS_UPDATE, name);
-    RETURN_IF_MATCH(GUILD_INTEGRATIONS_UPDATE, name);
-    RETURN_IF_MATCH(GUILD_MEMBER_ADD, name);
-    RETURN_IF_MATCH(GUILD_MEMBER_UPDATE, name);
-    RETURN_IF_MATCH(GUILD_MEMBER_REMOVE, name);
-    RETURN_IF_MATCH(GUILD_MEMBERS_CHUNK, name);
-    RETURN_IF_MATCH(GUILD_ROLE_CREATE, name);
-    RETURN_IF_MATCH(GUILD_ROLE_UPDATE, name);
-    RETURN_IF_MATCH(GUILD_ROLE_DELETE, name);
-    RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_CREATE, name);
-    RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_UPDATE, name);
-    RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_DELETE, name);
-    RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_USER_ADD, name);
-    RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_USER_REMOVE, name);
-    RETURN_IF_MATCH(INTEGRATION_CREATE, name);
-    RETURN_IF_MATCH(INTEGRATION_UPDATE, name);
-    RETURN_IF_MATCH(INTEGRATION_DELETE, name);
-    RETURN_IF_MATCH(INTERACTION_CREATE, name);
-    RETURN_IF_MATCH(INVITE_CREATE, name);
-    RETURN_IF_MATCH(INVITE_DELETE, name);
-    RETURN_IF_MATCH(MESSAGE_CREATE, name);
-    RETURN_IF_MATCH(MESSAGE_UPDATE, name);
-    RETURN_IF_MATCH(MESSAGE_DELETE, name);
-    RETURN_IF_MATCH(MESSAGE_DELETE_BULK, name);
-    RETURN_IF_MATCH(MESSAGE_REACTION_ADD, name);
-    RETURN_IF_MATCH(MESSAGE_REACTION_REMOVE, name);
-    RETURN_IF_MATCH(MESSAGE_REACTION_REMOVE_ALL, name);
-    RETURN_IF_MATCH(MESSAGE_REACTION_REMOVE_EMOJI, name);
-    RETURN_IF_MATCH(PRESENCE_UPDATE, name);
-    RETURN_IF_MATCH(STAGE_INSTANCE_CREATE, name);
-    RETURN_IF_MATCH(STAGE_INSTANCE_DELETE, name);
-    RETURN_IF_MATCH(STAGE_INSTANCE_UPDATE, name);
-    RETURN_IF_MATCH(TYPING_START, name);
-    RETURN_IF_MATCH(USER_UPDATE, name);
-    RETURN_IF_MATCH(VOICE_STATE_UPDATE, name);
-    RETURN_IF_MATCH(VOICE_SERVER_UPDATE, name);
-    RETURN_IF_MATCH(WEBHOOKS_UPDATE, name);
+    if (!memcmp(#event, str, sizeof(#event) - 1)) return DISCORD_EV_##event
+
+/* names are bucketed by their length, so that only a handful of same-length
+ *  candidates have to be compared (most frequent events first) */
+enum discord_gateway_events
+discord_gateway_event_eval(const char name[], size_t len)
+{
+    switch (len) {
+    case 5:
+        RETURN_IF_MATCH(READY, name);
+        break;
+    case 7:
+        RETURN_IF_MATCH(RESUMED, name);
+        break;
+    case 9:
+        RETURN_IF_MATCH(RECONNECT, name);
+        break;
+    case 11:
+        RETURN_IF_MATCH(USER_UPDATE, name);
+        break;
+    case 12:
+        RETURN_IF_MATCH(TYPING_START, name);
+        RETURN_IF_MATCH(GUILD_CREATE, name);
+        RETURN_IF_MATCH(GUILD_UPDATE, name);
+        RETURN_IF_MATCH(GUILD_DELETE, name);
+        break;
+    case 13:
+        RETURN_IF_MATCH(THREAD_CREATE, name);
+        RETURN_IF_MATCH(THREAD_UPDATE, name);
+        RETURN_IF_MATCH(THREAD_DELETE, name);
+        RETURN_IF_MATCH(GUILD_BAN_ADD, name);
+        RETURN_IF_MATCH(INVITE_CREATE, name);
+        RETURN_IF_MATCH(INVITE_DELETE, name);
+        break;
+    case 14:
+        RETURN_IF_MATCH(MESSAGE_CREATE, name);
+        RETURN_IF_MATCH(MESSAGE_UPDATE, name);
+        RETURN_IF_MATCH(CHANNEL_CREATE, name);
+        RETURN_IF_MATCH(CHANNEL_UPDATE, name);
+        RETURN_IF_MATCH(CHANNEL_DELETE, name);
+        RETURN_IF_MATCH(MESSAGE_DELETE, name);
+        break;
+    case 15:
+        RETURN_IF_MATCH(PRESENCE_UPDATE, name);
+        RETURN_IF_MATCH(INVALID_SESSION, name);
+        RETURN_IF_MATCH(WEBHOOKS_UPDATE, name);
+        break;
+    case 16:
+        RETURN_IF_MATCH(THREAD_LIST_SYNC, name);
+        RETURN_IF_MATCH(GUILD_BAN_REMOVE, name);
+        RETURN_IF_MATCH(GUILD_MEMBER_ADD, name);
+        break;
+    case 17:
+        RETURN_IF_MATCH(GUILD_ROLE_CREATE, name);
+        RETURN_IF_MATCH(GUILD_ROLE_UPDATE, name);
+        RETURN_IF_MATCH(GUILD_ROLE_DELETE, name);
+        break;
+    case 18:
+        RETURN_IF_MATCH(VOICE_STATE_UPDATE, name);
+        RETURN_IF_MATCH(INTERACTION_CREATE, name);
+        RETURN_IF_MATCH(INTEGRATION_CREATE, name);
+        RETURN_IF_MATCH(INTEGRATION_UPDATE, name);
+        RETURN_IF_MATCH(INTEGRATION_DELETE, name);
+        break;
+    case 19:
+        RETURN_IF_MATCH(GUILD_MEMBER_UPDATE, name);
+        RETURN_IF_MATCH(CHANNEL_PINS_UPDATE, name);
+        RETURN_IF_MATCH(GUILD_EMOJIS_UPDATE, name);
+        RETURN_IF_MATCH(GUILD_MEMBER_REMOVE, name);
+        RETURN_IF_MATCH(GUILD_MEMBERS_CHUNK, name);
+        RETURN_IF_MATCH(MESSAGE_DELETE_BULK, name);
+        RETURN_IF_MATCH(VOICE_SERVER_UPDATE, name);
+        break;
+    case 20:
+        RETURN_IF_MATCH(MESSAGE_REACTION_ADD, name);
+        RETURN_IF_MATCH(THREAD_MEMBER_UPDATE, name);
+        break;
+    case 21:
+        RETURN_IF_MATCH(THREAD_MEMBERS_UPDATE, name);
+        RETURN_IF_MATCH(GUILD_STICKERS_UPDATE, name);
+        RETURN_IF_MATCH(STAGE_INSTANCE_CREATE, name);
+        RETURN_IF_MATCH(STAGE_INSTANCE_DELETE, name);
+        RETURN_IF_MATCH(STAGE_INSTANCE_UPDATE, name);
+        break;
+    case 23:
+        RETURN_IF_MATCH(MESSAGE_REACTION_REMOVE, name);
+        break;
+    case 25:
+        RETURN_IF_MATCH(GUILD_INTEGRATIONS_UPDATE, name);
+        break;
+    case 27:
+        RETURN_IF_MATCH(AUTO_MODERATION_RULE_CREATE, name);
+        RETURN_IF_MATCH(AUTO_MODERATION_RULE_UPDATE, name);
+        RETURN_IF_MATCH(AUTO_MODERATION_RULE_DELETE, name);
+        RETURN_IF_MATCH(MESSAGE_REACTION_REMOVE_ALL, name);
+        break;
+    case 28:
+        RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_CREATE, name);
+        RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_UPDATE, name);
+        RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_DELETE, name);
+        break;
+    case 29:
+        RETURN_IF_MATCH(MESSAGE_REACTION_REMOVE_EMOJI, name);
+        break;
+    case 30:
+        RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_USER_ADD, name);
+        break;
+    case 32:
+        RETURN_IF_MATCH(AUTO_MODERATION_ACTION_EXECUTION, name);
+        break;
+    case 33:
+        RETURN_IF_MATCH(GUILD_SCHEDULED_EVENT_USER_REMOVE, name);
+        break;
+    case 38:
+        RETURN_IF_MATCH(APPLICATION_COMMAND_PERMISSIONS_UPDATE, name);
+        break;
+    default:
+        break;
+    }
     return DISCORD_EV_NONE;
 }
 
 #undef RETURN_IF_MATCH
 
-static struct discord_gateway *
-_discord_gateway_clone(const struct discord_gateway *gw)
-{
-    return &discord_clone(CLIENT(gw, gw))->gw;
-}
+/* return event name as string in case of a match */
+#define CASE_RETURN_EVENT(event)                                              \
+    case DISCORD_EV_##event:                                                  \
+        return #event
 
-static void
-_discord_gateway_clone_cleanup(struct discord_gateway *clone)
+static const char *
+_discord_gateway_event_print(enum discord_gateway_events event)
 {
-    discord_cleanup(CLIENT(clone, gw));
+    switch (event) {
+        CASE_RETURN_EVENT(READY);
+        CASE_RETURN_EVENT(RESUMED);
+        CASE_RETURN_EVENT(RECONNECT);
+        CASE_RETURN_EVENT(INVALID_SESSION);
+        CASE_RETURN_EVENT(APPLICATION_COMMAND_PERMISSIONS_UPDATE);
+        CASE_RETURN_EVENT(AUTO_MODERATION_RULE_CREATE);
+        CASE_RETURN_EVENT(AUTO_MODERATION_RULE_UPDATE);
+        CASE_RETURN_EVENT(AUTO_MODERATION_RULE_DELETE);
+        CASE_RETURN_EVENT(AUTO_MODERATION_ACTION_EXECUTION);
+        CASE_RETURN_EVENT(CHANNEL_CREATE);
+        CASE_RETURN_EVENT(CHANNEL_UPDATE);
+        CASE_RETURN_EVENT(CHANNEL_DELETE);
+        CASE_RETURN_EVENT(CHANNEL_PINS_UPDATE);
+        CASE_RETURN_EVENT(THREAD_CREATE);
+        CASE_RETURN_EVENT(THREAD_UPDATE);
+        CASE_RETURN_EVENT(THREAD_DELETE);
+        CASE_RETURN_EVENT(THREAD_LIST_SYNC);
+        CASE_RETURN_EVENT(THREAD_MEMBER_UPDATE);
+        CASE_RETURN_EVENT(THREAD_MEMBERS_UPDATE);
+        CASE_RETURN_EVENT(GUILD_CREATE);
+        CASE_RETURN_EVENT(GUILD_UPDATE);
+        CASE_RETURN_EVENT(GUILD_DELETE);
+        CASE_RETURN_EVENT(GUILD_BAN_ADD);
+        CASE_RETURN_EVENT(GUILD_BAN_REMOVE);
+        CASE_RETURN_EVENT(GUILD_EMOJIS_UPDATE);
+        CASE_RETURN_EVENT(GUILD_STICKERS_UPDATE);
+        CASE_RETURN_EVENT(GUILD_INTEGRATIONS_UPDATE);
+        CASE_RETURN_EVENT(GUILD_MEMBER_ADD);
+        CASE_RETURN_EVENT(GUILD_MEMBER_UPDATE);
+        CASE_RETURN_EVENT(GUILD_MEMBER_REMOVE);
+        CASE_RETURN_EVENT(GUILD_MEMBERS_CHUNK);
+        CASE_RETURN_EVENT(GUILD_ROLE_CREATE);
+        CASE_RETURN_EVENT(GUILD_ROLE_UPDATE);
+        CASE_RETURN_EVENT(GUILD_ROLE_DELETE);
+        CASE_RETURN_EVENT(GUILD_SCHEDULED_EVENT_CREATE);
+        CASE_RETURN_EVENT(GUILD_SCHEDULED_EVENT_UPDATE);
+        CASE_RETURN_EVENT(GUILD_SCHEDULED_EVENT_DELETE);
+        CASE_RETURN_EVENT(GUILD_SCHEDULED_EVENT_USER_ADD);
+        CASE_RETURN_EVENT(GUILD_SCHEDULED_EVENT_USER_REMOVE);
+        CASE_RETURN_EVENT(INTEGRATION_CREATE);
+        CASE_RETURN_EVENT(INTEGRATION_UPDATE);
+        CASE_RETURN_EVENT(INTEGRATION_DELETE);
+        CASE_RETURN_EVENT(INTERACTION_CREATE);
+        CASE_RETURN_EVENT(INVITE_CREATE);
+        CASE_RETURN_EVENT(INVITE_DELETE);
+        CASE_RETURN_EVENT(MESSAGE_CREATE);
+        CASE_RETURN_EVENT(MESSAGE_UPDATE);
+        CASE_RETURN_EVENT(MESSAGE_DELETE);
+        CASE_RETURN_EVENT(MESSAGE_DELETE_BULK);
+        CASE_RETURN_EVENT(MESSAGE_REACTION_ADD);
+        CASE_RETURN_EVENT(MESSAGE_REACTION_REMOVE);
+        CASE_RETURN_EVENT(MESSAGE_REACTION_REMOVE_ALL);
+        CASE_RETURN_EVENT(MESSAGE_REACTION_REMOVE_EMOJI);
+        CASE_RETURN_EVENT(PRESENCE_UPDATE);
+        CASE_RETURN_EVENT(STAGE_INSTANCE_CREATE);
+        CASE_RETURN_EVENT(STAGE_INSTANCE_DELETE);
+        CASE_RETURN_EVENT(STAGE_INSTANCE_UPDATE);
+        CASE_RETURN_EVENT(TYPING_START);
+        CASE_RETURN_EVENT(USER_UPDATE);
+        CASE_RETURN_EVENT(VOICE_STATE_UPDATE);
+        CASE_RETURN_EVENT(VOICE_SERVER_UPDATE);
+        CASE_RETURN_EVENT(WEBHOOKS_UPDATE);
+    case DISCORD_EV_NONE:
+    case DISCORD_EV_MAX:
+    default:
+        return "";
+    }
 }
 
+#undef CASE_RETURN_EVENT
+
 static void
-_discord_gateway_dispatch_thread(void *p_gw)
+_discord_gateway_dispatch_thread(void *p_event)
 {
-    struct discord_gateway *gw = p_gw;
+    struct discord_gateway_event *event = p_event;
+    struct discord_gateway *gw = event->gw;
+    const char *name = event->name;
 
     logconf_info(&gw->conf,
                  "Thread " ANSICOLOR("starts", ANSI_FG_RED) " to serve %s",
-                 gw->payload.name);
+                 name);
 
-    discord_gateway_dispatch(gw);
+    discord_gateway_event_dispatch(event);
 
     logconf_info(&gw->conf,
                  "Thread " ANSICOLOR("exits", ANSI_FG_RED) " from serving %s",
-                 gw->payload.name);
-
-    _discord_gateway_clone_cleanup(gw);
+                 name);
 }
 
+static void _discord_gateway_schedule(struct discord_gateway *gw);
+
 static void
 _discord_on_dispatch(struct discord_gateway *gw)
 {
-    struct discord *client = CLIENT(gw, gw);
-
-    /* TODO: this should only apply for user dispatched payloads? */
-#if 0
-  /* Ratelimit check */
-  if (gw->timer->now - gw->timer->event_last < 60000) {
-    ++gw->session->event_count;
-    ASSERT_S(gw->session->event_count < 120,
-             "Reach event dispatch threshold (120 every 60 seconds)");
-  }
-  else {
-    gw->timer->event_last = gw->timer->now;
-    gw->session->event_count = 0;
-  }
-#endif
+    struct discord *client = gw->client;
+
+    client->shards.current = gw->id.shard ? gw->id.shard->array[0] : 0;
 
     switch (gw->payload.event) {
     case DISCORD_EV_READY: {
@@ -230,8 +346,6 @@ _discord_on_dispatch(struct discord_gateway *gw)
 
         gw->session->is_ready = true;
         gw->session->retry.attempt = 0;
-
-        discord_gateway_send_heartbeat(gw, gw->payload.seq);
     } break;
     case DISCORD_EV_RESUMED:
         logconf_info(&gw->conf, "Succesfully resumed a Discord session!");
@@ -241,33 +355,47 @@ _discord_on_dispatch(struct discord_gateway *gw)
 
         if (client->cache.on_shard_resumed)
             client->cache.on_shard_resumed(client, &gw->id);
-        discord_gateway_send_heartbeat(gw, gw->payload.seq);
         break;
     default:
         break;
     }
 
+    _discord_gateway_schedule(gw);
+}
+
+static void
+_discord_gateway_schedule(struct discord_gateway *gw)
+{
+    struct discord *client = gw->client;
+
+    /* discard filtered out events before they're decoded or scheduled */
+    if (!discord_event_filters_pass(&client->filters, &gw->payload)) return;
+
     /* get dispatch event opcode */
-    enum discord_event_scheduler mode =
-        gw->scheduler(client, gw->payload.json.start + gw->payload.data->v.pos,
-                      gw->payload.data->v.len, gw->payload.event);
+    enum discord_event_scheduler mode = client->gw.scheduler(
+        client, gw->payload.json.start + gw->payload.data->v.pos,
+        gw->payload.data->v.len, gw->payload.event);
 
     switch (mode) {
     case DISCORD_EVENT_IGNORE:
         break;
     case DISCORD_EVENT_MAIN_THREAD:
-        discord_gateway_dispatch(gw);
+        discord_gateway_dispatch(gw, &gw->payload);
         break;
     case DISCORD_EVENT_WORKER_THREAD: {
-        struct discord_gateway *clone = _discord_gateway_clone(gw);
+        struct discord_gateway_event *event = discord_gateway_event_init(gw);
         CCORDcode code = discord_worker_add(
-            client, &_discord_gateway_dispatch_thread, clone);
+            client, &_discord_gateway_dispatch_thread, event);
 
         if (code != CCORD_OK) {
             log_error("Couldn't start worker-thread (code %d)", code);
-            _discord_gateway_clone_cleanup(clone);
+            discord_refcounter_decr(&client->refcounter, event);
         }
     } break;
+    case DISCORD_EVENT_ORDERED_THREAD:
+        if (CCORD_UNAVAILABLE == discord_event_lanes_add(&client->lanes, gw))
+            discord_gateway_dispatch(gw, &gw->payload);
+        break;
     default:
         ERR("Unknown event handling mode (code: %d)", mode);
     }
@@ -296,7 +424,7 @@ _discord_on_invalid_session(struct discord_gateway *gw)
     }
 
     ws_close(gw->ws, opcode, reason, SIZE_MAX);
-    io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+    io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
 }
 
 static void
@@ -310,7 +438,7 @@ _discord_on_reconnect(struct discord_gateway *gw)
     ws_close(gw->ws,
              (enum ws_close_reason)DISCORD_GATEWAY_CLOSE_REASON_RECONNECT,
              reason, sizeof(reason));
-    io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+    io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
 }
 
 static void
@@ -359,9 +487,9 @@ _ws_on_close(void *p_gw,
 
     /* user-triggered shutdown */
     if (gw->session->status & DISCORD_SESSION_SHUTDOWN) {
-        if (CLIENT(gw, gw)->cache.on_shard_disconnected)
-            CLIENT(gw, gw)->cache.on_shard_disconnected(
-                CLIENT(gw, gw), &gw->id,
+        if (gw->client->cache.on_shard_disconnected)
+            gw->client->cache.on_shard_disconnected(
+                gw->client, &gw->id,
                 gw->session->status & DISCORD_SESSION_RESUMABLE);
         return;
     }
@@ -408,44 +536,36 @@ _ws_on_close(void *p_gw,
         gw->session->retry.enable = true;
         break;
     }
-    if (CLIENT(gw, gw)->cache.on_shard_disconnected)
-        CLIENT(gw, gw)->cache.on_shard_disconnected(
-            CLIENT(gw, gw), &gw->id,
+    if (gw->client->cache.on_shard_disconnected)
+        gw->client->cache.on_shard_disconnected(
+            gw->client, &gw->id,
             gw->session->status & DISCORD_SESSION_RESUMABLE);
 }
 
 static bool
-_discord_gateway_payload_from_json(struct discord_gateway_payload *payload,
-                                   const char text[],
-                                   size_t len)
+_discord_gateway_payload_load(struct discord_gateway_payload *payload,
+                              const char text[],
+                              size_t len,
+                              unsigned num_tokens)
 {
     payload->json.start = (char *)text;
     payload->json.size = len;
 
-    jsmn_parser parser;
-    jsmn_init(&parser);
-    if (jsmn_parse_auto(&parser, text, len, &payload->json.tokens,
-                        &payload->json.ntokens)
-        <= 0)
-        return false;
-
     jsmnf_loader loader;
     jsmnf_init(&loader);
-    if (jsmnf_load_auto(&loader, text, payload->json.tokens, parser.toknext,
+    if (jsmnf_load_auto(&loader, text, payload->json.tokens, num_tokens,
                         &payload->json.pairs, &payload->json.npairs)
         <= 0)
         return false;
 
     jsmnf_pair *f;
-    if ((f = jsmnf_find(payload->json.pairs, text, "t", 1))) {
-        if (JSMN_STRING == f->type)
-            snprintf(payload->name, sizeof(payload->name), "%.*s",
-                     (int)f->v.len, text + f->v.pos);
-        else
-            *payload->name = '\0';
-
-        payload->event = _discord_gateway_event_eval(payload->name);
-    }
+    if ((f = jsmnf_find(payload->json.pairs, text, "t", 1))
+        && JSMN_STRING == f->type)
+        payload->event =
+            discord_gateway_event_eval(text + f->v.pos, f->v.len);
+    else
+        payload->event = DISCORD_EV_NONE;
+    payload->name = _discord_gateway_event_print(payload->event);
     if ((f = jsmnf_find(payload->json.pairs, text, "s", 1))) {
         int seq = (int)strtol(text + f->v.pos, NULL, 10);
         if (seq) payload->seq = seq;
@@ -458,6 +578,23 @@ _discord_gateway_payload_from_json(struct discord_gateway_payload *payload,
     return true;
 }
 
+static bool
+_discord_gateway_payload_parse(struct discord_gateway *gw,
+                               const char text[],
+                               size_t len)
+{
+    struct discord_gateway_payload *payload = &gw->payload;
+
+    jsmn_parser parser;
+    jsmn_init(&parser);
+    if (jsmn_parse_fast(&parser, text, len, &payload->json.tokens,
+                        &payload->json.ntokens)
+        <= 0)
+        return false;
+
+    return _discord_gateway_payload_load(payload, text, len, parser.toknext);
+}
+
 static void
 _ws_on_text(void *p_gw,
             struct websockets *ws,
@@ -468,7 +605,12 @@ _ws_on_text(void *p_gw,
     (void)ws;
     struct discord_gateway *gw = p_gw;
 
-    if (!_discord_gateway_payload_from_json(&gw->payload, text, len)) {
+    if (gw->client->recorder.fp)
+        discord_recorder_append(&gw->client->recorder,
+                                gw->id.shard ? gw->id.shard->array[0] : 0,
+                                text, len);
+
+    if (!_discord_gateway_payload_parse(gw, text, len)) {
         logconf_fatal(&gw->conf, "Couldn't parse Gateway Payload");
         return;
     }
@@ -505,6 +647,131 @@ _ws_on_text(void *p_gw,
     }
 }
 
+bool
+discord_gateway_replay(struct discord_gateway *gw,
+                       const char text[],
+                       size_t len)
+{
+    if (!_discord_gateway_payload_parse(gw, text, len)) return false;
+
+    if (DISCORD_GATEWAY_DISPATCH == gw->payload.opcode && gw->payload.data) {
+        gw->client->shards.current =
+            gw->id.shard ? gw->id.shard->array[0] : 0;
+        _discord_gateway_schedule(gw);
+    }
+    return true;
+}
+
+#ifdef CCORD_ZLIB
+/* every zlib-stream payload is terminated by a Z_SYNC_FLUSH suffix */
+#define ZLIB_SUFFIX     "\x00\x00\xff\xff"
+#define ZLIB_SUFFIX_LEN (sizeof(ZLIB_SUFFIX) - 1)
+
+static bool
+_discord_zlib_has_suffix(const char *mem, size_t len)
+{
+    return len >= ZLIB_SUFFIX_LEN
+           && !memcmp(mem + len - ZLIB_SUFFIX_LEN, ZLIB_SUFFIX,
+                      ZLIB_SUFFIX_LEN);
+}
+
+static bool
+_discord_zlib_reserve(struct ccord_szbuf_reusable *buf, size_t size)
+{
+    if (size > buf->realsize) { /* buffer needs a resize */
+        size_t realsize = buf->realsize ? buf->realsize : 0x4000;
+        void *tmp;
+
+        while (realsize < size)
+            realsize <<= 1;
+        if (!(tmp = realloc(buf->start, realsize))) return false;
+
+        buf->start = tmp;
+        buf->realsize = realsize;
+    }
+    return true;
+}
+
+/* a zlib-stream can't recover from a payload it failed to take in, so the
+ *      session is resumed over a new connection (and a new stream) */
+static void
+_discord_zlib_fail(struct discord_gateway *gw)
+{
+    inflateReset(&gw->zlib->stream);
+    gw->zlib->in.size = 0;
+    discord_gateway_reconnect(gw, true);
+}
+
+static void
+_ws_on_binary(void *p_gw,
+              struct websockets *ws,
+              struct ws_info *info,
+              const void *mem,
+              size_t len)
+{
+    struct discord_gateway *gw = p_gw;
+    struct discord_gateway_zlib *zlib = gw->zlib;
+    const char *in = mem;
+    size_t in_len = len;
+    int ret;
+
+    /* the rest of the stream is dropped once the connection is closing */
+    if (gw->session->status & DISCORD_SESSION_SHUTDOWN) return;
+
+    /* a single payload may be split across several frames, accumulate until
+     *  the Z_SYNC_FLUSH suffix is found */
+    if (zlib->in.size || !_discord_zlib_has_suffix(in, in_len)) {
+        if (!_discord_zlib_reserve(&zlib->in, zlib->in.size + len)) {
+            logconf_fatal(&gw->conf, "Couldn't buffer compressed payload");
+            _discord_zlib_fail(gw);
+            return;
+        }
+        memcpy(zlib->in.start + zlib->in.size, mem, len);
+        zlib->in.size += len;
+
+        if (!_discord_zlib_has_suffix(zlib->in.start, zlib->in.size)) return;
+
+        in = zlib->in.start;
+        in_len = zlib->in.size;
+    }
+
+    const uint64_t tstart = cog_timestamp_us();
+
+    zlib->stream.next_in = (Bytef *)in;
+    zlib->stream.avail_in = (uInt)in_len;
+    zlib->out.size = 0;
+    do {
+        if (!_discord_zlib_reserve(&zlib->out, zlib->out.size + 1)) {
+            ret = Z_MEM_ERROR;
+            break;
+        }
+        zlib->stream.next_out = (Bytef *)zlib->out.start + zlib->out.size;
+        zlib->stream.avail_out = (uInt)(zlib->out.realsize - zlib->out.size);
+
+        ret = inflate(&zlib->stream, Z_SYNC_FLUSH);
+        zlib->out.size = zlib->out.realsize - zlib->stream.avail_out;
+        /* output buffer is full, there might be more left to inflate */
+    } while (Z_OK == ret && 0 == zlib->stream.avail_out);
+    zlib->in.size = 0;
+
+    if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        logconf_error(&gw->conf, "Couldn't inflate Gateway payload: %s",
+                      zlib->stream.msg ? zlib->stream.msg : "unknown error");
+        _discord_zlib_fail(gw);
+        return;
+    }
+
+    pthread_rwlock_wrlock(&zlib->rwlock);
+    ++zlib->stats.payloads;
+    zlib->stats.bytes_in += in_len;
+    zlib->stats.bytes_out += zlib->out.size;
+    zlib->stats.inflate_us += cog_timestamp_us() - tstart;
+    pthread_rwlock_unlock(&zlib->rwlock);
+
+    _ws_on_text(gw, ws, info, zlib->out.start, zlib->out.size);
+}
+#endif /* CCORD_ZLIB */
+
 static discord_event_scheduler_t
 _discord_on_scheduler_default(struct discord *a,
                               const char b[],
@@ -523,23 +790,46 @@ _discord_on_gateway_perform(struct io_poller *io, CURLM *mhandle, void *p_gw)
 {
     (void)io;
     (void)mhandle;
-    return discord_gateway_perform(p_gw);
+    struct discord_gateway *gw = p_gw;
+    struct discord *client = gw->client;
+    CCORDcode code;
+
+    /* shard isn't running */
+    if (!ws_is_alive(gw->ws)) return CCORD_OK;
+
+    if (CCORD_OK == (code = discord_gateway_perform(gw))) return CCORD_OK;
+
+    /* connection is over, each shard attempts to reconnect on its own
+     *  without blocking the others */
+    if (!discord_gateway_end(gw)) {
+        discord_gateway_restart(gw);
+        return CCORD_OK;
+    }
+
+    /* only report back once all of the client's shards are over */
+    client->shards.code = code;
+    return --client->shards.running ? CCORD_OK : code;
 }
 
 void
 discord_gateway_init(struct discord_gateway *gw,
+                     struct discord *client,
                      struct logconf *conf,
                      const char token[])
 {
-    struct discord *client = CLIENT(gw, gw);
     /* Web-Sockets callbacks */
     struct ws_callbacks cbs = { .data = gw,
                                 .on_connect = &_ws_on_connect,
                                 .on_text = &_ws_on_text,
+#ifdef CCORD_ZLIB
+                                .on_binary = &_ws_on_binary,
+#endif
                                 .on_close = &_ws_on_close };
     /* Web-Sockets custom attributes */
     struct ws_attr attr = { .conf = conf };
 
+    gw->client = client;
+
     /* Web-Sockets handler */
     gw->mhandle = curl_multi_init();
     io_poller_curlm_add(client->io_poller, gw->mhandle,
@@ -557,9 +847,24 @@ discord_gateway_init(struct discord_gateway *gw,
     /* default infinite retries TODO: configurable */
     gw->session->retry.limit = -1;
 
+    /* outbound commands rate limiting */
+    gw->outbound = calloc(1, sizeof *gw->outbound);
+    QUEUE_INIT(&gw->outbound->queue);
+    ASSERT_S(!pthread_mutex_init(&gw->outbound->lock, NULL),
+             "Couldn't initialize Gateway's outbound mutex");
+
     /* default callbacks */
     gw->scheduler = _discord_on_scheduler_default;
 
+#ifdef CCORD_ZLIB
+    /* zlib-stream transport compression */
+    gw->zlib = calloc(1, sizeof *gw->zlib);
+    ASSERT_S(Z_OK == inflateInit(&gw->zlib->stream),
+             "Couldn't initialize Gateway's zlib-stream context");
+    ASSERT_S(!pthread_rwlock_init(&gw->zlib->rwlock, NULL),
+             "Couldn't initialize Gateway's zlib-stream rwlock");
+#endif
+
     /* connection identify token */
     gw->id.token = (char *)token;
     /* connection identify properties */
@@ -579,13 +884,13 @@ void
 discord_gateway_cleanup(struct discord_gateway *gw)
 {
     if (gw->timer->hbeat_timer)
-        discord_internal_timer_ctl(CLIENT(gw, gw),
+        discord_internal_timer_ctl(gw->client,
                                    &(struct discord_timer){
                                        .id = gw->timer->hbeat_timer,
                                        .flags = DISCORD_TIMER_DELETE,
                                    });
     /* cleanup WebSockets handle */
-    io_poller_curlm_del(CLIENT(gw, gw)->io_poller, gw->mhandle);
+    io_poller_curlm_del(gw->client->io_poller, gw->mhandle);
     curl_multi_cleanup(gw->mhandle);
     ws_cleanup(gw->ws);
     /* cleanup timers */
@@ -594,10 +899,72 @@ discord_gateway_cleanup(struct discord_gateway *gw)
     /* cleanup bot identification */
     free(gw->id.properties);
     free(gw->id.presence);
+    if (gw->id.shard) {
+        free(gw->id.shard->array);
+        free(gw->id.shard);
+    }
     /* cleanup client session */
     free(gw->session);
+    /* cleanup outbound commands */
+    if (gw->outbound->timer)
+        discord_internal_timer_ctl(gw->client,
+                                   &(struct discord_timer){
+                                       .id = gw->outbound->timer,
+                                       .flags = DISCORD_TIMER_DELETE,
+                                   });
+    while (!QUEUE_EMPTY(&gw->outbound->queue)) {
+        QUEUE(struct discord_gateway_command) *qelem =
+            QUEUE_HEAD(&gw->outbound->queue);
+
+        QUEUE_REMOVE(qelem);
+        free(QUEUE_DATA(qelem, struct discord_gateway_command, entry));
+    }
+    pthread_mutex_destroy(&gw->outbound->lock);
+    free(gw->outbound);
     if (gw->payload.json.pairs) free(gw->payload.json.pairs);
     if (gw->payload.json.tokens) free(gw->payload.json.tokens);
+#ifdef CCORD_ZLIB
+    /* cleanup zlib-stream context */
+    inflateEnd(&gw->zlib->stream);
+    pthread_rwlock_destroy(&gw->zlib->rwlock);
+    if (gw->zlib->in.start) free(gw->zlib->in.start);
+    if (gw->zlib->out.start) free(gw->zlib->out.start);
+    free(gw->zlib);
+#endif
+}
+
+void
+discord_gateway_set_shard(struct discord_gateway *gw,
+                          int shard_id,
+                          int total_shards)
+{
+    if (!gw->id.shard) {
+        gw->id.shard = calloc(1, sizeof *gw->id.shard);
+        gw->id.shard->array = calloc(2, sizeof *gw->id.shard->array);
+        gw->id.shard->size = gw->id.shard->realsize = 2;
+    }
+    gw->id.shard->array[0] = shard_id;
+    gw->id.shard->array[1] = total_shards;
+
+    logconf_info(&gw->conf, "Assigned to shard [%d, %d]", shard_id,
+                 total_shards);
+}
+
+struct discord_gateway *
+discord_gateway_get_shard(struct discord *client, u64snowflake guild_id)
+{
+    const int shard_id =
+        (int)((guild_id >> 22) % (unsigned)client->shards.total);
+    const int index = shard_id - client->shards.first;
+
+    if (index < 0 || index >= client->shards.count) {
+        logconf_warn(&client->gw.conf,
+                     "Guild %" PRIu64 " belongs to shard %d, which isn't "
+                     "handled by this client",
+                     guild_id, shard_id);
+        return &client->gw;
+    }
+    return SHARD(client, index);
 }
 
 #ifdef CCORD_DEBUG_WEBSOCKETS
@@ -724,30 +1091,10 @@ _discord_gateway_session_from_json(struct discord_gateway_session *session,
     return true;
 }
 
-CCORDcode
-discord_gateway_start(struct discord_gateway *gw)
+/* connect to the Gateway with the session information already fetched */
+static CCORDcode
+_discord_gateway_connect(struct discord_gateway *gw)
 {
-    struct ccord_szbuf json = { 0 };
-
-    if (gw->session->retry.attempt == gw->session->retry.limit) {
-        logconf_fatal(&gw->conf,
-                      "Failed reconnecting to Discord after %d tries",
-                      gw->session->retry.limit);
-
-        return CCORD_DISCORD_CONNECTION;
-    }
-
-    if (discord_get_gateway_bot(CLIENT(gw, gw), &json) != CCORD_OK
-        || !_discord_gateway_session_from_json(gw->session, json.start,
-                                               json.size))
-    {
-        logconf_fatal(&gw->conf, "Couldn't retrieve Gateway Bot information");
-        free(json.start);
-
-        return CCORD_DISCORD_BAD_AUTH;
-    }
-    free(json.start);
-
     if (!gw->session->start_limit.remaining) {
         logconf_fatal(&gw->conf,
                       "Reach sessions threshold (%d),"
@@ -762,12 +1109,22 @@ discord_gateway_start(struct discord_gateway *gw)
         && *gw->session->resume_url)
     {
         ws_set_url(gw->ws, gw->session->resume_url, NULL);
-        *gw->session->resume_url = '\0';
     }
     else {
         ws_set_url(gw->ws, gw->session->base_url, NULL);
     }
 
+    /* each connection has its own send rate limit window */
+    pthread_mutex_lock(&gw->outbound->lock);
+    gw->outbound->reset_at = 0;
+    pthread_mutex_unlock(&gw->outbound->lock);
+
+#ifdef CCORD_ZLIB
+    /* each connection starts a new zlib-stream */
+    inflateReset(&gw->zlib->stream);
+    gw->zlib->in.size = 0;
+#endif
+
 #ifndef CCORD_DEBUG_WEBSOCKETS
     ws_start(gw->ws);
 #else
@@ -779,6 +1136,169 @@ discord_gateway_start(struct discord_gateway *gw)
     return CCORD_OK;
 }
 
+CCORDcode
+discord_gateway_start(struct discord_gateway *gw,
+                      const struct discord_gateway *peer)
+{
+    struct ccord_szbuf json = { 0 };
+
+    if (gw->session->retry.attempt == gw->session->retry.limit) {
+        logconf_fatal(&gw->conf,
+                      "Failed reconnecting to Discord after %d tries",
+                      gw->session->retry.limit);
+
+        return CCORD_DISCORD_CONNECTION;
+    }
+
+    if (peer) {
+        memcpy(gw->session->base_url, peer->session->base_url,
+               sizeof(gw->session->base_url));
+        gw->session->shards = peer->session->shards;
+        gw->session->start_limit = peer->session->start_limit;
+    }
+    else if (discord_get_gateway_bot(gw->client, &json) != CCORD_OK
+             || !_discord_gateway_session_from_json(gw->session, json.start,
+                                                    json.size))
+    {
+        logconf_fatal(&gw->conf, "Couldn't retrieve Gateway Bot information");
+        free(json.start);
+
+        return CCORD_DISCORD_BAD_AUTH;
+    }
+    free(json.start);
+
+    return _discord_gateway_connect(gw);
+}
+
+/* longest wait in between a shard's restart attempts */
+#define RESTART_BACKOFF_MAX_MS 60000
+
+static void
+_discord_gateway_on_restart_timer(struct discord *client,
+                                  struct discord_timer *timer)
+{
+    (void)client;
+    if (timer->flags & DISCORD_TIMER_CANCELED) return;
+
+    discord_gateway_restart(timer->data);
+}
+
+/* schedule another restart attempt, or stop the shard if it's over */
+static void
+_discord_gateway_restart_retry(struct discord_gateway *gw, CCORDcode code)
+{
+    struct discord *client = gw->client;
+    int64_t delay;
+
+    if (!gw->session->retry.enable
+        || gw->session->retry.attempt >= gw->session->retry.limit)
+    {
+        if (gw->session->retry.enable)
+            logconf_fatal(&gw->conf,
+                          "Failed reconnecting to Discord after %d tries",
+                          gw->session->retry.limit);
+        gw->session->retry.attempt = 0;
+
+        client->shards.code = code;
+        --client->shards.running;
+        return;
+    }
+
+    ++gw->session->retry.attempt;
+    if (CCORD_DISCORD_RATELIMIT == code)
+        delay = gw->session->start_limit.reset_after;
+    else if (gw->session->retry.attempt > 6)
+        delay = RESTART_BACKOFF_MAX_MS;
+    else
+        delay = 1000LL << (gw->session->retry.attempt - 1);
+
+    logconf_info(&gw->conf, "Reconnect attempt #%d in %" PRId64 "ms",
+                 gw->session->retry.attempt, delay);
+
+    discord_internal_timer(client, &_discord_gateway_on_restart_timer, NULL,
+                           gw, delay);
+}
+
+static size_t
+_discord_gateway_bot_from_json(const char str[], size_t len, void *p_json)
+{
+    struct ccord_szbuf *json = p_json;
+    return json->size = cog_strndup(str, len, &json->start);
+}
+
+static void
+_discord_gateway_bot_cleanup(void *p_json)
+{
+    struct ccord_szbuf *json = p_json;
+    free(json->start);
+}
+
+static void
+_discord_gateway_on_bot_done(struct discord *client,
+                             struct discord_response *resp,
+                             const void *p_json)
+{
+    struct discord_gateway *gw = resp->data;
+    const struct ccord_szbuf *json = p_json;
+    CCORDcode code;
+    (void)client;
+
+    /* shutdown while waiting for the response */
+    if (!gw->session->retry.enable) {
+        _discord_gateway_restart_retry(gw, CCORD_DISCORD_CONNECTION);
+        return;
+    }
+
+    if (!_discord_gateway_session_from_json(gw->session, json->start,
+                                            json->size))
+    {
+        logconf_error(&gw->conf, "Couldn't retrieve Gateway Bot information");
+        code = CCORD_DISCORD_BAD_AUTH;
+    }
+    else {
+        code = _discord_gateway_connect(gw);
+    }
+
+    if (code != CCORD_OK) _discord_gateway_restart_retry(gw, code);
+}
+
+static void
+_discord_gateway_on_bot_fail(struct discord *client,
+                             struct discord_response *resp)
+{
+    (void)client;
+    logconf_error(&((struct discord_gateway *)resp->data)->conf,
+                  "Couldn't retrieve Gateway Bot information");
+    _discord_gateway_restart_retry(resp->data, resp->code);
+}
+
+void
+discord_gateway_restart(struct discord_gateway *gw)
+{
+    struct discord_attributes attr = { 0 };
+
+    /* shutdown while waiting for the next attempt */
+    if (!gw->session->retry.enable) {
+        _discord_gateway_restart_retry(gw, CCORD_DISCORD_CONNECTION);
+        return;
+    }
+
+    attr.response.size = sizeof(struct ccord_szbuf);
+    attr.response.from_json = &_discord_gateway_bot_from_json;
+    attr.response.cleanup = &_discord_gateway_bot_cleanup;
+    attr.dispatch.has_type = true;
+    attr.dispatch.done.typed = &_discord_gateway_on_bot_done;
+    attr.dispatch.fail = &_discord_gateway_on_bot_fail;
+    attr.dispatch.data = gw;
+
+    if (CCORD_OK
+        != discord_rest_run(&gw->client->rest, &attr, NULL, HTTP_GET,
+                            "/gateway/bot"))
+    {
+        _discord_gateway_restart_retry(gw, CCORD_DISCORD_CONNECTION);
+    }
+}
+
 bool
 discord_gateway_end(struct discord_gateway *gw)
 {
@@ -787,12 +1307,14 @@ discord_gateway_end(struct discord_gateway *gw)
     /* keep only resumable information */
     gw->session->status &= DISCORD_SESSION_RESUMABLE;
     gw->session->is_ready = false;
+    gw->session->identify_queued = false;
 
     if (!gw->session->retry.enable) {
         logconf_warn(&gw->conf, "Discord Gateway Shutdown");
 
-        /* reset for next run */
-        gw->session->status = DISCORD_SESSION_OFFLINE;
+        /* reset for next run, sessions kept open by discord_shutdown() may
+         *  still be resumed */
+        gw->session->status &= DISCORD_SESSION_RESUMABLE;
         gw->session->is_ready = false;
         gw->session->retry.enable = false;
         gw->session->retry.attempt = 0;
@@ -822,12 +1344,78 @@ discord_gateway_shutdown(struct discord_gateway *gw)
 {
     const char reason[] = "Client triggered shutdown";
 
+    enum ws_close_reason opcode = WS_CLOSE_REASON_NORMAL;
+
     /* TODO: MT-Unsafe section */
     gw->session->retry.enable = false;
     gw->session->status = DISCORD_SESSION_SHUTDOWN;
+    /* a normal closure would invalidate the session */
+    if (gw->client->session_file && *gw->session->id) {
+        gw->session->status |= DISCORD_SESSION_RESUMABLE;
+        opcode = (enum ws_close_reason)DISCORD_GATEWAY_CLOSE_REASON_RECONNECT;
+    }
+
+    ws_close(gw->ws, opcode, reason, sizeof(reason));
+    io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
+}
+
+jsonbcode
+discord_gateway_session_save(struct discord_gateway *gw,
+                             jsonb *b,
+                             char buf[],
+                             size_t bufsize)
+{
+    const int shard_id = gw->id.shard ? gw->id.shard->array[0] : 0;
+    jsonbcode code;
 
-    ws_close(gw->ws, WS_CLOSE_REASON_NORMAL, reason, sizeof(reason));
-    io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+    if (!(gw->session->status & DISCORD_SESSION_RESUMABLE)
+        || !*gw->session->id)
+    {
+        return JSONB_OK;
+    }
+
+    if (0 > (code = jsonb_object(b, buf, bufsize))) return code;
+    if (0 > (code = jsonb_key(b, buf, bufsize, "shard", 5))) return code;
+    if (0 > (code = jsonb_number(b, buf, bufsize, shard_id))) return code;
+    if (0 > (code = jsonb_key(b, buf, bufsize, "session_id", 10)))
+        return code;
+    if (0 > (code = jsonb_string(b, buf, bufsize, gw->session->id,
+                                 strlen(gw->session->id))))
+        return code;
+    if (0 > (code = jsonb_key(b, buf, bufsize, "seq", 3))) return code;
+    if (0 > (code = jsonb_number(b, buf, bufsize, gw->payload.seq)))
+        return code;
+    if (*gw->session->resume_url) {
+        if (0 > (code = jsonb_key(b, buf, bufsize, "resume_url", 10)))
+            return code;
+        if (0 > (code = jsonb_string(b, buf, bufsize, gw->session->resume_url,
+                                     strlen(gw->session->resume_url))))
+            return code;
+    }
+    return jsonb_object_pop(b, buf, bufsize);
+}
+
+void
+discord_gateway_session_load(struct discord_gateway *gw,
+                             jsmnf_pair *f,
+                             const char js[])
+{
+    jsmnf_pair *session_id = jsmnf_find(f, js, "session_id", 10),
+               *seq = jsmnf_find(f, js, "seq", 3),
+               *resume_url = jsmnf_find(f, js, "resume_url", 10);
+
+    if (!session_id || !seq || !session_id->v.len) return;
+
+    snprintf(gw->session->id, sizeof(gw->session->id), "%.*s",
+             (int)session_id->v.len, js + session_id->v.pos);
+    gw->payload.seq = (int)strtol(js + seq->v.pos, NULL, 10);
+    if (resume_url)
+        snprintf(gw->session->resume_url, sizeof(gw->session->resume_url),
+                 "%.*s", (int)resume_url->v.len, js + resume_url->v.pos);
+    gw->session->status |= DISCORD_SESSION_RESUMABLE;
+
+    logconf_info(&gw->conf, "Loaded session %s (seq: %d)", gw->session->id,
+                 gw->payload.seq);
 }
 
 void
@@ -848,5 +1436,5 @@ discord_gateway_reconnect(struct discord_gateway *gw, bool resume)
     }
 
     ws_close(gw->ws, opcode, reason, sizeof(reason));
-    io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+    io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
 }
@@ -1,25 +1,97 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <pthread.h>
 
 #include "discord.h"
 #include "discord-internal.h"
 
+/* call a view callback with a `struct <type>_view` over the event */
+#define VIEW(type)                                                            \
+    static void _discord_view_##type(discord_ev_event cb,                     \
+                                     struct discord *client,                  \
+                                     jsmnf_pair *root, const char *js)        \
+    {                                                                         \
+        const struct type##_view view = type##_view_of(root, js);             \
+                                                                              \
+        ((void (*)(struct discord *, const struct type##_view *))cb)(client,  \
+                                                                    &view);   \
+    }
+
+VIEW(discord_application_command_permissions)
+VIEW(discord_auto_moderation_action_execution)
+VIEW(discord_auto_moderation_rule)
+VIEW(discord_channel)
+VIEW(discord_channel_pins_update)
+VIEW(discord_guild)
+VIEW(discord_guild_ban_add)
+VIEW(discord_guild_ban_remove)
+VIEW(discord_guild_emojis_update)
+VIEW(discord_guild_integrations_update)
+VIEW(discord_guild_member)
+VIEW(discord_guild_member_remove)
+VIEW(discord_guild_member_update)
+VIEW(discord_guild_members_chunk)
+VIEW(discord_guild_role_create)
+VIEW(discord_guild_role_delete)
+VIEW(discord_guild_role_update)
+VIEW(discord_guild_scheduled_event)
+VIEW(discord_guild_scheduled_event_user_add)
+VIEW(discord_guild_scheduled_event_user_remove)
+VIEW(discord_guild_stickers_update)
+VIEW(discord_integration)
+VIEW(discord_integration_delete)
+VIEW(discord_interaction)
+VIEW(discord_invite_create)
+VIEW(discord_invite_delete)
+VIEW(discord_message)
+VIEW(discord_message_delete)
+VIEW(discord_message_delete_bulk)
+VIEW(discord_message_reaction_add)
+VIEW(discord_message_reaction_remove)
+VIEW(discord_message_reaction_remove_all)
+VIEW(discord_message_reaction_remove_emoji)
+VIEW(discord_presence_update)
+VIEW(discord_ready)
+VIEW(discord_stage_instance)
+VIEW(discord_thread_list_sync)
+VIEW(discord_thread_member)
+VIEW(discord_thread_members_update)
+VIEW(discord_typing_start)
+VIEW(discord_user)
+VIEW(discord_voice_server_update)
+VIEW(discord_voice_state)
+VIEW(discord_webhooks_update)
+
+#undef VIEW
+
 #define INIT(type)                                                            \
     {                                                                         \
         sizeof(struct type),                                                  \
-            (size_t(*)(jsmnf_pair *, const char *, void *))type##_from_jsmnf, \
-            (void (*)(void *))type##_cleanup                                  \
+            (long (*)(jsmnf_pair *, const char *, void *, const void *,       \
+                      struct ccord_arena *))type##_from_jsmnf_masked,         \
+            &_discord_view_##type                                             \
     }
 
 /** @brief Information for deserializing a Discord event */
 static const struct {
     /** size of event's datatype */
     size_t size;
-    /** event's payload deserializer */
-    size_t (*from_jsmnf)(jsmnf_pair *, const char *, void *);
-    /** event's cleanup */
-    void (*cleanup)(void *);
+    /**
+     * event's payload deserializer, its fields are taken from the arena and
+     *      limited to the ones set at its `struct <type>_mask`, if any
+     */
+    long (*from_jsmnf_masked)(jsmnf_pair *,
+                              const char *,
+                              void *,
+                              const void *,
+                              struct ccord_arena *);
+    /** calls the event's view callback with its `struct <type>_view` */
+    void (*view)(discord_ev_event cb,
+                 struct discord *client,
+                 jsmnf_pair *root,
+                 const char *js);
 } dispatch[] = {
     [DISCORD_EV_READY] = INIT(discord_ready),
     [DISCORD_EV_APPLICATION_COMMAND_PERMISSIONS_UPDATE] =
@@ -96,35 +168,86 @@ static const struct {
     [DISCORD_EV_WEBHOOKS_UPDATE] = INIT(discord_webhooks_update),
 };
 
+/** @brief A decoded event and the arena its fields have been taken from */
+struct _discord_event_arena {
+    /** the arena holding this struct, the event and its fields */
+    struct ccord_arena arena;
+    /** the event datatype */
+    union {
+        void *p;
+        uint64_t u;
+        long double ld;
+    } data[];
+};
+
+static void
+_discord_event_arena_cleanup(void *data)
+{
+    struct _discord_event_arena *ea =
+        CONTAINEROF(data, struct _discord_event_arena, data);
+    /* the arena block holds `ea` itself */
+    struct ccord_arena arena = ea->arena;
+
+    cog_arena_cleanup(&arena);
+}
+
+/* decode the event into a single arena, released with its last reference */
+static void *
+_discord_event_arena_decode(struct discord_gateway_payload *payload,
+                            const void *mask)
+{
+    const size_t size = dispatch[payload->event].size;
+    struct _discord_event_arena *ea;
+    struct ccord_arena arena;
+
+    /* fields rarely take more than twice the size of their JSON */
+    cog_arena_init(&arena,
+                   sizeof *ea + size + 2 * (size_t)payload->data->v.len);
+    ea = cog_arena_alloc(&arena, sizeof *ea + size);
+    ASSERT_S(ea != NULL, "Out of memory");
+
+    dispatch[payload->event].from_jsmnf_masked(
+        payload->data, payload->json.start, ea->data, mask, &arena);
+    ea->arena = arena;
+
+    return ea->data;
+}
+
 void
-discord_gateway_dispatch(struct discord_gateway *gw)
+discord_gateway_dispatch(struct discord_gateway *gw,
+                         struct discord_gateway_payload *payload)
 {
-    const enum discord_gateway_events event = gw->payload.event;
-    struct discord *client = CLIENT(gw, gw);
+    const enum discord_gateway_events event = payload->event;
+    struct discord *client = gw->client;
+    /* every shard shares the tables set at the client's first shard */
+    const struct discord_gateway *first = &client->gw;
 
     switch (event) {
     case DISCORD_EV_MESSAGE_CREATE:
         if (discord_message_commands_try_perform(&client->commands,
-                                                 &gw->payload)) {
+                                                 payload)) {
             return;
         }
     /* fall-through */
     default:
-        if (gw->cbs[0][event] || gw->cbs[1][event]) {
-            void *event_data = calloc(1, dispatch[event].size);
-
-            dispatch[event].from_jsmnf(gw->payload.data,
-                                       gw->payload.json.start, event_data);
+        if (first->views[event])
+            dispatch[event].view(first->views[event], client, payload->data,
+                                 payload->json.start);
+        if (first->cbs[0][event] || first->cbs[1][event]) {
+            /* the cache expects every field to be decoded */
+            void *event_data = _discord_event_arena_decode(
+                payload, first->cbs[0][event] ? NULL : first->masks[event]);
 
             if (CCORD_UNAVAILABLE
                 == discord_refcounter_incr(&client->refcounter, event_data))
             {
                 discord_refcounter_add_internal(&client->refcounter,
                                                 event_data,
-                                                dispatch[event].cleanup, true);
+                                                &_discord_event_arena_cleanup,
+                                                false);
             }
-            if (gw->cbs[0][event]) gw->cbs[0][event](client, event_data);
-            if (gw->cbs[1][event]) gw->cbs[1][event](client, event_data);
+            if (first->cbs[0][event]) first->cbs[0][event](client, event_data);
+            if (first->cbs[1][event]) first->cbs[1][event](client, event_data);
             discord_refcounter_decr(&client->refcounter, event_data);
         }
         break;
@@ -136,6 +259,250 @@ discord_gateway_dispatch(struct discord_gateway *gw)
     }
 }
 
+struct discord_gateway_event *
+discord_gateway_event_init(struct discord_gateway *gw)
+{
+    const jsmnf_pair *data = gw->payload.data;
+    struct discord_gateway_event *event =
+        malloc(sizeof *event + (size_t)data->v.len + 1);
+
+    ASSERT_S(event != NULL, "Out of memory");
+    event->gw = gw;
+    event->shard_id = gw->id.shard ? gw->id.shard->array[0] : 0;
+    event->name = gw->payload.name;
+    event->event = gw->payload.event;
+    event->size = (size_t)data->v.len;
+    memcpy(event->json, gw->payload.json.start + data->v.pos, event->size);
+    event->json[event->size] = '\0';
+
+    discord_refcounter_add_internal(&gw->client->refcounter, event, NULL,
+                                    true);
+
+    return event;
+}
+
+/* the shard of the event being dispatched by each worker thread, the
+ *  client's `shards.current` is overwritten by the main thread */
+static pthread_key_t shard_key;
+static pthread_once_t shard_key_once = PTHREAD_ONCE_INIT;
+
+static void
+_discord_shard_key_init(void)
+{
+    ASSERT_S(0 == pthread_key_create(&shard_key, NULL),
+             "Couldn't create the shard id key");
+}
+
+int
+discord_gateway_event_shard_id(void)
+{
+    pthread_once(&shard_key_once, &_discord_shard_key_init);
+    /* stored as `shard_id + 1`, so that NULL means 'no event' */
+    return (int)(intptr_t)pthread_getspecific(shard_key) - 1;
+}
+
+void
+discord_gateway_event_dispatch(struct discord_gateway_event *event)
+{
+    struct discord *client = event->gw->client;
+    struct discord_gateway_payload payload = { 0 };
+    jsmn_parser parser;
+    void *prev_shard;
+
+    pthread_once(&shard_key_once, &_discord_shard_key_init);
+    prev_shard = pthread_getspecific(shard_key);
+    pthread_setspecific(shard_key, (void *)(intptr_t)(event->shard_id + 1));
+
+    /* the shard's tokens and pairs belong to whatever event it is currently
+     *      reading, parse our own copy */
+    jsmn_init(&parser);
+    if (jsmn_parse_fast(&parser, event->json, event->size,
+                        &payload.json.tokens, &payload.json.ntokens)
+        <= 0)
+    {
+        logconf_error(&event->gw->conf, "Couldn't parse %s payload",
+                      event->name);
+    }
+    else {
+        jsmnf_loader loader;
+
+        jsmnf_init(&loader);
+        if (jsmnf_load_auto(&loader, event->json, payload.json.tokens,
+                            parser.toknext, &payload.json.pairs,
+                            &payload.json.npairs)
+            <= 0)
+        {
+            logconf_error(&event->gw->conf, "Couldn't parse %s payload",
+                          event->name);
+        }
+        else {
+            payload.json.start = event->json;
+            payload.json.size = event->size;
+            payload.name = event->name;
+            payload.event = event->event;
+            payload.data = payload.json.pairs;
+
+            discord_gateway_dispatch(event->gw, &payload);
+        }
+    }
+
+    pthread_setspecific(shard_key, prev_shard);
+
+    free(payload.json.pairs);
+    free(payload.json.tokens);
+    discord_refcounter_decr(&client->refcounter, event);
+}
+
+/* Discord allows 120 commands per connection every 60 seconds */
+#define SEND_LIMIT     120
+#define SEND_WINDOW_MS 60000
+/* part of the budget kept for heartbeats, identifies and resumes */
+#define SEND_RESERVED 5
+/* retry interval for commands queued while the session isn't ready */
+#define SEND_RETRY_MS 1000
+
+/* take a command from the current window, `reserved` commands may use the
+ *      reserved budget and are never refused
+ * @note must be called with `gw->outbound->lock` held */
+static bool
+_discord_gateway_outbound_take(struct discord_gateway *gw, bool reserved)
+{
+    struct discord_gateway_outbound *outbound = gw->outbound;
+    const u64unix_ms now = discord_timestamp(gw->client);
+
+    if (now >= outbound->reset_at) {
+        outbound->remaining = SEND_LIMIT;
+        outbound->reset_at = now + SEND_WINDOW_MS;
+    }
+    if (reserved) {
+        if (outbound->remaining > 0)
+            --outbound->remaining;
+        else
+            logconf_warn(&gw->conf, "Send rate limit has been exhausted");
+        return true;
+    }
+    if (outbound->remaining <= SEND_RESERVED) return false;
+
+    --outbound->remaining;
+    return true;
+}
+
+static void
+_discord_on_outbound_queue(struct discord *client, struct discord_timer *timer)
+{
+    struct discord_gateway *gw = timer->data;
+    struct discord_gateway_outbound *outbound = gw->outbound;
+    int64_t wait;
+
+    pthread_mutex_lock(&outbound->lock);
+    while (gw->session->is_ready && !QUEUE_EMPTY(&outbound->queue)
+           && _discord_gateway_outbound_take(gw, false))
+    {
+        QUEUE(struct discord_gateway_command) *qelem =
+            QUEUE_HEAD(&outbound->queue);
+        struct discord_gateway_command *cmd =
+            QUEUE_DATA(qelem, struct discord_gateway_command, entry);
+        struct ws_info info = { 0 };
+
+        QUEUE_REMOVE(qelem);
+        if (cmd == outbound->presence) outbound->presence = NULL;
+
+        if (ws_send_text(gw->ws, &info, cmd->text, cmd->size)) {
+            io_poller_curlm_enable_perform(client->io_poller, gw->mhandle);
+            logconf_info(
+                &gw->conf,
+                ANSICOLOR("SEND", ANSI_FG_BRIGHT_GREEN) " %s (%zu bytes, "
+                                                        "queued) "
+                                                        "[@@@_%zu_@@@]",
+                cmd->name, cmd->size, info.loginfo.counter + 1);
+        }
+        else {
+            logconf_error(
+                &gw->conf,
+                ANSICOLOR("FAIL SEND", ANSI_FG_RED) " %s (%zu bytes, "
+                                                    "queued) [@@@_%zu_@@@]",
+                cmd->name, cmd->size, info.loginfo.counter + 1);
+        }
+        free(cmd);
+    }
+
+    if (QUEUE_EMPTY(&outbound->queue)) {
+        outbound->timer = 0;
+        pthread_mutex_unlock(&outbound->lock);
+        return;
+    }
+    wait = gw->session->is_ready
+               ? (int64_t)(outbound->reset_at - discord_timestamp(client))
+               : SEND_RETRY_MS;
+    pthread_mutex_unlock(&outbound->lock);
+
+    timer->interval = wait < 1 ? 1 : wait;
+    timer->repeat = 1;
+}
+
+/* return true if the command may be sent right away, otherwise it's queued
+ *      until the send rate limit allows it */
+static bool
+_discord_gateway_outbound_check(struct discord_gateway *gw,
+                                enum discord_gateway_opcodes opcode,
+                                const char name[],
+                                const char text[],
+                                size_t size)
+{
+    struct discord_gateway_outbound *outbound = gw->outbound;
+    struct discord_gateway_command *cmd;
+
+    pthread_mutex_lock(&outbound->lock);
+    switch (opcode) {
+    case DISCORD_GATEWAY_HEARTBEAT:
+    case DISCORD_GATEWAY_IDENTIFY:
+    case DISCORD_GATEWAY_RESUME:
+        _discord_gateway_outbound_take(gw, true);
+        pthread_mutex_unlock(&outbound->lock);
+        return true;
+    default:
+        /* keep commands in order */
+        if (QUEUE_EMPTY(&outbound->queue)
+            && _discord_gateway_outbound_take(gw, false))
+        {
+            pthread_mutex_unlock(&outbound->lock);
+            return true;
+        }
+        break;
+    }
+
+    cmd = malloc(sizeof *cmd + size);
+    ASSERT_S(cmd != NULL, "Out of memory");
+    cmd->opcode = opcode;
+    cmd->name = name;
+    cmd->size = size;
+    memcpy(cmd->text, text, size);
+
+    /* only the latest presence matters */
+    if (DISCORD_GATEWAY_PRESENCE_UPDATE == opcode) {
+        if (outbound->presence) {
+            QUEUE_REMOVE(&outbound->presence->entry);
+            free(outbound->presence);
+        }
+        outbound->presence = cmd;
+    }
+    QUEUE_INSERT_TAIL(&outbound->queue, &cmd->entry);
+
+    logconf_info(&gw->conf, "%s queued by the send rate limit", name);
+
+    if (!outbound->timer) {
+        const int64_t wait =
+            (int64_t)(outbound->reset_at - discord_timestamp(gw->client));
+
+        outbound->timer = discord_internal_timer(
+            gw->client, _discord_on_outbound_queue, NULL, gw,
+            wait < 1 ? 1 : wait);
+    }
+    pthread_mutex_unlock(&outbound->lock);
+
+    return false;
+}
+
 void
 discord_gateway_send_identify(struct discord_gateway *gw,
                               struct discord_identify *identify)
@@ -144,18 +511,6 @@ discord_gateway_send_identify(struct discord_gateway *gw,
     char buf[1024];
     jsonb b;
 
-    /* Ratelimit check */
-    if (gw->timer->now - gw->timer->identify_last < 5) {
-        ++gw->session->concurrent;
-        VASSERT_S(gw->session->concurrent
-                      < gw->session->start_limit.max_concurrency,
-                  "Reach identify request threshold (%d every 5 seconds)",
-                  gw->session->start_limit.max_concurrency);
-    }
-    else {
-        gw->session->concurrent = 0;
-    }
-
     jsonb_init(&b);
     jsonb_object(&b, buf, sizeof(buf));
     {
@@ -166,8 +521,12 @@ discord_gateway_send_identify(struct discord_gateway *gw,
         jsonb_object_pop(&b, buf, sizeof(buf));
     }
 
+    if (!_discord_gateway_outbound_check(gw, DISCORD_GATEWAY_IDENTIFY,
+                                         "IDENTIFY", buf, (size_t)b.pos))
+        return;
+
     if (ws_send_text(gw->ws, &info, buf, b.pos)) {
-        io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+        io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
         logconf_info(
             &gw->conf,
             ANSICOLOR(
@@ -187,6 +546,121 @@ discord_gateway_send_identify(struct discord_gateway *gw,
     }
 }
 
+/* identify a shard with the intents and presence set at the client's first
+ *  shard */
+static void
+_discord_gateway_identify(struct discord_gateway *gw)
+{
+    struct discord_identify id = gw->id;
+
+    id.intents = gw->client->gw.id.intents;
+    id.presence = gw->client->gw.id.presence;
+    discord_gateway_send_identify(gw, &id);
+}
+
+/* Discord allows a single identify per rate limit bucket every 5 seconds */
+#define IDENTIFY_INTERVAL_MS 5000
+
+/* send as many queued identifies as the rate limit allows, return the
+ *  amount of milliseconds until the next one can go through, or -1 if the
+ *  queue has been emptied */
+static int64_t
+_discord_identify_queue_run(struct discord *client)
+{
+    struct discord_session_start_limit *limit =
+        &client->shards.identify.limit;
+    const u64unix_ms now = discord_timestamp(client);
+    int64_t wait = -1;
+
+    if (limit->remaining <= 0 && now >= client->shards.identify.reset_at)
+        limit->remaining = limit->total;
+
+    for (int i = 0; i < client->shards.count; ++i) {
+        struct discord_gateway *gw = SHARD(client, i);
+        int64_t delay;
+
+        if (!gw->session->identify_queued) continue;
+
+        if (limit->remaining <= 0) {
+            delay = (int64_t)(client->shards.identify.reset_at - now);
+        }
+        else {
+            const int shard_id = gw->id.shard ? gw->id.shard->array[0] : 0;
+            u64unix_ms *bucket =
+                &client->shards.identify.buckets[shard_id
+                                                 % limit->max_concurrency];
+
+            if (*bucket + IDENTIFY_INTERVAL_MS <= now) {
+                gw->session->identify_queued = false;
+                *bucket = now;
+                --limit->remaining;
+
+                _discord_gateway_identify(gw);
+                continue;
+            }
+            delay = (int64_t)(*bucket + IDENTIFY_INTERVAL_MS - now);
+        }
+        if (wait < 0 || delay < wait) wait = delay;
+    }
+    return wait;
+}
+
+static void
+_discord_on_identify_queue(struct discord *client, struct discord_timer *timer)
+{
+    const int64_t wait = _discord_identify_queue_run(client);
+
+    if (wait < 0) {
+        client->shards.identify.timer = 0;
+        return;
+    }
+    timer->interval = wait < 1 ? 1 : wait;
+    timer->repeat = 1;
+}
+
+void
+discord_gateway_queue_identify(struct discord_gateway *gw)
+{
+    struct discord *client = gw->client;
+    struct discord_session_start_limit *limit =
+        &client->shards.identify.limit;
+    const u64unix_ms now = discord_timestamp(client);
+    int64_t wait;
+
+    /* (re)load limits from the latest '/gateway/bot' fetch */
+    if (!client->shards.identify.buckets
+        || now >= client->shards.identify.reset_at)
+    {
+        const int max_concurrency =
+            gw->session->start_limit.max_concurrency > 0
+                ? gw->session->start_limit.max_concurrency
+                : 1;
+
+        if (max_concurrency != limit->max_concurrency) {
+            free(client->shards.identify.buckets);
+            client->shards.identify.buckets =
+                calloc((size_t)max_concurrency,
+                       sizeof *client->shards.identify.buckets);
+        }
+        *limit = gw->session->start_limit;
+        limit->max_concurrency = max_concurrency;
+        client->shards.identify.reset_at =
+            now + (u64unix_ms)limit->reset_after;
+    }
+
+    gw->session->identify_queued = true;
+    logconf_info(&gw->conf, "IDENTIFY queued (rate limit key: %d)",
+                 (gw->id.shard ? gw->id.shard->array[0] : 0)
+                     % limit->max_concurrency);
+
+    if ((wait = _discord_identify_queue_run(client)) >= 0
+        && !client->shards.identify.timer)
+    {
+        client->shards.identify.timer = discord_internal_timer(
+            client, _discord_on_identify_queue, NULL, NULL, wait);
+    }
+}
+
 void
 discord_gateway_send_resume(struct discord_gateway *gw,
                             struct discord_resume *event)
@@ -208,8 +682,12 @@ discord_gateway_send_resume(struct discord_gateway *gw,
         jsonb_object_pop(&b, buf, sizeof(buf));
     }
 
+    if (!_discord_gateway_outbound_check(gw, DISCORD_GATEWAY_RESUME, "RESUME",
+                                         buf, (size_t)b.pos))
+        return;
+
     if (ws_send_text(gw->ws, &info, buf, b.pos)) {
-        io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+        io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
         logconf_info(
             &gw->conf,
             ANSICOLOR("SEND",
@@ -231,9 +709,11 @@ _discord_on_heartbeat_timeout(struct discord *client,
     (void)client;
     struct discord_gateway *gw = timer->data;
 
+    /* heartbeats go out as soon as HELLO is received, a shard waiting on
+     *  the identify queue must still be kept alive */
     if (CCORD_OK == discord_gateway_perform(gw)
         && ~gw->session->status & DISCORD_SESSION_SHUTDOWN
-        && gw->session->is_ready)
+        && ws_is_functional(gw->ws))
     {
         discord_gateway_send_heartbeat(gw, gw->payload.seq);
     }
@@ -241,7 +721,8 @@ _discord_on_heartbeat_timeout(struct discord *client,
         gw->timer->hbeat_last + (u64unix_ms)gw->timer->hbeat_interval;
 
     timer->interval = (int64_t)(next_hb) - (int64_t)discord_timestamp(client);
-    if (timer->interval < 1) timer->interval = 1;
+    /* not connected, check back after a full interval */
+    if (timer->interval < 1) timer->interval = gw->timer->hbeat_interval;
     timer->repeat = 1;
 }
 
@@ -264,8 +745,12 @@ discord_gateway_send_heartbeat(struct discord_gateway *gw, int seq)
         jsonb_object_pop(&b, buf, sizeof(buf));
     }
 
+    if (!_discord_gateway_outbound_check(gw, DISCORD_GATEWAY_HEARTBEAT,
+                                         "HEARTBEAT", buf, (size_t)b.pos))
+        return;
+
     if (ws_send_text(gw->ws, &info, buf, b.pos)) {
-        io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+        io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
         logconf_info(
             &gw->conf,
             ANSICOLOR(
@@ -277,7 +762,7 @@ discord_gateway_send_heartbeat(struct discord_gateway *gw, int seq)
         gw->timer->hbeat_last = gw->timer->now;
         if (!gw->timer->hbeat_timer)
             gw->timer->hbeat_timer = discord_internal_timer(
-                CLIENT(gw, gw), _discord_on_heartbeat_timeout, NULL, gw,
+                gw->client, _discord_on_heartbeat_timeout, NULL, gw,
                 gw->timer->hbeat_interval);
     }
     else {
@@ -307,8 +792,14 @@ discord_gateway_send_request_guild_members(
         jsonb_object_pop(&b, buf, sizeof(buf));
     }
 
+    if (!_discord_gateway_outbound_check(gw,
+                                         DISCORD_GATEWAY_REQUEST_GUILD_MEMBERS,
+                                         "REQUEST_GUILD_MEMBERS", buf,
+                                         (size_t)b.pos))
+        return;
+
     if (ws_send_text(gw->ws, &info, buf, b.pos)) {
-        io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+        io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
         logconf_info(
             &gw->conf,
             ANSICOLOR("SEND", ANSI_FG_BRIGHT_GREEN) " REQUEST_GUILD_MEMBERS "
@@ -343,8 +834,14 @@ discord_gateway_send_update_voice_state(
         jsonb_object_pop(&b, buf, sizeof(buf));
     }
 
+    if (!_discord_gateway_outbound_check(gw,
+                                         DISCORD_GATEWAY_VOICE_STATE_UPDATE,
+                                         "UPDATE_VOICE_STATE", buf,
+                                         (size_t)b.pos))
+        return;
+
     if (ws_send_text(gw->ws, &info, buf, b.pos)) {
-        io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+        io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
         logconf_info(
             &gw->conf,
             ANSICOLOR(
@@ -384,8 +881,13 @@ discord_gateway_send_presence_update(struct discord_gateway *gw,
         jsonb_object_pop(&b, buf, sizeof(buf));
     }
 
+    if (!_discord_gateway_outbound_check(gw, DISCORD_GATEWAY_PRESENCE_UPDATE,
+                                         "PRESENCE UPDATE", buf,
+                                         (size_t)b.pos))
+        return;
+
     if (ws_send_text(gw->ws, &info, buf, b.pos)) {
-        io_poller_curlm_enable_perform(CLIENT(gw, gw)->io_poller, gw->mhandle);
+        io_poller_curlm_enable_perform(gw->client->io_poller, gw->mhandle);
         logconf_info(
             &gw->conf,
             ANSICOLOR("SEND", ANSI_FG_BRIGHT_GREEN) " PRESENCE UPDATE (%d "
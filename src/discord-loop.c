@@ -67,12 +67,38 @@ discord_run(struct discord *client)
 {
     struct discord_timers *const timers[] = { &client->timers.internal,
                                               &client->timers.user };
+    struct discord_gateway *peer = NULL;
     int64_t now;
-    CCORDcode code;
-
-    while (1) {
-        BREAK_ON_FAIL(code, discord_gateway_start(&client->gw));
+    CCORDcode code = CCORD_OK;
+
+    /* each shard keeps track of its own reconnection attempts, the loop only
+     *  ends once all of them are over */
+    client->shards.running = 0;
+    client->shards.code = CCORD_OK;
+    if (client->session_file) discord_session_file_load(client);
+    for (int i = 0; i < client->shards.count; ++i) {
+        struct discord_gateway *gw = SHARD(client, i);
+
+        if (CCORD_OK == (code = discord_gateway_start(gw, peer)))
+            ++client->shards.running;
+        /* the Gateway Bot information is the same for every shard, so it's
+         *  only fetched once */
+        if (!peer && (CCORD_OK == code || CCORD_DISCORD_RATELIMIT == code))
+            peer = gw;
+    }
+    /* shards that failed to start keep retrying alongside the others */
+    if (client->shards.running) {
+        for (int i = 0; i < client->shards.count; ++i) {
+            struct discord_gateway *gw = SHARD(client, i);
+
+            if (ws_is_alive(gw->ws)) continue;
+            ++client->shards.running;
+            discord_gateway_restart(gw);
+        }
+        code = CCORD_OK;
+    }
 
+    if (client->shards.running) {
         while (1) {
             int poll_result, poll_errno = 0;
             int64_t poll_time = 0;
@@ -121,12 +147,17 @@ discord_run(struct discord *client)
             BREAK_ON_FAIL(code, io_poller_perform(client->io_poller));
 
             discord_requestor_dispatch_responses(&client->rest.requestor);
-        }
 
-        /* stop all pending requests in case of connection shutdown */
-        if (true == discord_gateway_end(&client->gw)) break;
+            /* the last shards gave up in between their restart attempts */
+            if (!client->shards.running) {
+                code = client->shards.code;
+                break;
+            }
+        }
     }
 
+    if (client->session_file) discord_session_file_save(client);
+
     return code;
 }
 
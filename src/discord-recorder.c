@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+#include "cog-utils.h"
+
+/* Recording format: the RECORDER_MAGIC string, followed by every payload as
+ *      a RECORDER_HEADER_LEN bytes little-endian header (receive timestamp in
+ *      microseconds: 8 bytes, shard id: 4 bytes, payload length: 4 bytes) and
+ *      the payload itself */
+#define RECORDER_MAGIC      "CCORDREC"
+#define RECORDER_MAGIC_LEN  (sizeof(RECORDER_MAGIC) - 1)
+#define RECORDER_HEADER_LEN 16
+
+static void
+_discord_recorder_put(unsigned char *p, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+        p[i] = (unsigned char)(value >> (8 * i));
+}
+
+static uint64_t
+_discord_recorder_get(const unsigned char *p, size_t size)
+{
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < size; ++i)
+        value |= (uint64_t)p[i] << (8 * i);
+    return value;
+}
+
+void
+discord_recorder_init(struct discord_recorder *recorder, struct logconf *conf)
+{
+    memset(recorder, 0, sizeof *recorder);
+
+    logconf_branch(&recorder->conf, conf, "DISCORD_RECORDER");
+}
+
+void
+discord_recorder_cleanup(struct discord_recorder *recorder)
+{
+    if (recorder->fp) fclose(recorder->fp);
+    recorder->fp = NULL;
+}
+
+void
+discord_recorder_append(struct discord_recorder *recorder,
+                        int shard_id,
+                        const char text[],
+                        size_t len)
+{
+    unsigned char header[RECORDER_HEADER_LEN];
+
+    _discord_recorder_put(header, cog_timestamp_us(), 8);
+    _discord_recorder_put(header + 8, (uint32_t)shard_id, 4);
+    _discord_recorder_put(header + 12, (uint32_t)len, 4);
+
+    if (1 != fwrite(header, sizeof(header), 1, recorder->fp)
+        || len != fwrite(text, 1, len, recorder->fp))
+    {
+        logconf_error(&recorder->conf,
+                      "Couldn't write to recording, stop recording: %s",
+                      strerror(errno));
+        discord_recorder_cleanup(recorder);
+    }
+}
+
+CCORDcode
+discord_set_traffic_recorder(struct discord *client, const char filename[])
+{
+    struct discord_recorder *recorder = &client->recorder;
+
+    discord_recorder_cleanup(recorder);
+    if (!filename) return CCORD_OK;
+
+    if (!(recorder->fp = fopen(filename, "wb"))) {
+        logconf_error(&recorder->conf, "Couldn't open '%s': %s", filename,
+                      strerror(errno));
+        return CCORD_BAD_PARAMETER;
+    }
+    if (1 != fwrite(RECORDER_MAGIC, RECORDER_MAGIC_LEN, 1, recorder->fp)) {
+        discord_recorder_cleanup(recorder);
+        return CCORD_BAD_PARAMETER;
+    }
+
+    logconf_info(&recorder->conf, "Recording Gateway traffic to '%s'",
+                 filename);
+
+    return CCORD_OK;
+}
+
+CCORDcode
+discord_replay_traffic(struct discord *client,
+                       const char filename[],
+                       bool paced,
+                       struct discord_replay_stats *stats)
+{
+    struct discord_replay_stats replay = { 0 };
+    unsigned char header[RECORDER_HEADER_LEN];
+    char magic[RECORDER_MAGIC_LEN];
+    struct ccord_szbuf_reusable buf = { 0 };
+    uint64_t tstart, first_us = 0;
+    CCORDcode code = CCORD_OK;
+    FILE *fp;
+
+    CCORD_EXPECT(client, filename != NULL, CCORD_BAD_PARAMETER, "");
+
+    if (!(fp = fopen(filename, "rb"))) {
+        logconf_error(&client->recorder.conf, "Couldn't open '%s': %s",
+                      filename, strerror(errno));
+        return CCORD_BAD_PARAMETER;
+    }
+    if (1 != fread(magic, sizeof(magic), 1, fp)
+        || memcmp(magic, RECORDER_MAGIC, sizeof(magic)))
+    {
+        logconf_error(&client->recorder.conf,
+                      "'%s' isn't a Gateway traffic recording", filename);
+        fclose(fp);
+        return CCORD_BAD_PARAMETER;
+    }
+
+    tstart = discord_timestamp_us(client);
+    while (1 == fread(header, sizeof(header), 1, fp)) {
+        const uint64_t received_us = _discord_recorder_get(header, 8);
+        const int shard_id = (int)_discord_recorder_get(header + 8, 4);
+        const size_t len = (size_t)_discord_recorder_get(header + 12, 4);
+        const int index = shard_id - client->shards.first;
+        struct discord_gateway *gw =
+            (index >= 0 && index < client->shards.count)
+                ? SHARD(client, index)
+                : &client->gw;
+
+        if (len + 1 > buf.realsize) {
+            void *tmp = realloc(buf.start, len + 1);
+
+            ASSERT_S(tmp != NULL, "Out of memory");
+            buf.start = tmp;
+            buf.realsize = len + 1;
+        }
+        if (len != fread(buf.start, 1, len, fp)) {
+            logconf_error(&client->recorder.conf,
+                          "Recording '%s' is truncated", filename);
+            code = CCORD_BAD_JSON;
+            break;
+        }
+        buf.start[len] = '\0';
+
+        if (paced) {
+            if (!replay.payloads) first_us = received_us;
+            const uint64_t due = tstart + (received_us - first_us),
+                           now = discord_timestamp_us(client);
+
+            if (due > now) cog_sleep_us((long)(due - now));
+        }
+
+        if (!discord_gateway_replay(gw, buf.start, len)) {
+            logconf_error(&client->recorder.conf,
+                          "Couldn't parse recorded payload #%zu",
+                          replay.payloads + 1);
+            code = CCORD_BAD_JSON;
+            break;
+        }
+        ++replay.payloads;
+        replay.bytes += len;
+    }
+    replay.elapsed_us = discord_timestamp_us(client) - tstart;
+
+    /* the payloads buffer is about to be freed */
+    for (int i = 0; i < client->shards.count; ++i) {
+        struct discord_gateway *gw = SHARD(client, i);
+
+        gw->payload.json.start = NULL;
+        gw->payload.json.size = 0;
+        gw->payload.data = NULL;
+    }
+    free(buf.start);
+    fclose(fp);
+
+    logconf_info(&client->recorder.conf,
+                 "Replayed %zu payloads (%zu bytes) in %" PRIu64 " us",
+                 replay.payloads, replay.bytes, replay.elapsed_us);
+
+    if (stats) *stats = replay;
+
+    return code;
+}
@@ -62,6 +62,11 @@ discord_requestor_init(struct discord_requestor *rqtor,
     rqtor->mhandle = curl_multi_init();
     rqtor->retry_limit = 3; /* FIXME: shouldn't be a hard limit */
 
+    rqtor->http2 = calloc(1, sizeof *rqtor->http2);
+    rqtor->http2->version = CURL_HTTP_VERSION_NONE;
+    ASSERT_S(!pthread_mutex_init(&rqtor->http2->lock, NULL),
+             "Couldn't initialize requestor's HTTP/2 mutex");
+
     discord_ratelimiter_init(&rqtor->ratelimiter, &rqtor->conf);
 }
 
@@ -99,6 +104,9 @@ discord_requestor_cleanup(struct discord_requestor *rqtor)
     pthread_mutex_destroy(&rqtor->qlocks->finished);
     free(rqtor->qlocks);
 
+    pthread_mutex_destroy(&rqtor->http2->lock);
+    free(rqtor->http2);
+
     /* cleanup curl's multi handle */
     io_poller_curlm_del(rest->io_poller, rqtor->mhandle);
     curl_multi_cleanup(rqtor->mhandle);
@@ -106,6 +114,52 @@ discord_requestor_cleanup(struct discord_requestor *rqtor)
     ua_cleanup(rqtor->ua);
 }
 
+void
+discord_requestor_set_http2(struct discord_requestor *rqtor,
+                            bool enable,
+                            long max_connections)
+{
+    pthread_mutex_lock(&rqtor->http2->lock);
+    rqtor->http2->enabled = enable;
+    rqtor->http2->max_connections = max_connections > 0 ? max_connections : 0;
+    rqtor->http2->dirty = true;
+    pthread_mutex_unlock(&rqtor->http2->lock);
+}
+
+/* the multi handle may only be touched from the REST thread */
+static void
+_discord_requestor_apply_http2(struct discord_requestor *rqtor)
+{
+    bool enabled;
+    long max_connections;
+
+    pthread_mutex_lock(&rqtor->http2->lock);
+    if (!rqtor->http2->dirty) {
+        pthread_mutex_unlock(&rqtor->http2->lock);
+        return;
+    }
+    enabled = rqtor->http2->enabled;
+    max_connections = rqtor->http2->max_connections;
+    rqtor->http2->dirty = false;
+    pthread_mutex_unlock(&rqtor->http2->lock);
+
+    curl_multi_setopt(rqtor->mhandle, CURLMOPT_PIPELINING,
+                      enabled ? (long)CURLPIPE_MULTIPLEX
+                              : (long)CURLPIPE_NOTHING);
+    curl_multi_setopt(rqtor->mhandle, CURLMOPT_MAX_HOST_CONNECTIONS,
+                      enabled ? max_connections : 0L);
+    if (!enabled)
+        rqtor->http2->version = CURL_HTTP_VERSION_NONE;
+    /* a cleartext stand-in for Discord has no TLS to negotiate HTTP/2 with */
+    else if (0 == strncmp(ua_get_url(rqtor->ua), "http://", 7))
+        rqtor->http2->version = CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE;
+    else
+        rqtor->http2->version = CURL_HTTP_VERSION_2TLS;
+
+    logconf_info(&rqtor->conf, "HTTP/2 multiplexing %s (max connections: %ld)",
+                 enabled ? "enabled" : "disabled", max_connections);
+}
+
 static void
 _discord_request_to_multipart(curl_mime *mime, void *p_req)
 {
@@ -355,6 +409,21 @@ _discord_request_retry(struct discord_requestor *rqtor,
     return true;
 }
 
+static void
+_discord_request_count(struct discord_requestor *rqtor, CURL *ehandle)
+{
+    long nconnects = 0, version = CURL_HTTP_VERSION_NONE;
+
+    curl_easy_getinfo(ehandle, CURLINFO_NUM_CONNECTS, &nconnects);
+    curl_easy_getinfo(ehandle, CURLINFO_HTTP_VERSION, &version);
+
+    pthread_mutex_lock(&rqtor->http2->lock);
+    ++rqtor->http2->stats.requests;
+    rqtor->http2->stats.connections += (uint64_t)nconnects;
+    if (CURL_HTTP_VERSION_2_0 == version) ++rqtor->http2->stats.streams;
+    pthread_mutex_unlock(&rqtor->http2->lock);
+}
+
 CCORDcode
 discord_requestor_info_read(struct discord_requestor *rqtor)
 {
@@ -377,6 +446,7 @@ discord_requestor_info_read(struct discord_requestor *rqtor)
 
             curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &req);
             curl_multi_remove_handle(rqtor->mhandle, msg->easy_handle);
+            _discord_request_count(rqtor, msg->easy_handle);
 
             switch (ecode) {
             case CURLE_OK: {
@@ -406,7 +476,11 @@ discord_requestor_info_read(struct discord_requestor *rqtor)
                     if (req->response.init)
                         req->response.init(req->response.data);
                     /* populate ret */
-                    if (req->response.from_json)
+                    if (req->dispatch.mask && req->response.from_json_masked)
+                        req->response.from_json_masked(body.start, body.size,
+                                                       req->response.data,
+                                                       req->dispatch.mask);
+                    else if (req->response.from_json)
                         req->response.from_json(body.start, body.size,
                                                 req->response.data);
                 }
@@ -477,6 +551,19 @@ _discord_request_send(void *p_rqtor, struct discord_request *req)
                                  .base_url = NULL,
                              });
 
+    /* connections are reused, so these must always be set */
+    curl_easy_setopt(ehandle, CURLOPT_HTTP_VERSION, rqtor->http2->version);
+    if (CURL_HTTP_VERSION_NONE == rqtor->http2->version) {
+        curl_easy_setopt(ehandle, CURLOPT_PIPEWAIT, 0L);
+        curl_easy_setopt(ehandle, CURLOPT_ACCEPT_ENCODING, NULL);
+    }
+    else {
+        /* wait for a connection being established to multiplex on it */
+        curl_easy_setopt(ehandle, CURLOPT_PIPEWAIT, 1L);
+        /* every encoding supported by libcurl */
+        curl_easy_setopt(ehandle, CURLOPT_ACCEPT_ENCODING, "");
+    }
+
     /* link 'req' to 'ehandle' for easy retrieval */
     curl_easy_setopt(ehandle, CURLOPT_PRIVATE, req);
 
@@ -495,6 +582,8 @@ discord_requestor_start_pending(struct discord_requestor *rqtor)
     QUEUE_MOVE(&rqtor->queues->pending, &queue);
     pthread_mutex_unlock(&rqtor->qlocks->pending);
 
+    _discord_requestor_apply_http2(rqtor);
+
     /* match pending requests to their buckets */
     while (!QUEUE_EMPTY(&queue)) {
         qelem = QUEUE_HEAD(&queue);
@@ -580,6 +669,37 @@ _discord_request_get(struct discord_requestor *rqtor)
     return req;
 }
 
+size_t
+discord_request_body_encode(struct ccord_szbuf_reusable *body,
+                            const struct discord_ret_body *params)
+{
+    jsonbcode code;
+    jsonb b;
+
+    if (!body->realsize) {
+        void *tmp = malloc(DISCORD_BODY_INITIAL_SIZE);
+        ASSERT_S(tmp != NULL, "Out of memory");
+
+        body->start = tmp;
+        body->realsize = DISCORD_BODY_INITIAL_SIZE;
+    }
+    while (1) {
+        void *tmp;
+
+        jsonb_init(&b);
+        code = params->to_jsonb(&b, body->start, body->realsize,
+                                params->params);
+        if (code != JSONB_ERROR_NOMEM) break;
+
+        tmp = realloc(body->start, 2 * body->realsize);
+        ASSERT_S(tmp != NULL, "Out of memory");
+
+        body->start = tmp;
+        body->realsize *= 2;
+    }
+    return code < 0 ? 0 : b.pos;
+}
+
 CCORDcode
 discord_request_begin(struct discord_requestor *rqtor,
                       struct discord_attributes *attr,
@@ -596,7 +716,11 @@ discord_request_begin(struct discord_requestor *rqtor,
     CCORDcode code;
 
     req->method = method;
-    if (body) {
+    if (attr->body_params.to_jsonb) {
+        req->body.size =
+            discord_request_body_encode(&req->body, &attr->body_params);
+    }
+    else if (body) {
         if (body->size > req->body.realsize) { /* buffer needs a resize */
             void *tmp = realloc(req->body.start, body->size);
             ASSERT_S(tmp != NULL, "Out of memory");
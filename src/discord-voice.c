@@ -647,10 +647,11 @@ discord_voice_join(struct discord *client,
                                                 .channel_id = vchannel_id,
                                                 .self_mute = self_mute,
                                                 .self_deaf = self_deaf };
+    struct discord_gateway *gw = discord_gateway_get_shard(client, guild_id);
     bool found_a_running_vcs = false;
     struct discord_voice *vc = NULL;
 
-    if (!ws_is_functional(client->gw.ws)) return DISCORD_VOICE_ERROR;
+    if (!ws_is_functional(gw->ws)) return DISCORD_VOICE_ERROR;
 
     pthread_mutex_lock(&client_lock);
     for (int i = 0; i < DISCORD_MAX_VCS; ++i) {
@@ -680,7 +681,7 @@ discord_voice_join(struct discord *client,
     }
 
     recycle_active_vc(vc, guild_id, vchannel_id);
-    discord_gateway_send_update_voice_state(&client->gw, &state);
+    discord_gateway_send_update_voice_state(gw, &state);
 
     return DISCORD_VOICE_JOINED;
 }
@@ -898,7 +899,8 @@ discord_voice_shutdown(struct discord_voice *vc)
     vc->shutdown = true;
     vc->is_resumable = false;
 
-    discord_gateway_send_update_voice_state(&vc->p_client->gw, &state);
+    discord_gateway_send_update_voice_state(
+        discord_gateway_get_shard(vc->p_client, vc->guild_id), &state);
     ws_close(vc->ws, WS_CLOSE_REASON_NORMAL, reason, sizeof(reason));
 }
 
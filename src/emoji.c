@@ -46,18 +46,15 @@ discord_create_guild_emoji(struct discord *client,
                            struct discord_ret_emoji *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[2048];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_create_guild_emoji_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_guild_emoji, params);
 
     DISCORD_ATTR_INIT(attr, discord_emoji, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/guilds/%" PRIu64 "/emojis", guild_id);
 }
 
@@ -69,19 +66,16 @@ discord_modify_guild_emoji(struct discord *client,
                            struct discord_ret_emoji *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[2048];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, emoji_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_guild_emoji_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild_emoji, params);
 
     DISCORD_ATTR_INIT(attr, discord_emoji, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/emojis/%" PRIu64, guild_id,
                             emoji_id);
 }
@@ -12,17 +12,14 @@ discord_create_guild(struct discord *client,
                      struct discord_ret_guild *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_create_guild_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_guild, params);
 
     DISCORD_ATTR_INIT(attr, discord_guild, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST, "/guilds");
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST, "/guilds");
 }
 
 CCORDcode
@@ -62,18 +59,15 @@ discord_modify_guild(struct discord *client,
                      struct discord_ret_guild *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_guild_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild, params);
 
     DISCORD_ATTR_INIT(attr, discord_guild, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64, guild_id);
 }
 
@@ -114,18 +108,15 @@ discord_create_guild_channel(struct discord *client,
                              struct discord_ret_channel *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[2048];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_create_guild_channel_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_guild_channel, params);
 
     DISCORD_ATTR_INIT(attr, discord_channel, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/guilds/%" PRIu64 "/channels", guild_id);
 }
 
@@ -137,19 +128,16 @@ discord_modify_guild_channel_positions(
     struct discord_ret *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_guild_channel_positions_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild_channel_positions,
+                           params);
 
     DISCORD_ATTR_BLANK_INIT(attr, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/channels", guild_id);
 }
 
@@ -251,8 +239,6 @@ discord_add_guild_member(struct discord *client,
                          struct discord_ret_guild_member *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, user_id != 0, CCORD_BAD_PARAMETER, "");
@@ -260,12 +246,11 @@ discord_add_guild_member(struct discord *client,
     CCORD_EXPECT(client, params->access_token != NULL, CCORD_BAD_PARAMETER,
                  "");
 
-    body.size = discord_add_guild_member_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_add_guild_member, params);
 
     DISCORD_ATTR_INIT(attr, discord_guild_member, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PUT,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PUT,
                             "/guilds/%" PRIu64 "/members/%" PRIu64, guild_id,
                             user_id);
 }
@@ -278,19 +263,16 @@ discord_modify_guild_member(struct discord *client,
                             struct discord_ret_guild_member *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[2048];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, user_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_guild_member_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild_member, params);
 
     DISCORD_ATTR_INIT(attr, discord_guild_member, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/members/%" PRIu64, guild_id,
                             user_id);
 }
@@ -301,20 +283,16 @@ discord_modify_current_member(struct discord *client,
                               struct discord_ret_guild_member *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[512];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params->nick != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_modify_current_member_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_current_member, params);
 
     DISCORD_ATTR_INIT(attr, discord_guild_member, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/members/@me", guild_id);
 }
 CCORDcode
@@ -325,8 +303,6 @@ discord_modify_current_user_nick(
     struct discord_ret_guild_member *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[512];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
@@ -336,13 +312,11 @@ discord_modify_current_user_nick(
                  "This endpoint is now deprecated by Discord. Please use "
                  "discord_modify_current_member instead");
 
-    body.size =
-        discord_modify_current_user_nick_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_current_user_nick, params);
 
     DISCORD_ATTR_INIT(attr, discord_guild_member, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/members/@me/nick", guild_id);
 }
 
@@ -451,8 +425,6 @@ discord_create_guild_ban(struct discord *client,
                          struct discord_ret *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[256];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, user_id != 0, CCORD_BAD_PARAMETER, "");
@@ -462,12 +434,11 @@ discord_create_guild_ban(struct discord *client,
                      && params->delete_message_days <= 7,
                  CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_create_guild_ban_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_guild_ban, params);
 
     DISCORD_ATTR_BLANK_INIT(attr, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PUT,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PUT,
                             "/guilds/%" PRIu64 "/bans/%" PRIu64, guild_id,
                             user_id);
 }
@@ -512,17 +483,14 @@ discord_create_guild_role(struct discord *client,
                           struct discord_ret_role *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_create_guild_role_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_guild_role, params);
 
     DISCORD_ATTR_INIT(attr, discord_role, ret, params ? params->reason : NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/guilds/%" PRIu64 "/roles", guild_id);
 }
 
@@ -534,19 +502,15 @@ discord_modify_guild_role_positions(
     struct discord_ret_roles *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_modify_guild_role_positions_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild_role_positions, params);
 
     DISCORD_ATTR_LIST_INIT(attr, discord_roles, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/roles", guild_id);
 }
 
@@ -558,18 +522,15 @@ discord_modify_guild_role(struct discord *client,
                           struct discord_ret_role *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[2048];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, role_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_guild_role_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild_role, params);
 
     DISCORD_ATTR_INIT(attr, discord_role, ret, params ? params->reason : NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/roles/%" PRIu64, guild_id,
                             role_id);
 }
@@ -645,17 +606,14 @@ discord_begin_guild_prune(struct discord *client,
                           struct discord_ret *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_begin_guild_prune_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_begin_guild_prune, params);
 
     DISCORD_ATTR_BLANK_INIT(attr, ret, params ? params->reason : NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/guilds/%" PRIu64 "/prune", guild_id);
 }
 
@@ -747,20 +705,16 @@ discord_modify_guild_widget(struct discord *client,
                             struct discord_ret_guild_widget_settings *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[512];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_guild_widget_settings_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_guild_widget_settings, params);
 
     DISCORD_ATTR_INIT(attr, discord_guild_widget_settings, ret,
                       params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/widget", guild_id);
 }
 
@@ -838,19 +792,15 @@ discord_modify_guild_welcome_screen(
     struct discord_ret_welcome_screen *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_modify_guild_welcome_screen_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild_welcome_screen, params);
 
     DISCORD_ATTR_INIT(attr, discord_welcome_screen, ret,
                       params ? params->reason : NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/welcome-screen", guild_id);
 }
 
@@ -862,18 +812,15 @@ discord_modify_current_user_voice_state(
     struct discord_ret *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[512];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_current_user_voice_state_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_current_user_voice_state,
+                           params);
 
     DISCORD_ATTR_BLANK_INIT(attr, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/voice-states/@me", guild_id);
 }
 
@@ -885,18 +832,14 @@ discord_modify_user_voice_state(struct discord *client,
                                 struct discord_ret *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[512];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_modify_user_voice_state_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_user_voice_state, params);
 
     DISCORD_ATTR_BLANK_INIT(attr, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/voice-states/%" PRIu64,
                             guild_id, user_id);
 }
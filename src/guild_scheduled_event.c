@@ -34,8 +34,6 @@ discord_create_guild_scheduled_event(
     struct discord_ret_guild_scheduled_event *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
@@ -48,11 +46,9 @@ discord_create_guild_scheduled_event(
     DISCORD_ATTR_INIT(attr, discord_guild_scheduled_event, ret,
                       params->reason);
 
-    body.size =
-        discord_create_guild_scheduled_event_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_guild_scheduled_event, params);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/guilds/%" PRIu64 "/scheduled-events", guild_id);
 }
 
@@ -89,8 +85,6 @@ discord_modify_guild_scheduled_event(
     struct discord_ret_guild_scheduled_event *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[4096];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, guild_scheduled_event_id != 0, CCORD_BAD_PARAMETER,
@@ -99,11 +93,9 @@ discord_modify_guild_scheduled_event(
     DISCORD_ATTR_INIT(attr, discord_guild_scheduled_event, ret,
                       params ? params->reason : NULL);
 
-    body.size =
-        discord_modify_guild_scheduled_event_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild_scheduled_event, params);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/scheduled-events/%" PRIu64,
                             guild_id, guild_scheduled_event_id);
 }
@@ -30,19 +30,15 @@ discord_create_guild_from_guild_template(
     struct discord_ret_guild *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[256] = { 0 };
 
     CCORD_EXPECT(client, NOT_EMPTY_STR(template_code), CCORD_BAD_PARAMETER,
                  "");
 
-    body.size = discord_create_guild_from_guild_template_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
-
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_guild_from_guild_template,
+                           params);
     DISCORD_ATTR_INIT(attr, discord_guild, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/guilds/templates/%s", template_code);
 }
 
@@ -68,18 +64,14 @@ discord_create_guild_template(struct discord *client,
                               struct discord_ret_guild_template *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[256];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_create_guild_template_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_guild_template, params);
 
     DISCORD_ATTR_INIT(attr, discord_guild_template, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/guilds/%" PRIu64 "/templates", guild_id);
 }
 
@@ -110,20 +102,16 @@ discord_modify_guild_template(struct discord *client,
                               struct discord_ret_guild_template *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024] = { 0 };
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, NOT_EMPTY_STR(template_code), CCORD_BAD_PARAMETER,
                  "");
+    CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size =
-        discord_modify_guild_template_from_json(buf, sizeof(buf), params);
-    body.start = buf;
-
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild_template, params);
     DISCORD_ATTR_INIT(attr, discord_guild_template, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/templates/%s", guild_id,
                             template_code);
 }
@@ -15,9 +15,7 @@ discord_create_interaction_response(
     struct discord_ret_interaction_response *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
     enum http_method method;
-    char buf[16384];
 
     CCORD_EXPECT(client, interaction_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, NOT_EMPTY_STR(interaction_token), CCORD_BAD_PARAMETER,
@@ -33,12 +31,11 @@ discord_create_interaction_response(
         method = HTTP_POST;
     }
 
-    body.size = discord_interaction_response_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_interaction_response, params);
 
     DISCORD_ATTR_INIT(attr, discord_interaction_response, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, method,
+    return discord_rest_run(&client->rest, &attr, NULL, method,
                             "/interactions/%" PRIu64 "/%s/callback",
                             interaction_id, interaction_token);
 }
@@ -72,9 +69,7 @@ discord_edit_original_interaction_response(
     struct discord_ret_interaction_response *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
     enum http_method method;
-    char buf[16384]; /**< @todo dynamic buffer */
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, NOT_EMPTY_STR(interaction_token), CCORD_BAD_PARAMETER,
@@ -90,13 +85,12 @@ discord_edit_original_interaction_response(
         method = HTTP_PATCH;
     }
 
-    body.size = discord_edit_original_interaction_response_to_json(
-        buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_edit_original_interaction_response,
+                           params);
 
     DISCORD_ATTR_INIT(attr, discord_interaction_response, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, method,
+    return discord_rest_run(&client->rest, &attr, NULL, method,
                             "/webhooks/%" PRIu64 "/%s/messages/@original",
                             application_id, interaction_token);
 }
@@ -128,9 +122,7 @@ discord_create_followup_message(struct discord *client,
                                 struct discord_ret_webhook *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
     enum http_method method;
-    char buf[16384]; /**< @todo dynamic buffer */
     char query[4096] = "";
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
@@ -153,13 +145,11 @@ discord_create_followup_message(struct discord *client,
         method = HTTP_POST;
     }
 
-    body.size =
-        discord_create_followup_message_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_followup_message, params);
 
     DISCORD_ATTR_INIT(attr, discord_webhook, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, method,
+    return discord_rest_run(&client->rest, &attr, NULL, method,
                             "/webhooks/%" PRIu64 "/%s%s%s", application_id,
                             interaction_token, *query ? "?" : "", query);
 }
@@ -194,9 +184,7 @@ discord_edit_followup_message(struct discord *client,
                               struct discord_ret_message *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
     enum http_method method;
-    char buf[16384]; /**< @todo dynamic buffer */
 
     CCORD_EXPECT(client, application_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, NOT_EMPTY_STR(interaction_token), CCORD_BAD_PARAMETER,
@@ -213,13 +201,11 @@ discord_edit_followup_message(struct discord *client,
         method = HTTP_PATCH;
     }
 
-    body.size =
-        discord_edit_followup_message_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_edit_followup_message, params);
 
     DISCORD_ATTR_INIT(attr, discord_message, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, method,
+    return discord_rest_run(&client->rest, &attr, NULL, method,
                             "/webhooks/%" PRIu64 "/%s/messages/%" PRIu64,
                             application_id, interaction_token, message_id);
 }
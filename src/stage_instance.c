@@ -16,20 +16,16 @@ discord_create_stage_instance(struct discord *client,
                               struct discord_ret_stage_instance *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params->channel_id != 0, CCORD_BAD_PARAMETER, "");
-    CCORD_EXPECT(client, IS_NOT_EMPTY_STRING(params->topic),
-                 CCORD_BAD_PARAMETER, "");
-
-    body.size = discord_create_stage_instance(buf, sizeof(buf), params);
-    body.start = buf;
+    CCORD_EXPECT(client, NOT_EMPTY_STR(params->topic), CCORD_BAD_PARAMETER,
+                 "");
 
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_stage_instance, params);
     DISCORD_ATTR_INIT(attr, discord_stage_instance, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/stage-instances");
 }
 
@@ -55,17 +51,14 @@ discord_modify_stage_instance(struct discord *client,
                               struct discord_ret_stage_instance *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
+    CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_stage_instance(buf, sizeof(buf), params);
-    body.start = buf;
-
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_stage_instance, params);
     DISCORD_ATTR_INIT(attr, discord_stage_instance, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/stage-instances/%" PRIu64, channel_id);
 }
 
@@ -78,19 +78,16 @@ discord_modify_guild_sticker(struct discord *client,
                              struct discord_ret_sticker *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, guild_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, sticker_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_guild_sticker_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_guild_sticker, params);
 
     DISCORD_ATTR_INIT(attr, discord_sticker, ret,
                       params ? params->reason : NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/guilds/%" PRIu64 "/stickers/%" PRIu64, guild_id,
                             sticker_id);
 }
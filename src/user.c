@@ -38,17 +38,14 @@ discord_modify_current_user(struct discord *client,
                             struct discord_ret_user *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_current_user_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_current_user, params);
 
     DISCORD_ATTR_INIT(attr, discord_user, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/users/@me");
 }
 
@@ -86,17 +83,14 @@ discord_create_dm(struct discord *client,
                   struct discord_ret_channel *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[128];
 
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_create_dm_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_dm, params);
 
     DISCORD_ATTR_INIT(attr, discord_channel, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/users/@me/channels");
 }
 
@@ -106,20 +100,17 @@ discord_create_group_dm(struct discord *client,
                         struct discord_ret_channel *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params->access_tokens != NULL, CCORD_BAD_PARAMETER,
                  "");
     CCORD_EXPECT(client, params->nicks != NULL, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_create_group_dm_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_group_dm, params);
 
     DISCORD_ATTR_INIT(attr, discord_channel, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/users/@me/channels");
 }
 
@@ -13,19 +13,16 @@ discord_create_webhook(struct discord *client,
                        struct discord_ret_webhook *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, channel_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, params != NULL, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, NOT_EMPTY_STR(params->name), CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_create_webhook_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_webhook, params);
 
     DISCORD_ATTR_INIT(attr, discord_webhook, ret, params->reason);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_POST,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_POST,
                             "/channels/%" PRIu64 "/webhooks", channel_id);
 }
 
@@ -100,18 +97,15 @@ discord_modify_webhook(struct discord *client,
                        struct discord_ret_webhook *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, webhook_id != 0, CCORD_BAD_PARAMETER, "");
 
-    body.size = discord_modify_webhook_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_webhook, params);
 
     DISCORD_ATTR_INIT(attr, discord_webhook, ret,
                       params ? params->reason : NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/webhooks/%" PRIu64, webhook_id);
 }
 
@@ -124,20 +118,16 @@ discord_modify_webhook_with_token(
     struct discord_ret_webhook *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
-    char buf[1024];
 
     CCORD_EXPECT(client, webhook_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, NOT_EMPTY_STR(webhook_token), CCORD_BAD_PARAMETER,
                  "");
 
-    body.size =
-        discord_modify_webhook_with_token_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_modify_webhook_with_token, params);
 
     DISCORD_ATTR_INIT(attr, discord_webhook, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, HTTP_PATCH,
+    return discord_rest_run(&client->rest, &attr, NULL, HTTP_PATCH,
                             "/webhooks/%" PRIu64 "/%s", webhook_id,
                             webhook_token);
 }
@@ -185,9 +175,7 @@ discord_execute_webhook(struct discord *client,
                         struct discord_ret *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
     enum http_method method;
-    char buf[16384]; /**< @todo dynamic buffer */
     char query[4096] = "";
     int offset = 0;
 
@@ -216,12 +204,11 @@ discord_execute_webhook(struct discord *client,
         method = HTTP_POST;
     }
 
-    body.size = discord_execute_webhook_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_execute_webhook, params);
 
     DISCORD_ATTR_BLANK_INIT(attr, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, method,
+    return discord_rest_run(&client->rest, &attr, NULL, method,
                             "/webhooks/%" PRIu64 "/%s%s%s", webhook_id,
                             webhook_token, *query ? "?" : "", query);
 }
@@ -256,9 +243,7 @@ discord_edit_webhook_message(struct discord *client,
                              struct discord_ret_message *ret)
 {
     struct discord_attributes attr = { 0 };
-    struct ccord_szbuf body;
     enum http_method method;
-    char buf[16384]; /**< @todo dynamic buffer */
 
     CCORD_EXPECT(client, webhook_id != 0, CCORD_BAD_PARAMETER, "");
     CCORD_EXPECT(client, NOT_EMPTY_STR(webhook_token), CCORD_BAD_PARAMETER,
@@ -275,12 +260,11 @@ discord_edit_webhook_message(struct discord *client,
         method = HTTP_PATCH;
     }
 
-    body.size = discord_edit_webhook_message_to_json(buf, sizeof(buf), params);
-    body.start = buf;
+    DISCORD_ATTR_BODY_INIT(attr, discord_edit_webhook_message, params);
 
     DISCORD_ATTR_INIT(attr, discord_message, ret, NULL);
 
-    return discord_rest_run(&client->rest, &attr, &body, method,
+    return discord_rest_run(&client->rest, &attr, NULL, method,
                             "/webhooks/%" PRIu64 "/%s/messages/%" PRIu64,
                             webhook_id, webhook_token, message_id);
 }
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+static const char MESSAGE[] =
+    "{\"id\":\"1014990303337226250\",\"channel_id\":\"939234213521760276\","
+    "\"guild_id\":\"939234213521760270\",\"type\":0,\"tts\":false,"
+    "\"content\":\"hello \\\"world\\\"\",\"pinned\":false,"
+    "\"timestamp\":\"2022-09-02T18:15:12.345000+00:00\","
+    "\"edited_timestamp\":null,\"mention_everyone\":false,"
+    "\"author\":{\"id\":\"140931563499159552\",\"username\":\"concord\","
+    "\"discriminator\":\"0001\",\"avatar\":null,\"bot\":true},"
+    "\"member\":{\"roles\":[\"939234213521760271\",\"939234213521760272\"],"
+    "\"nick\":null,\"joined_at\":\"2022-02-04T00:00:00.000000+00:00\","
+    "\"deaf\":false,\"mute\":false},"
+    "\"mentions\":[{\"id\":\"140931563499159553\",\"username\":\"a\"},"
+    "{\"id\":\"140931563499159554\",\"username\":\"b\"}],"
+    "\"mention_roles\":[],\"attachments\":[],"
+    "\"embeds\":[{\"title\":\"embed\",\"description\":\"desc\","
+    "\"color\":16711680,\"fields\":[{\"name\":\"f1\",\"value\":\"v1\","
+    "\"inline\":true}]}],\"nonce\":-42}";
+
+static const char GUILD[] =
+    "{\"id\":\"939234213521760270\",\"name\":\"concord\",\"roles\":["
+    "{\"id\":\"1\",\"name\":\"@everyone\",\"permissions\":\"1071698660929\","
+    "\"tags\":{\"bot_id\":\"7\"}},{\"id\":\"2\",\"name\":\"admin\"}],"
+    "\"channels\":[{\"id\":\"3\",\"name\":\"general\",\"topic\":\"hi\"},"
+    "{\"id\":\"4\",\"name\":\"voice\",\"type\":2}],"
+    "\"features\":[\"COMMUNITY\",\"NEWS\"],\"verification_level\":2,"
+    "\"emojis\":[{\"id\":\"5\",\"name\":\"blob\"}]}";
+
+static char json_buf[0x10000], bin_buf[0x10000];
+
+TEST
+check_message_roundtrip(void)
+{
+    struct discord_message message = { 0 }, decoded;
+    size_t json_size, bin_size;
+    char *json_again;
+
+    discord_message_from_json(MESSAGE, sizeof(MESSAGE) - 1, &message);
+    json_size = discord_message_to_json(json_buf, sizeof(json_buf), &message);
+    ASSERT(json_size > 0);
+
+    bin_size = discord_message_to_bin(bin_buf, sizeof(bin_buf), &message);
+    ASSERT(bin_size > 0);
+    ASSERT(bin_size < json_size / 2);
+    ASSERT_EQ(bin_size, discord_message_from_bin(bin_buf, bin_size, &decoded));
+
+    ASSERT_EQ(message.id, decoded.id);
+    ASSERT_EQ(message.timestamp, decoded.timestamp);
+    ASSERT_STR_EQ("hello \"world\"", decoded.content);
+    ASSERT(decoded.content != message.content);
+    ASSERT_EQ(NULL, decoded.author->avatar);
+    ASSERT_EQ(true, decoded.author->bot);
+    ASSERT_EQ(939234213521760272ULL, decoded.member->roles->array[1]);
+    ASSERT_EQ(0, decoded.mention_roles->size);
+    ASSERT_STR_EQ("-42", decoded.nonce);
+    ASSERT_EQ(16711680, decoded.embeds->array[0].color);
+    ASSERT_EQ(true, decoded.embeds->array[0].fields->array[0].Inline);
+
+    /* nothing is lost on the way */
+    json_again = malloc(json_size + 1);
+    ASSERT_EQ(json_size,
+              discord_message_to_json(json_again, json_size + 1, &decoded));
+    ASSERT_MEM_EQ(json_buf, json_again, json_size);
+
+    free(json_again);
+    discord_message_cleanup(&message);
+    discord_message_cleanup(&decoded);
+    PASS();
+}
+
+TEST
+check_guild_roundtrip(void)
+{
+    struct discord_guild guild = { 0 }, decoded;
+    size_t bin_size;
+
+    discord_guild_from_json(GUILD, sizeof(GUILD) - 1, &guild);
+    guild.channels->array[0].position = -3;
+    bin_size = discord_guild_to_bin(bin_buf, sizeof(bin_buf), &guild);
+    ASSERT(bin_size > 0);
+    ASSERT_EQ(bin_size, discord_guild_from_bin(bin_buf, bin_size, &decoded));
+
+    ASSERT_EQ(1071698660929ULL, decoded.roles->array[0].permissions);
+    ASSERT_EQ(7ULL, decoded.roles->array[0].tags->bot_id);
+    ASSERT_EQ(NULL, decoded.roles->array[1].tags);
+    ASSERT_EQ(-3, decoded.channels->array[0].position);
+    ASSERT_EQ(2, decoded.channels->array[1].type);
+    ASSERT_STR_EQ("NEWS", decoded.features->array[1]);
+    ASSERT_EQ(NULL, decoded.members);
+
+    discord_guild_cleanup(&guild);
+    discord_guild_cleanup(&decoded);
+    PASS();
+}
+
+TEST
+check_bad_input(void)
+{
+    struct discord_guild guild = { 0 }, decoded;
+    size_t bin_size;
+
+    discord_guild_from_json(GUILD, sizeof(GUILD) - 1, &guild);
+    bin_size = discord_guild_to_bin(bin_buf, sizeof(bin_buf), &guild);
+
+    /* the encoding doesn't fit */
+    ASSERT_EQ(0, discord_guild_to_bin(bin_buf, bin_size - 1, &guild));
+
+    /* every truncation is caught, partially decoded fields are released */
+    for (size_t i = 0; i < bin_size; ++i) {
+        ASSERT_EQ(0, discord_guild_from_bin(bin_buf, i, &decoded));
+        discord_guild_cleanup(&decoded);
+    }
+
+    /* a list length well past the buffer isn't allocated */
+    ASSERT_EQ(0, discord_roles_from_bin("\xff\xff\xff\xff\x0f", 5,
+                                        &(struct discord_roles){ 0 }));
+
+    discord_guild_cleanup(&guild);
+    PASS();
+}
+
+SUITE(codec_binary)
+{
+    RUN_TEST(check_message_roundtrip);
+    RUN_TEST(check_guild_roundtrip);
+    RUN_TEST(check_bad_input);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_ROUNDS 20000
+
+TEST
+bench_binary_vs_json(const char *name,
+                     const char json[],
+                     size_t length,
+                     bool is_guild)
+{
+    struct discord_message message = { 0 };
+    struct discord_guild guild = { 0 };
+    size_t json_size, bin_size;
+    uint64_t tstart, json_us, bin_us;
+
+#define ROUNDTRIP(_codec, _buf, _size)                                        \
+    for (int i = 0; i < BENCH_ROUNDS; ++i) {                                  \
+        if (is_guild) {                                                       \
+            struct discord_guild copy = { 0 };                                \
+            discord_guild_to_##_codec(_buf, sizeof(_buf), &guild);            \
+            discord_guild_from_##_codec(_buf, _size, &copy);                  \
+            discord_guild_cleanup(&copy);                                     \
+        }                                                                     \
+        else {                                                                \
+            struct discord_message copy = { 0 };                              \
+            discord_message_to_##_codec(_buf, sizeof(_buf), &message);        \
+            discord_message_from_##_codec(_buf, _size, &copy);                \
+            discord_message_cleanup(&copy);                                   \
+        }                                                                     \
+    }
+
+    if (is_guild) {
+        discord_guild_from_json(json, length, &guild);
+        json_size = discord_guild_to_json(json_buf, sizeof(json_buf), &guild);
+        bin_size = discord_guild_to_bin(bin_buf, sizeof(bin_buf), &guild);
+    }
+    else {
+        discord_message_from_json(json, length, &message);
+        json_size =
+            discord_message_to_json(json_buf, sizeof(json_buf), &message);
+        bin_size = discord_message_to_bin(bin_buf, sizeof(bin_buf), &message);
+    }
+
+    tstart = cog_timestamp_us();
+    ROUNDTRIP(json, json_buf, json_size);
+    json_us = cog_timestamp_us() - tstart;
+
+    tstart = cog_timestamp_us();
+    ROUNDTRIP(bin, bin_buf, bin_size);
+    bin_us = cog_timestamp_us() - tstart;
+
+#undef ROUNDTRIP
+
+    fprintf(stderr,
+            "%s: JSON %4zu bytes %7.1f ns/round-trip, "
+            "binary %4zu bytes %7.1f ns/round-trip\n",
+            name, json_size, json_us * 1000.0 / BENCH_ROUNDS, bin_size,
+            bin_us * 1000.0 / BENCH_ROUNDS);
+
+    discord_message_cleanup(&message);
+    discord_guild_cleanup(&guild);
+    PASS();
+}
+
+SUITE(codec_binary_benchmark)
+{
+    RUN_TESTp(bench_binary_vs_json, "MESSAGE", MESSAGE, sizeof(MESSAGE) - 1,
+              false);
+    RUN_TESTp(bench_binary_vs_json, "GUILD", GUILD, sizeof(GUILD) - 1, true);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(codec_binary);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(codec_binary_benchmark);
+#endif
+
+    GREATEST_MAIN_END();
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+static const char GUILD_JSON[] =
+    "{\"id\":\"939234213521760270\",\"name\":\"concord\",\"roles\":["
+    "{\"id\":\"1\",\"name\":\"@everyone\",\"tags\":{\"bot_id\":\"7\"}},"
+    "{\"id\":\"2\",\"name\":\"admin\"}],\"channels\":["
+    "{\"id\":\"3\",\"name\":\"general\",\"topic\":\"hi\"},"
+    "{\"id\":\"4\",\"name\":\"voice\",\"type\":2}],"
+    "\"features\":[\"COMMUNITY\",\"NEWS\"],\"verification_level\":2,"
+    "\"emojis\":[{\"id\":\"5\",\"name\":\"blob\"}]}";
+
+static struct discord_guild guild;
+
+static void
+setup(void *data)
+{
+    (void)data;
+    memset(&guild, 0, sizeof(guild));
+    discord_guild_from_json(GUILD_JSON, sizeof(GUILD_JSON) - 1, &guild);
+}
+
+static void
+teardown(void *data)
+{
+    (void)data;
+    discord_guild_cleanup(&guild);
+}
+
+TEST
+check_copy(void)
+{
+    struct discord_guild copy;
+
+    ASSERT(discord_guild_copy(&copy, &guild));
+
+    ASSERT_EQ(guild.id, copy.id);
+    ASSERT_EQ(2, copy.verification_level);
+    ASSERT_STR_EQ("concord", copy.name);
+    ASSERT(copy.name != guild.name);
+
+    ASSERT_EQ(2, copy.roles->size);
+    ASSERT(copy.roles->array != guild.roles->array);
+    ASSERT_STR_EQ("@everyone", copy.roles->array[0].name);
+    ASSERT_EQ(7ULL, copy.roles->array[0].tags->bot_id);
+    ASSERT(copy.roles->array[0].tags != guild.roles->array[0].tags);
+    ASSERT_EQ(NULL, copy.roles->array[1].tags);
+
+    ASSERT_STR_EQ("hi", copy.channels->array[0].topic);
+    ASSERT_EQ(NULL, copy.channels->array[1].topic);
+    ASSERT_STR_EQ("NEWS", copy.features->array[1]);
+    ASSERT(copy.features->array[1] != guild.features->array[1]);
+    ASSERT_EQ(NULL, copy.members);
+
+    /* the copy outlives the original */
+    discord_guild_cleanup(&guild);
+    memset(&guild, 0, sizeof(guild));
+    ASSERT_STR_EQ("admin", copy.roles->array[1].name);
+
+    discord_guild_cleanup(&copy);
+    PASS();
+}
+
+TEST
+check_copy_from_arena(void)
+{
+    struct discord_guild *flat, copy;
+    jsmntok_t *tokens = NULL;
+    jsmnf_pair *pairs = NULL;
+    unsigned ntokens = 0, npairs = 0;
+    jsmn_parser parser;
+    jsmnf_loader loader;
+
+    jsmn_init(&parser);
+    ASSERT(jsmn_parse_auto(&parser, GUILD_JSON, sizeof(GUILD_JSON) - 1,
+                           &tokens, &ntokens)
+           > 0);
+    jsmnf_init(&loader);
+    ASSERT(jsmnf_load_auto(&loader, GUILD_JSON, tokens, parser.toknext,
+                           &pairs, &npairs)
+           > 0);
+
+    /* events are decoded into a single block, the cache keeps a copy */
+    ASSERT(discord_guild_from_jsmnf_flat(pairs, GUILD_JSON, &flat) > 0);
+    ASSERT(discord_guild_copy(&copy, flat));
+    free(flat);
+
+    ASSERT_STR_EQ("general", copy.channels->array[0].name);
+    ASSERT_STR_EQ("blob", copy.emojis->array[0].name);
+    discord_guild_cleanup(&copy);
+
+    free(pairs);
+    free(tokens);
+    PASS();
+}
+
+TEST
+check_move(void)
+{
+    struct discord_guild moved;
+    char *name = guild.name;
+
+    discord_guild_move(&moved, &guild);
+    ASSERT_EQ(name, moved.name);
+    ASSERT_EQ(NULL, guild.name);
+    ASSERT_EQ(NULL, guild.roles);
+    ASSERT_EQ(0ULL, guild.id);
+
+    discord_guild_cleanup(&moved);
+    PASS();
+}
+
+SUITE(codec_copy)
+{
+    SET_SETUP(setup, NULL);
+    SET_TEARDOWN(teardown, NULL);
+
+    RUN_TEST(check_copy);
+    RUN_TEST(check_copy_from_arena);
+    RUN_TEST(check_move);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_COPIES 20000
+
+TEST
+bench_copy_vs_json(void)
+{
+    uint64_t tstart, json_us, copy_us;
+    static char buf[0x40000];
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_COPIES; ++i) {
+        struct discord_guild copy = { 0 };
+        const size_t size = discord_guild_to_json(buf, sizeof buf, &guild);
+
+        discord_guild_from_json(buf, size, &copy);
+        discord_guild_cleanup(&copy);
+    }
+    json_us = cog_timestamp_us() - tstart;
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_COPIES; ++i) {
+        struct discord_guild copy;
+
+        discord_guild_copy(&copy, &guild);
+        discord_guild_cleanup(&copy);
+    }
+    copy_us = cog_timestamp_us() - tstart;
+
+    fprintf(stderr,
+            "GUILD copy: JSON round-trip %7.1f ns/copy, "
+            "deep copy %7.1f ns/copy\n",
+            json_us * 1000.0 / BENCH_COPIES, copy_us * 1000.0 / BENCH_COPIES);
+    PASS();
+}
+
+SUITE(codec_copy_benchmark)
+{
+    SET_SETUP(setup, NULL);
+    SET_TEARDOWN(teardown, NULL);
+
+    RUN_TEST(bench_copy_vs_json);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(codec_copy);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(codec_copy_benchmark);
+#endif
+
+    GREATEST_MAIN_END();
+}
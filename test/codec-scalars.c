@@ -0,0 +1,325 @@
+#define _DEFAULT_SOURCE /* timegm() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+static char *members_chunk;
+static size_t members_chunk_size;
+
+static void
+build_members(unsigned nmembers)
+{
+    size_t cap = 256 + nmembers * 512, len = 0;
+
+    members_chunk = malloc(cap);
+    members_chunk[len++] = '[';
+    for (unsigned i = 0; i < nmembers; ++i) {
+        len += sprintf(
+            members_chunk + len,
+            "%s{\"user\":{\"username\":\"member %u\",\"public_flags\":%u,"
+            "\"id\":\"%llu\",\"discriminator\":\"%04u\",\"avatar\":null},"
+            "\"roles\":[\"939234213521760271\",\"%llu\"],\"nick\":null,"
+            "\"joined_at\":\"2022-%02u-%02uT%02u:%02u:%02u.%06u+00:00\","
+            "\"premium_since\":null,\"permissions\":\"%llu\","
+            "\"deaf\":false,\"mute\":false,"
+            "\"guild_id\":\"939234213521760270\"}",
+            i ? "," : "", i, i % 256, 140931563499159552ULL + i,
+            i % 10000, 939234213521760272ULL + i * 7919, 1 + i % 12,
+            1 + i % 28, i % 24, i % 60, (i * 7) % 60, i * 997 % 1000000,
+            (unsigned long long)i * 2199023255551ULL);
+    }
+    len += sprintf(members_chunk + len, "]");
+    members_chunk_size = len;
+}
+
+/* the decoders' previous behavior, to compare against */
+static uint64_t
+iso8601_via_libc(const char str[])
+{
+    double seconds = 0.0;
+    struct tm tm = { 0 };
+
+    sscanf(str, "%d-%d-%dT%d:%d:%lf", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+           &tm.tm_hour, &tm.tm_min, &seconds);
+    tm.tm_mon--;
+    tm.tm_year -= 1900;
+    tm.tm_sec = (int)seconds;
+    return (uint64_t)timegm(&tm) * 1000
+           + (uint64_t)((seconds - (int)seconds) * 1000.0 + 1e-6);
+}
+
+TEST
+check_strtou64(void)
+{
+    static const struct {
+        const char *str;
+        int ret;
+        uint64_t value;
+    } vectors[] = {
+        { "0", 1, 0 },
+        { "7", 1, 7 },
+        { "12345678", 1, 12345678 },
+        { "939234213521760276", 1, 939234213521760276ULL },
+        { "18446744073709551615", 1, UINT64_MAX },
+        { "18446744073709551616", 1, UINT64_MAX },
+        { "99999999999999999999999", 1, UINT64_MAX },
+        { "0000000000000000000042", 1, 42 },
+        { "1234567a", 1, 1234567 },
+        { "123456789\"", 1, 123456789 },
+        { "", 0, 0 },
+        { "null", 0, 0 },
+        { "-1", 0, 0 },
+        { "/", 0, 0 },
+        { ":", 0, 0 },
+    };
+    char digits[32];
+
+    for (size_t i = 0; i < sizeof(vectors) / sizeof *vectors; ++i) {
+        uint64_t value = 0xdead;
+
+        ASSERT_EQm(vectors[i].str, vectors[i].ret,
+                   cog_strtou64(vectors[i].str, strlen(vectors[i].str),
+                                &value));
+        ASSERT_EQ_FMTm(vectors[i].str,
+                       vectors[i].ret ? vectors[i].value : 0xdead, value,
+                       "%" PRIu64);
+    }
+
+    /* never reads past `len` */
+    {
+        uint64_t value;
+        ASSERT(cog_strtou64("123456789", 3, &value));
+        ASSERT_EQ(123, value);
+    }
+
+    srand(23);
+    for (int i = 0; i < 100000; ++i) {
+        const int ndigits = 1 + rand() % 20;
+        uint64_t value;
+
+        for (int j = 0; j < ndigits; ++j)
+            digits[j] = '0' + rand() % 10;
+        digits[ndigits] = '\0';
+        ASSERT(cog_strtou64(digits, ndigits, &value));
+        ASSERT_EQ_FMTm(digits, (uint64_t)strtoull(digits, NULL, 10), value,
+                       "%" PRIu64);
+    }
+    PASS();
+}
+
+TEST
+check_strtoi64(void)
+{
+    int64_t value;
+
+    ASSERT(cog_strtoi64("42", 2, &value));
+    ASSERT_EQ(42, value);
+    ASSERT(cog_strtoi64("-42,", 4, &value));
+    ASSERT_EQ(-42, value);
+    ASSERT(cog_strtoi64("-0", 2, &value));
+    ASSERT_EQ(0, value);
+    ASSERT(cog_strtoi64("-9223372036854775808", 20, &value));
+    ASSERT_EQ(INT64_MIN, value);
+    ASSERT(cog_strtoi64("9223372036854775808", 19, &value));
+    ASSERT_EQ(INT64_MAX, value);
+    value = 5;
+    ASSERT_FALSE(cog_strtoi64("-", 1, &value));
+    ASSERT_FALSE(cog_strtoi64("", 0, &value));
+    ASSERT_FALSE(cog_strtoi64("true", 4, &value));
+    ASSERT_EQ(5, value);
+    PASS();
+}
+
+TEST
+check_iso8601(void)
+{
+    uint64_t value;
+    char str[64];
+
+    ASSERT(cog_iso8601_to_unix_ms("2022-09-02T18:15:12.345000+00:00", 32,
+                                  &value));
+    ASSERT_EQ_FMT((uint64_t)1662142512345, value, "%" PRIu64);
+    ASSERT(cog_iso8601_to_unix_ms("2022-09-02T18:15:12+00:00", 25, &value));
+    ASSERT_EQ_FMT((uint64_t)1662142512000, value, "%" PRIu64);
+    ASSERT(cog_iso8601_to_unix_ms("2022-09-02T18:15:12.3Z", 22, &value));
+    ASSERT_EQ_FMT((uint64_t)1662142512300, value, "%" PRIu64);
+    ASSERT(cog_iso8601_to_unix_ms("2022-09-02T23:45:12.000+05:30", 29,
+                                  &value));
+    ASSERT_EQ_FMT((uint64_t)1662142512000, value, "%" PRIu64);
+    ASSERT(cog_iso8601_to_unix_ms("2022-09-02T12:15:12-06:00", 25, &value));
+    ASSERT_EQ_FMT((uint64_t)1662142512000, value, "%" PRIu64);
+    ASSERT(cog_iso8601_to_unix_ms("1970-01-01T00:00:00.000000+00:00", 32,
+                                  &value));
+    ASSERT_EQ_FMT((uint64_t)0, value, "%" PRIu64);
+    ASSERT(cog_iso8601_to_unix_ms("2024-02-29T00:00:00.000000+00:00", 32,
+                                  &value));
+    ASSERT_EQ_FMT((uint64_t)1709164800000, value, "%" PRIu64);
+
+    /* every day of a few centuries, leap years included */
+    for (time_t t = 0; t < (time_t)4102444800; t += 86400 + 3723) {
+        const struct tm *tm = gmtime(&t);
+        const int len = (int)strftime(str, sizeof(str),
+                                      "%Y-%m-%dT%H:%M:%S.250000+00:00", tm);
+
+        ASSERT(cog_iso8601_to_unix_ms(str, len, &value));
+        ASSERT_EQ_FMTm(str, (uint64_t)t * 1000 + 250, value, "%" PRIu64);
+        ASSERT_EQ_FMTm(str, iso8601_via_libc(str), value, "%" PRIu64);
+    }
+    PASS();
+}
+
+TEST
+check_decoders(void)
+{
+    static const char JSON[] =
+        "{\"id\":\"939234213521760276\",\"type\":-3,\"position\":12,"
+        "\"last_pin_timestamp\":\"2022-09-02T18:15:12.345000+00:00\","
+        "\"permissions\":\"2199023255551\",\"guild_id\":null,"
+        "\"name\":\"general\"}";
+    struct discord_channel channel = { 0 };
+    struct discord_guild_members members = { 0 };
+
+    ASSERT_GT(discord_channel_from_json(JSON, sizeof(JSON) - 1, &channel), 0);
+    ASSERT_EQ_FMT((u64snowflake)939234213521760276ULL, channel.id,
+                  "%" PRIu64);
+    ASSERT_EQ(-3, (int)channel.type);
+    ASSERT_EQ(12, channel.position);
+    ASSERT_EQ_FMT((u64unix_ms)1662142512345, channel.last_pin_timestamp,
+                  "%" PRIu64);
+    ASSERT_EQ_FMT((u64bitmask)2199023255551ULL, channel.permissions,
+                  "%" PRIu64);
+    ASSERT_EQ(0, channel.guild_id);
+    discord_channel_cleanup(&channel);
+
+    ASSERT_GT(discord_guild_members_from_json(members_chunk,
+                                              members_chunk_size, &members),
+              0);
+    ASSERT_EQ(1000, members.size);
+    for (int i = 0; i < members.size; ++i) {
+        const struct discord_guild_member *m = members.array + i;
+        char joined_at[64];
+
+        ASSERT_EQ_FMT((uint64_t)140931563499159552ULL + i, m->user->id,
+                      "%" PRIu64);
+        ASSERT_EQ(i % 256, m->user->public_flags);
+        ASSERT_EQ_FMT((uint64_t)939234213521760272ULL + i * 7919,
+                      m->roles->array[1], "%" PRIu64);
+        ASSERT_EQ_FMT(i * (uint64_t)2199023255551, m->permissions,
+                      "%" PRIu64);
+        snprintf(joined_at, sizeof(joined_at),
+                 "2022-%02u-%02uT%02u:%02u:%02u.%06u", 1 + i % 12,
+                 1 + i % 28, i % 24, i % 60, (i * 7) % 60,
+                 i * 997 % 1000000);
+        ASSERT_EQ_FMT(iso8601_via_libc(joined_at), m->joined_at, "%" PRIu64);
+        ASSERT_EQ(0, m->premium_since);
+    }
+    discord_guild_members_cleanup(&members);
+    PASS();
+}
+
+SUITE(codec_scalars)
+{
+    RUN_TEST(check_strtou64);
+    RUN_TEST(check_strtoi64);
+    RUN_TEST(check_iso8601);
+    RUN_TEST(check_decoders);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_ROUNDS 200
+
+TEST
+bench_kernels(void)
+{
+    static const char SNOWFLAKE[] = "939234213521760276",
+                      TIMESTAMP[] = "2022-09-02T18:15:12.345000+00:00";
+    uint64_t tstart, value, sum = 0;
+    double scanf_ns, strtou64_ns, libc_ns, iso8601_ns;
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS * 1000; ++i) {
+        sscanf(SNOWFLAKE, "%" SCNu64, &value);
+        sum += value;
+    }
+    scanf_ns = (cog_timestamp_us() - tstart) * 1000.0 / (BENCH_ROUNDS * 1000);
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS * 1000; ++i) {
+        cog_strtou64(SNOWFLAKE, sizeof(SNOWFLAKE) - 1, &value);
+        sum += value;
+    }
+    strtou64_ns =
+        (cog_timestamp_us() - tstart) * 1000.0 / (BENCH_ROUNDS * 1000);
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS * 1000; ++i)
+        sum += iso8601_via_libc(TIMESTAMP);
+    libc_ns = (cog_timestamp_us() - tstart) * 1000.0 / (BENCH_ROUNDS * 1000);
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS * 1000; ++i) {
+        cog_iso8601_to_unix_ms(TIMESTAMP, sizeof(TIMESTAMP) - 1, &value);
+        sum += value;
+    }
+    iso8601_ns =
+        (cog_timestamp_us() - tstart) * 1000.0 / (BENCH_ROUNDS * 1000);
+
+    fprintf(stderr,
+            "snowflake: %.1f ns sscanf(), %.1f ns cog_strtou64()\n"
+            "timestamp: %.1f ns sscanf()+timegm(), %.1f ns "
+            "cog_iso8601_to_unix_ms()\n",
+            scanf_ns, strtou64_ns, libc_ns, iso8601_ns);
+    ASSERT(sum != 0);
+    PASS();
+}
+
+TEST
+bench_members(void)
+{
+    uint64_t tstart = cog_timestamp_us();
+
+    for (int i = 0; i < BENCH_ROUNDS; ++i) {
+        struct discord_guild_members members = { 0 };
+
+        discord_guild_members_from_json(members_chunk, members_chunk_size,
+                                        &members);
+        discord_guild_members_cleanup(&members);
+    }
+    fprintf(stderr, "1000 guild members, %zu bytes: %.1f us/decode\n",
+            members_chunk_size,
+            (double)(cog_timestamp_us() - tstart) / BENCH_ROUNDS);
+    PASS();
+}
+
+SUITE(codec_scalars_benchmark)
+{
+    RUN_TEST(bench_kernels);
+    RUN_TEST(bench_members);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    build_members(1000);
+
+    RUN_SUITE(codec_scalars);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(codec_scalars_benchmark);
+#endif
+
+    free(members_chunk);
+
+    GREATEST_MAIN_END();
+}
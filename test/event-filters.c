@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+#include "json-fixture.h"
+
+static const char MESSAGE[] =
+    "{\"id\":\"1014990303337226250\",\"channel_id\":\"939234213521760276\","
+    "\"guild_id\":\"939234213521760270\",\"content\":\"hi\","
+    "\"author\":{\"id\":\"140931563499159552\",\"username\":\"concord\","
+    "\"bot\":true}}";
+static const char DIRECT_MESSAGE[] =
+    "{\"id\":\"1014990303337226251\",\"channel_id\":\"939234213521760277\","
+    "\"content\":\"hi\","
+    "\"author\":{\"id\":\"140931563499159553\",\"username\":\"user\"}}";
+static const char GUILD[] =
+    "{\"id\":\"939234213521760270\",\"name\":\"concord\"}";
+
+static struct json_fixture fx;
+
+TEST
+check_id_set(void)
+{
+    struct discord_id_set *set = discord_id_set_init();
+
+    for (u64snowflake id = 1; id <= 1000; ++id)
+        discord_id_set_add(set, id << 22);
+    for (u64snowflake id = 1; id <= 1000; ++id)
+        ASSERT(discord_id_set_contains(set, id << 22));
+    ASSERT_FALSE(discord_id_set_contains(set, 1001ULL << 22));
+    ASSERT_FALSE(discord_id_set_contains(set, 0));
+
+    discord_id_set_cleanup(set);
+    PASS();
+}
+
+TEST
+check_builtin_filters(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_id_set *guilds = discord_id_set_init(),
+                          *users = discord_id_set_init();
+    struct discord_gateway_payload payload = { 0 };
+
+    discord_id_set_add(guilds, 939234213521760270ULL);
+    discord_id_set_add(users, 140931563499159553ULL);
+
+    ASSERT_EQ(CCORD_OK,
+              discord_add_event_filter(client, DISCORD_EV_MESSAGE_CREATE,
+                                       &discord_filter_guilds, guilds));
+    ASSERT_EQ(CCORD_OK,
+              discord_add_event_filter(client, DISCORD_EV_GUILD_CREATE,
+                                       &discord_filter_guilds, guilds));
+    ASSERT_EQ(CCORD_BAD_PARAMETER,
+              discord_add_event_filter(client, DISCORD_EV_MAX,
+                                       &discord_filter_guilds, guilds));
+
+    /* guild in set */
+    json_fixture_payload(&fx, &payload, DISCORD_EV_MESSAGE_CREATE, MESSAGE);
+    ASSERT(discord_event_filters_pass(&client->filters, &payload));
+    json_fixture_payload(&fx, &payload, DISCORD_EV_GUILD_CREATE, GUILD);
+    ASSERT(discord_event_filters_pass(&client->filters, &payload));
+    /* DMs aren't guild-specific */
+    json_fixture_payload(&fx, &payload, DISCORD_EV_MESSAGE_CREATE,
+                         DIRECT_MESSAGE);
+    ASSERT(discord_event_filters_pass(&client->filters, &payload));
+
+    /* bot author */
+    discord_add_event_filter(client, DISCORD_EV_MESSAGE_CREATE,
+                             &discord_filter_no_bots, NULL);
+    json_fixture_payload(&fx, &payload, DISCORD_EV_MESSAGE_CREATE, MESSAGE);
+    ASSERT_FALSE(discord_event_filters_pass(&client->filters, &payload));
+    json_fixture_payload(&fx, &payload, DISCORD_EV_MESSAGE_CREATE,
+                         DIRECT_MESSAGE);
+    ASSERT(discord_event_filters_pass(&client->filters, &payload));
+
+    /* user not in set */
+    ASSERT_FALSE(discord_filter_users(client, DISCORD_EV_MESSAGE_CREATE,
+                                      payload.data, payload.json.start,
+                                      guilds));
+    ASSERT(discord_filter_users(client, DISCORD_EV_MESSAGE_CREATE,
+                                payload.data, payload.json.start, users));
+
+    /* channel not in set */
+    ASSERT_FALSE(discord_filter_channels(client, DISCORD_EV_MESSAGE_CREATE,
+                                         payload.data, payload.json.start,
+                                         users));
+
+    /* unfiltered event */
+    json_fixture_payload(&fx, &payload, DISCORD_EV_MESSAGE_UPDATE, MESSAGE);
+    ASSERT(discord_event_filters_pass(&client->filters, &payload));
+
+    json_fixture_cleanup(&fx);
+    discord_id_set_cleanup(guilds);
+    discord_id_set_cleanup(users);
+    discord_cleanup(client);
+    PASS();
+}
+
+SUITE(event_filters)
+{
+    RUN_TEST(check_id_set);
+    RUN_TEST(check_builtin_filters);
+}
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(event_filters);
+
+    GREATEST_MAIN_END();
+}
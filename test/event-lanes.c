@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+#include "json-fixture.h"
+
+#define NGUILDS  8
+#define NEVENTS  4000
+#define NLANES   4
+
+static struct json_fixture fx;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static u64snowflake last_id[NGUILDS];
+static int out_of_order, handled;
+
+static void
+on_message(struct discord *client, const struct discord_message *event)
+{
+    const int guild = (int)(event->guild_id - 1);
+    (void)client;
+
+    pthread_mutex_lock(&lock);
+    if (event->id <= last_id[guild]) ++out_of_order;
+    last_id[guild] = event->id;
+    ++handled;
+    pthread_mutex_unlock(&lock);
+}
+
+TEST
+check_lane_keys(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_gateway_payload payload = { 0 };
+    int a, b;
+
+    ASSERT_EQ(-1, discord_event_lanes_get(&client->lanes, &payload));
+    ASSERT_EQ(CCORD_OK, discord_set_event_lanes(client, NLANES));
+    ASSERT_EQ(CCORD_BAD_PARAMETER,
+              discord_set_event_lane_key(client, DISCORD_EV_MAX,
+                                         DISCORD_EVENT_LANE_CHANNEL));
+
+    /* guild_id by default */
+    json_fixture_payload(
+        &fx, &payload, DISCORD_EV_MESSAGE_CREATE,
+        "{\"guild_id\":\"939234213521760270\",\"channel_id\":\"1\"}");
+    a = discord_event_lanes_get(&client->lanes, &payload);
+    json_fixture_payload(&fx, &payload, DISCORD_EV_GUILD_CREATE,
+                         "{\"id\":\"939234213521760270\"}");
+    b = discord_event_lanes_get(&client->lanes, &payload);
+    ASSERT_EQ(a, b);
+
+    /* channel_id when keyed by channel, or when there's no guild */
+    discord_set_event_lane_key(client, DISCORD_EV_MESSAGE_CREATE,
+                               DISCORD_EVENT_LANE_CHANNEL);
+    json_fixture_payload(
+        &fx, &payload, DISCORD_EV_MESSAGE_CREATE,
+        "{\"guild_id\":\"1\",\"channel_id\":\"939234213521760276\"}");
+    a = discord_event_lanes_get(&client->lanes, &payload);
+    json_fixture_payload(&fx, &payload, DISCORD_EV_MESSAGE_UPDATE,
+                         "{\"channel_id\":\"939234213521760276\"}");
+    b = discord_event_lanes_get(&client->lanes, &payload);
+    ASSERT_EQ(a, b);
+
+    /* unkeyed events go to the first lane */
+    json_fixture_payload(&fx, &payload, DISCORD_EV_READY, "{\"v\":10}");
+    ASSERT_EQ(0, discord_event_lanes_get(&client->lanes, &payload));
+
+    json_fixture_cleanup(&fx);
+    discord_cleanup(client);
+    PASS();
+}
+
+TEST
+check_lane_order(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_gateway *gw = &client->gw;
+    char js[128];
+
+    discord_set_on_message_create(client, &on_message);
+    ASSERT_EQ(CCORD_UNAVAILABLE,
+              discord_event_lanes_add(&client->lanes, gw));
+    ASSERT_EQ(CCORD_OK, discord_set_event_lanes(client, NLANES));
+
+    for (int i = 1; i <= NEVENTS; ++i) {
+        snprintf(js, sizeof(js),
+                 "{\"id\":\"%d\",\"guild_id\":\"%d\",\"channel_id\":\"%d\"}",
+                 i, 1 + i % NGUILDS, 1000 + i % 3);
+        json_fixture_payload(&fx, &gw->payload, DISCORD_EV_MESSAGE_CREATE, js);
+        ASSERT_EQ(CCORD_OK, discord_event_lanes_add(&client->lanes, gw));
+    }
+    json_fixture_cleanup(&fx);
+    gw->payload.data = NULL;
+    gw->payload.json.start = NULL;
+
+    /* pending events are handled before the lanes are stopped */
+    discord_set_event_lanes(client, 0);
+    ASSERT_EQ(NEVENTS, handled);
+    ASSERT_EQ(0, out_of_order);
+
+    discord_cleanup(client);
+    PASS();
+}
+
+static int wrong_shard;
+
+static void
+on_message_shard(struct discord *client, const struct discord_message *event)
+{
+    (void)event;
+
+    pthread_mutex_lock(&lock);
+    if (discord_get_shard_id(client) != 1) ++wrong_shard;
+    ++handled;
+    pthread_mutex_unlock(&lock);
+}
+
+TEST
+check_lane_shard_id(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_gateway *gw;
+    char js[128];
+
+    ASSERT_EQ(CCORD_OK, discord_set_shards(client, 0, 2, 2));
+    gw = SHARD(client, 1);
+    discord_set_on_message_create(client, &on_message_shard);
+    ASSERT_EQ(CCORD_OK, discord_set_event_lanes(client, NLANES));
+
+    handled = 0;
+    for (int i = 1; i <= NEVENTS; ++i) {
+        snprintf(js, sizeof(js),
+                 "{\"id\":\"%d\",\"guild_id\":\"%d\"}", i,
+                 1 + i % NGUILDS);
+        json_fixture_payload(&fx, &gw->payload, DISCORD_EV_MESSAGE_CREATE, js);
+        /* what the main thread would be dispatching meanwhile */
+        client->shards.current = 0;
+        ASSERT_EQ(CCORD_OK, discord_event_lanes_add(&client->lanes, gw));
+    }
+    json_fixture_cleanup(&fx);
+    gw->payload.data = NULL;
+    gw->payload.json.start = NULL;
+
+    discord_set_event_lanes(client, 0);
+    ASSERT_EQ(NEVENTS, handled);
+    ASSERT_EQ(0, wrong_shard);
+    /* the main thread isn't dispatching a worker's event */
+    ASSERT_EQ(0, discord_get_shard_id(client));
+
+    discord_cleanup(client);
+    PASS();
+}
+
+static CCORDcode from_lane_code;
+
+static void
+on_message_restart(struct discord *client,
+                   const struct discord_message *event)
+{
+    (void)event;
+
+    pthread_mutex_lock(&lock);
+    from_lane_code = discord_set_event_lanes(client, NLANES);
+    ++handled;
+    pthread_mutex_unlock(&lock);
+}
+
+TEST
+check_lane_self_restart(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_gateway *gw = &client->gw;
+
+    discord_set_on_message_create(client, &on_message_restart);
+    ASSERT_EQ(CCORD_OK, discord_set_event_lanes(client, NLANES));
+
+    handled = 0;
+    from_lane_code = CCORD_OK;
+    json_fixture_payload(&fx, &gw->payload, DISCORD_EV_MESSAGE_CREATE,
+                         "{\"id\":\"1\",\"guild_id\":\"1\"}");
+    ASSERT_EQ(CCORD_OK, discord_event_lanes_add(&client->lanes, gw));
+    json_fixture_cleanup(&fx);
+    gw->payload.data = NULL;
+    gw->payload.json.start = NULL;
+
+    /* a lane can't join itself */
+    discord_set_event_lanes(client, 0);
+    ASSERT_EQ(1, handled);
+    ASSERT_EQ(CCORD_BAD_PARAMETER, from_lane_code);
+    ASSERT_FALSE(discord_event_lanes_is_lane(&client->lanes));
+
+    discord_cleanup(client);
+    PASS();
+}
+
+static bool checking;
+
+static void *
+check_lanes_loop(void *p_client)
+{
+    struct discord *client = p_client;
+    struct discord_gateway_payload payload = { 0 };
+    struct json_fixture fixture = { 0 };
+    bool running = true;
+    int wrong = 0;
+
+    json_fixture_payload(&fixture, &payload, DISCORD_EV_MESSAGE_CREATE,
+                         "{\"id\":\"1\",\"guild_id\":\"1\"}");
+    while (running) {
+        if (discord_event_lanes_is_lane(&client->lanes)
+            || discord_event_lanes_get(&client->lanes, &payload) >= NLANES)
+        {
+            ++wrong;
+        }
+        pthread_mutex_lock(&lock);
+        running = checking;
+        pthread_mutex_unlock(&lock);
+    }
+    json_fixture_cleanup(&fixture);
+    return (void *)(intptr_t)wrong;
+}
+
+TEST
+check_lane_concurrent_restart(void)
+{
+    struct discord *client = discord_init("");
+    pthread_t tid;
+    void *wrong;
+
+    checking = true;
+    ASSERT_EQ(0, pthread_create(&tid, NULL, &check_lanes_loop, client));
+    /* the lanes are replaced while another thread looks them up */
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(CCORD_OK, discord_set_event_lanes(client, 1 + i % NLANES));
+    pthread_mutex_lock(&lock);
+    checking = false;
+    pthread_mutex_unlock(&lock);
+    pthread_join(tid, &wrong);
+    ASSERT_EQ(0, (int)(intptr_t)wrong);
+
+    discord_cleanup(client);
+    PASS();
+}
+
+SUITE(event_lanes)
+{
+    RUN_TEST(check_lane_keys);
+    RUN_TEST(check_lane_order);
+    RUN_TEST(check_lane_shard_id);
+    RUN_TEST(check_lane_self_restart);
+    RUN_TEST(check_lane_concurrent_restart);
+}
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(event_lanes);
+
+    GREATEST_MAIN_END();
+}
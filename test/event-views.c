@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+#include "json-fixture.h"
+
+static const char MESSAGE[] =
+    "{\"id\":\"1014990303337226250\",\"channel_id\":\"939234213521760276\","
+    "\"guild_id\":\"939234213521760270\",\"type\":0,\"tts\":false,"
+    "\"content\":\"hello \\\"world\\\"\",\"pinned\":false,"
+    "\"timestamp\":\"2022-09-02T18:15:12.345000+00:00\","
+    "\"edited_timestamp\":null,\"mention_everyone\":false,"
+    "\"author\":{\"id\":\"140931563499159552\",\"username\":\"concord\","
+    "\"discriminator\":\"0001\",\"avatar\":null,\"bot\":true},"
+    "\"member\":{\"roles\":[\"939234213521760271\",\"939234213521760272\"],"
+    "\"nick\":null,\"joined_at\":\"2022-02-04T00:00:00.000000+00:00\","
+    "\"deaf\":false,\"mute\":false},"
+    "\"mentions\":[{\"id\":\"140931563499159553\",\"username\":\"a\"},"
+    "{\"id\":\"140931563499159554\",\"username\":\"b\"}],"
+    "\"mention_roles\":[],\"attachments\":[],"
+    "\"embeds\":[{\"title\":\"embed\",\"description\":\"desc\","
+    "\"fields\":[{\"name\":\"f1\",\"value\":\"v1\",\"inline\":true}]}]}";
+
+static struct json_fixture fx;
+
+TEST
+check_view_fields(void)
+{
+    struct discord_message_view view =
+        discord_message_view_of(
+            json_fixture_load(&fx, MESSAGE, sizeof(MESSAGE) - 1), MESSAGE);
+    struct ccord_szbuf_readonly content = DISCORD_VIEW_GET(&view, content);
+    struct discord_user_view author = DISCORD_VIEW_GET(&view, author);
+    struct ccord_szbuf_readonly username = DISCORD_VIEW_GET(&author, username);
+
+    ASSERT_EQ_FMT(939234213521760276ULL,
+                  (unsigned long long)DISCORD_VIEW_GET(&view, channel_id),
+                  "%llu");
+    ASSERT_EQ_FMT(1662142512345ULL,
+                  (unsigned long long)DISCORD_VIEW_GET(&view, timestamp),
+                  "%llu");
+    ASSERT_EQ_FMT(0ULL,
+                  (unsigned long long)DISCORD_VIEW_GET(&view,
+                                                       edited_timestamp),
+                  "%llu");
+    ASSERT_EQ(false, DISCORD_VIEW_GET(&view, tts));
+    ASSERT_EQ(true, DISCORD_VIEW_GET(&author, bot));
+    ASSERT_STRN_EQ("hello \\\"world\\\"", content.start, content.size);
+    ASSERT_STRN_EQ("concord", username.start, username.size);
+    /* null strings are reported as missing */
+    ASSERT_EQ(NULL, DISCORD_VIEW_GET(&author, avatar).start);
+    PASS();
+}
+
+TEST
+check_view_lists(void)
+{
+    struct discord_message_view view =
+        discord_message_view_of(
+            json_fixture_load(&fx, MESSAGE, sizeof(MESSAGE) - 1), MESSAGE);
+    struct discord_users_view mentions = DISCORD_VIEW_GET(&view, mentions);
+    struct discord_embeds_view embeds = DISCORD_VIEW_GET(&view, embeds);
+    struct discord_guild_member_view member = DISCORD_VIEW_GET(&view, member);
+    struct snowflakes_view roles = DISCORD_VIEW_GET(&member, roles);
+    struct discord_reactions_view reactions;
+    struct discord_embed_fields_view fields;
+    struct discord_embed_field_view field;
+    struct discord_embed_view embed;
+    struct discord_user_view user;
+
+    ASSERT_EQ(2, DISCORD_VIEW_SIZE(&mentions));
+    user = DISCORD_VIEW_AT(&mentions, 1);
+    ASSERT_EQ_FMT(140931563499159554ULL,
+                  (unsigned long long)DISCORD_VIEW_GET(&user, id), "%llu");
+
+    ASSERT_EQ(2, DISCORD_VIEW_SIZE(&roles));
+    ASSERT_EQ_FMT(939234213521760272ULL,
+                  (unsigned long long)DISCORD_VIEW_AT(&roles, 1), "%llu");
+
+    ASSERT_EQ(1, DISCORD_VIEW_SIZE(&embeds));
+    embed = DISCORD_VIEW_AT(&embeds, 0);
+    fields = DISCORD_VIEW_GET(&embed, fields);
+    ASSERT_EQ(1, DISCORD_VIEW_SIZE(&fields));
+    field = DISCORD_VIEW_AT(&fields, 0);
+    ASSERT_EQ(true, DISCORD_VIEW_GET(&field, Inline));
+
+    /* missing lists are empty */
+    reactions = DISCORD_VIEW_GET(&view, reactions);
+    ASSERT_EQ(0, DISCORD_VIEW_SIZE(&reactions));
+    PASS();
+}
+
+static u64snowflake seen_channel_id, decoded_channel_id;
+static size_t seen_content_len;
+static int decoded_calls;
+
+static void
+on_message_view(struct discord *client,
+                const struct discord_message_view *event)
+{
+    (void)client;
+    seen_channel_id = DISCORD_VIEW_GET(event, channel_id);
+    seen_content_len = DISCORD_VIEW_GET(event, content).size;
+}
+
+static void
+on_message(struct discord *client, const struct discord_message *event)
+{
+    (void)client;
+    decoded_channel_id = event->channel_id;
+    ++decoded_calls;
+}
+
+TEST
+check_view_dispatch(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_gateway *gw = &client->gw;
+
+    discord_set_on_message_create_view(client, &on_message_view);
+    gw->payload.event = DISCORD_EV_MESSAGE_CREATE;
+    gw->payload.json.start = (char *)MESSAGE;
+    gw->payload.data = json_fixture_load(&fx, MESSAGE, sizeof(MESSAGE) - 1);
+
+    /* view only, the event isn't decoded */
+    discord_gateway_dispatch(gw, &gw->payload);
+    ASSERT_EQ_FMT(939234213521760276ULL, (unsigned long long)seen_channel_id,
+                  "%llu");
+    ASSERT_EQ(sizeof("hello \\\"world\\\"") - 1, seen_content_len);
+    ASSERT_EQ(0, decoded_calls);
+
+    /* both callbacks can be set simultaneously */
+    discord_set_on_message_create(client, &on_message);
+    seen_channel_id = 0;
+    discord_gateway_dispatch(gw, &gw->payload);
+    ASSERT_EQ(1, decoded_calls);
+    ASSERT_EQ_FMT((unsigned long long)seen_channel_id,
+                  (unsigned long long)decoded_channel_id, "%llu");
+
+    gw->payload.data = NULL;
+    gw->payload.json.start = NULL;
+    discord_cleanup(client);
+    PASS();
+}
+
+TEST
+check_event_dispatch(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_gateway *gw = &client->gw;
+    struct discord_gateway_event *event;
+    char *js = strdup(MESSAGE);
+
+    discord_set_on_message_create_view(client, &on_message_view);
+    discord_set_on_message_create(client, &on_message);
+    gw->payload.event = DISCORD_EV_MESSAGE_CREATE;
+    gw->payload.json.start = js;
+    gw->payload.data = json_fixture_load(&fx, js, sizeof(MESSAGE) - 1);
+
+    event = discord_gateway_event_init(gw);
+    ASSERT_EQ(sizeof(MESSAGE) - 1, event->size);
+
+    /* the shard moves on to the next event before the worker gets to run */
+    memset(js, ' ', sizeof(MESSAGE) - 1);
+    json_fixture_cleanup(&fx);
+    gw->payload.data = NULL;
+    gw->payload.json.start = NULL;
+    free(js);
+
+    seen_channel_id = decoded_channel_id = 0;
+    decoded_calls = 0;
+    discord_gateway_event_dispatch(event);
+    ASSERT_EQ_FMT(939234213521760276ULL, (unsigned long long)seen_channel_id,
+                  "%llu");
+    ASSERT_EQ(1, decoded_calls);
+    ASSERT_EQ_FMT(939234213521760276ULL,
+                  (unsigned long long)decoded_channel_id, "%llu");
+
+    discord_cleanup(client);
+    PASS();
+}
+
+SUITE(event_views)
+{
+    RUN_TEST(check_view_fields);
+    RUN_TEST(check_view_lists);
+    RUN_TEST(check_view_dispatch);
+    RUN_TEST(check_event_dispatch);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_ROUNDS 20000
+
+TEST
+bench_view_vs_decode(void)
+{
+    jsmnf_pair *root = json_fixture_load(&fx, MESSAGE, sizeof(MESSAGE) - 1);
+    volatile u64snowflake channel_id = 0;
+    volatile size_t len = 0;
+    uint64_t tstart;
+    double decode, view;
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS; ++i) {
+        struct discord_message *msg = calloc(1, sizeof *msg);
+
+        discord_message_from_jsmnf(root, MESSAGE, msg);
+        channel_id = msg->channel_id;
+        len = strlen(msg->content);
+        discord_message_cleanup(msg);
+        free(msg);
+    }
+    decode = (double)(cog_timestamp_us() - tstart) * 1000.0 / BENCH_ROUNDS;
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS; ++i) {
+        struct discord_message_view v = discord_message_view_of(root, MESSAGE);
+
+        channel_id = DISCORD_VIEW_GET(&v, channel_id);
+        len = DISCORD_VIEW_GET(&v, content).size;
+    }
+    view = (double)(cog_timestamp_us() - tstart) * 1000.0 / BENCH_ROUNDS;
+
+    (void)channel_id;
+    (void)len;
+    fprintf(stderr,
+            "MESSAGE_CREATE (content, channel_id) full decode: %8.1f "
+            "ns/event, view: %8.1f ns/event\n",
+            decode, view);
+    PASS();
+}
+
+SUITE(event_views_benchmark)
+{
+    RUN_TEST(bench_view_vs_decode);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(event_views);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(event_views_benchmark);
+#endif
+    json_fixture_cleanup(&fx);
+
+    GREATEST_MAIN_END();
+}
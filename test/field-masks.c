@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+#include "json-fixture.h"
+
+static const char MESSAGE[] =
+    "{\"id\":\"1014990303337226250\",\"channel_id\":\"939234213521760276\","
+    "\"guild_id\":\"939234213521760270\",\"type\":0,\"tts\":false,"
+    "\"content\":\"hello \\\"world\\\"\",\"pinned\":false,"
+    "\"timestamp\":\"2022-09-02T18:15:12.345000+00:00\","
+    "\"edited_timestamp\":null,\"mention_everyone\":false,"
+    "\"author\":{\"id\":\"140931563499159552\",\"username\":\"concord\","
+    "\"discriminator\":\"0001\",\"avatar\":null,\"bot\":true},"
+    "\"member\":{\"roles\":[\"939234213521760271\",\"939234213521760272\"],"
+    "\"nick\":null,\"joined_at\":\"2022-02-04T00:00:00.000000+00:00\","
+    "\"deaf\":false,\"mute\":false},"
+    "\"mentions\":[{\"id\":\"140931563499159553\",\"username\":\"a\"},"
+    "{\"id\":\"140931563499159554\",\"username\":\"b\"}],"
+    "\"mention_roles\":[],\"attachments\":[],"
+    "\"embeds\":[{\"title\":\"embed\",\"description\":\"desc\","
+    "\"fields\":[{\"name\":\"f1\",\"value\":\"v1\",\"inline\":true}]}]}";
+
+/* what a bot replying to commands typically needs */
+static const struct discord_message_mask MESSAGE_MASK = {
+    .id = true,
+    .channel_id = true,
+    .content = true,
+    .author = &(const struct discord_user_mask){ .id = true },
+    .mentions =
+        &(const struct discord_users_mask){
+            .array = &(const struct discord_user_mask){ .username = true },
+        },
+};
+
+static const struct discord_channels_mask CHANNELS_MASK = {
+    .array = &(const struct discord_channel_mask){ .id = true },
+};
+
+static struct json_fixture fx;
+
+TEST
+check_masked_decode(void)
+{
+    struct discord_message message = { 0 };
+    jsmnf_pair *root = json_fixture_load(&fx, MESSAGE, sizeof(MESSAGE) - 1);
+
+    ASSERT(root != NULL);
+    ASSERT(discord_message_from_jsmnf_masked(root, MESSAGE, &message,
+                                             &MESSAGE_MASK, NULL)
+           > 0);
+
+    ASSERT_EQ_FMT(1014990303337226250ULL, (unsigned long long)message.id,
+                  "%llu");
+    ASSERT_EQ_FMT(939234213521760276ULL,
+                  (unsigned long long)message.channel_id, "%llu");
+    ASSERT_STR_EQ("hello \"world\"", message.content);
+    ASSERT_EQ_FMT(140931563499159552ULL,
+                  (unsigned long long)message.author->id, "%llu");
+    ASSERT_EQ(2, message.mentions->size);
+    ASSERT_STR_EQ("b", message.mentions->array[1].username);
+
+    /* fields left out of the mask are skipped, nested ones included */
+    ASSERT_EQ(0ULL, message.guild_id);
+    ASSERT_EQ(0ULL, message.timestamp);
+    ASSERT_EQ(NULL, message.author->username);
+    ASSERT_EQ(false, message.author->bot);
+    ASSERT_EQ(0ULL, message.mentions->array[1].id);
+    ASSERT_EQ(NULL, message.member);
+    ASSERT_EQ(NULL, message.embeds);
+
+    discord_message_cleanup(&message);
+    json_fixture_cleanup(&fx);
+    PASS();
+}
+
+TEST
+check_mask_all(void)
+{
+    struct discord_message full = { 0 }, all = { 0 };
+    jsmnf_pair *root = json_fixture_load(&fx, MESSAGE, sizeof(MESSAGE) - 1);
+    long ret;
+
+    ASSERT(root != NULL);
+    ASSERT((ret = discord_message_from_jsmnf(root, MESSAGE, &full)) > 0);
+    ASSERT_EQ(ret, discord_message_from_jsmnf_masked(root, MESSAGE, &all,
+                                                &discord_message_mask_all,
+                                                NULL));
+
+    ASSERT_EQ(full.timestamp, all.timestamp);
+    ASSERT_STR_EQ(full.author->username, all.author->username);
+    ASSERT_EQ(full.member->roles->size, all.member->roles->size);
+    ASSERT_EQ(full.member->roles->array[1], all.member->roles->array[1]);
+    ASSERT_STR_EQ(full.embeds->array[0].fields->array[0].value,
+                  all.embeds->array[0].fields->array[0].value);
+
+    discord_message_cleanup(&full);
+    discord_message_cleanup(&all);
+    json_fixture_cleanup(&fx);
+    PASS();
+}
+
+TEST
+check_masked_from_json(void)
+{
+    static const char json[] =
+        "[{\"id\":\"1\",\"name\":\"a\",\"topic\":\"x\"},"
+        "{\"id\":\"2\",\"name\":\"b\",\"topic\":\"y\"}]";
+    struct discord_channels channels = { 0 };
+
+    /* what a REST response decodes when its `ret.mask` is set */
+    discord_channels_from_json_masked(json, sizeof(json) - 1, &channels,
+                                      &CHANNELS_MASK);
+    ASSERT_EQ(2, channels.size);
+    ASSERT_EQ(2ULL, channels.array[1].id);
+    ASSERT_EQ(NULL, channels.array[1].name);
+    ASSERT_EQ(NULL, channels.array[1].topic);
+    discord_channels_cleanup(&channels);
+    memset(&channels, 0, sizeof(channels));
+
+    /* a list left out of its mask isn't decoded at all */
+    discord_channels_from_json_masked(json, sizeof(json) - 1, &channels,
+                                      &(const struct discord_channels_mask){
+                                          .array = NULL });
+    ASSERT_EQ(0, channels.size);
+    ASSERT_EQ(NULL, channels.array);
+    PASS();
+}
+
+static struct discord_message seen;
+static int seen_calls;
+
+static void
+on_message(struct discord *client, const struct discord_message *event)
+{
+    (void)client;
+    seen.id = event->id;
+    seen.content = event->content;
+    seen.guild_id = event->guild_id;
+    seen.embeds = event->embeds;
+    ++seen_calls;
+}
+
+TEST
+check_masked_dispatch(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_gateway *gw = &client->gw;
+
+    ASSERT_EQ(CCORD_BAD_PARAMETER,
+              discord_set_event_mask(client, DISCORD_EV_NONE, &MESSAGE_MASK));
+    ASSERT_EQ(CCORD_OK,
+              discord_set_event_mask(client, DISCORD_EV_MESSAGE_CREATE,
+                                     &MESSAGE_MASK));
+
+    discord_set_on_message_create(client, &on_message);
+    gw->payload.event = DISCORD_EV_MESSAGE_CREATE;
+    gw->payload.json.start = (char *)MESSAGE;
+    gw->payload.data = json_fixture_load(&fx, MESSAGE, sizeof(MESSAGE) - 1);
+
+    discord_gateway_dispatch(gw, &gw->payload);
+    ASSERT_EQ(1, seen_calls);
+    ASSERT_EQ_FMT(1014990303337226250ULL, (unsigned long long)seen.id,
+                  "%llu");
+    ASSERT(seen.content != NULL);
+    ASSERT_EQ(0ULL, seen.guild_id);
+    ASSERT_EQ(NULL, seen.embeds);
+
+    /* unset, every field is decoded again */
+    discord_set_event_mask(client, DISCORD_EV_MESSAGE_CREATE, NULL);
+    discord_gateway_dispatch(gw, &gw->payload);
+    ASSERT_EQ(2, seen_calls);
+    ASSERT_EQ_FMT(939234213521760270ULL, (unsigned long long)seen.guild_id,
+                  "%llu");
+    ASSERT(seen.embeds != NULL);
+
+    gw->payload.data = NULL;
+    gw->payload.json.start = NULL;
+    json_fixture_cleanup(&fx);
+    discord_cleanup(client);
+    PASS();
+}
+
+SUITE(field_masks)
+{
+    RUN_TEST(check_masked_decode);
+    RUN_TEST(check_mask_all);
+    RUN_TEST(check_masked_from_json);
+    RUN_TEST(check_masked_dispatch);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_EVENTS 100000
+
+TEST
+bench_masked_decode(void)
+{
+    jsmnf_pair *root = json_fixture_load(&fx, MESSAGE, sizeof(MESSAGE) - 1);
+    uint64_t tstart, full_us, masked_us;
+    struct ccord_arena arena;
+
+    ASSERT(root != NULL);
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_EVENTS; ++i) {
+        struct discord_message *message;
+
+        cog_arena_init(&arena, sizeof *message + 2 * sizeof(MESSAGE));
+        message = cog_arena_alloc(&arena, sizeof *message);
+        discord_message_from_jsmnf_masked(root, MESSAGE, message, NULL,
+                                          &arena);
+        cog_arena_cleanup(&arena);
+    }
+    full_us = cog_timestamp_us() - tstart;
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_EVENTS; ++i) {
+        struct discord_message *message;
+
+        cog_arena_init(&arena, sizeof *message + 2 * sizeof(MESSAGE));
+        message = cog_arena_alloc(&arena, sizeof *message);
+        discord_message_from_jsmnf_masked(root, MESSAGE, message,
+                                          &MESSAGE_MASK, &arena);
+        cog_arena_cleanup(&arena);
+    }
+    masked_us = cog_timestamp_us() - tstart;
+
+    fprintf(stderr,
+            "MESSAGE_CREATE: full %6.1f ns/event, "
+            "masked %6.1f ns/event\n",
+            full_us * 1000.0 / BENCH_EVENTS,
+            masked_us * 1000.0 / BENCH_EVENTS);
+
+    json_fixture_cleanup(&fx);
+    PASS();
+}
+
+SUITE(field_masks_benchmark)
+{
+    RUN_TEST(bench_masked_decode);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(field_masks);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(field_masks_benchmark);
+#endif
+
+    GREATEST_MAIN_END();
+}
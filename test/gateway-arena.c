@@ -0,0 +1,284 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+#include "json-fixture.h"
+
+static const char MESSAGE_JSON[] =
+    "{\"id\":\"1014990303337226250\",\"channel_id\":\"939234213521760276\","
+    "\"guild_id\":\"939234213521760270\",\"content\":\"hello \\\"there\\\"\","
+    "\"tts\":false,\"nonce\":\"42\",\"author\":{"
+    "\"id\":\"140931563499159552\",\"username\":\"concord\"},"
+    "\"mentions\":[{\"id\":\"1\",\"username\":\"a\"},"
+    "{\"id\":\"2\",\"username\":\"b\"}],"
+    "\"embeds\":[{\"title\":\"first\",\"description\":\"an embed\","
+    "\"color\":255,\"footer\":{\"text\":\"footer\"},\"fields\":["
+    "{\"name\":\"f1\",\"value\":\"v1\",\"inline\":true},"
+    "{\"name\":\"f2\",\"value\":\"v2\"}]},"
+    "{\"title\":\"second\",\"image\":{\"url\":\"https://a.b/c.png\"}}]}";
+
+TEST
+check_arena_alloc(void)
+{
+    struct ccord_arena arena;
+    char *small, *big;
+
+    cog_arena_init(&arena, 0);
+    ASSERT_EQ(NULL, arena.block);
+
+    small = cog_arena_alloc(&arena, 3);
+    ASSERT(small != NULL);
+    ASSERT_EQ(0, (uintptr_t)small % 16);
+    ASSERT_EQ(0, small[0] | small[1] | small[2]);
+
+    /* doesn't fit the first block, the arena grows */
+    big = cog_arena_alloc(&arena, 1 << 16);
+    ASSERT(big != NULL);
+    ASSERT_EQ(0, (uintptr_t)big % 16);
+    memset(big, 0xff, 1 << 16);
+    ASSERT_EQ(0, small[0]);
+
+    cog_arena_cleanup(&arena);
+    ASSERT_EQ(NULL, arena.block);
+    PASS();
+}
+
+TEST
+check_arena_decode(void)
+{
+    struct discord_message heap = { 0 }, arena_msg = { 0 };
+    struct ccord_arena arena;
+    struct json_fixture fx = { 0 };
+    jsmnf_pair *root;
+    long ret;
+
+    root = json_fixture_load(&fx, MESSAGE_JSON, sizeof(MESSAGE_JSON) - 1);
+    ASSERT(root != NULL);
+
+    ASSERT(discord_message_from_jsmnf(root, MESSAGE_JSON, &heap) > 0);
+
+    /* too small on purpose, so the arena has to grow while decoding */
+    cog_arena_init(&arena, 64);
+    ret = discord_message_from_jsmnf_arena(root, MESSAGE_JSON, &arena_msg,
+                                           &arena);
+    ASSERT(ret > 0);
+
+    ASSERT_EQ(heap.id, arena_msg.id);
+    ASSERT_STR_EQ("hello \"there\"", arena_msg.content);
+    ASSERT_STR_EQ(heap.content, arena_msg.content);
+    ASSERT_STR_EQ(heap.nonce, arena_msg.nonce);
+    ASSERT_STR_EQ(heap.author->username, arena_msg.author->username);
+    ASSERT_EQ(2, arena_msg.mentions->size);
+    ASSERT_EQ(2ULL, arena_msg.mentions->array[1].id);
+    ASSERT_STR_EQ("b", arena_msg.mentions->array[1].username);
+
+    ASSERT_EQ(heap.embeds->size, arena_msg.embeds->size);
+    ASSERT_STR_EQ("first", arena_msg.embeds->array[0].title);
+    ASSERT_EQ(255, arena_msg.embeds->array[0].color);
+    ASSERT_STR_EQ("footer", arena_msg.embeds->array[0].footer->text);
+    ASSERT_EQ(2, arena_msg.embeds->array[0].fields->size);
+    ASSERT_STR_EQ("v2", arena_msg.embeds->array[0].fields->array[1].value);
+    ASSERT(arena_msg.embeds->array[0].fields->array[0].Inline);
+    ASSERT_STR_EQ("https://a.b/c.png", arena_msg.embeds->array[1].image->url);
+    ASSERT_EQ(NULL, arena_msg.embeds->array[1].footer);
+
+    /* nothing but the arena has to be released */
+    cog_arena_cleanup(&arena);
+    discord_message_cleanup(&heap);
+    json_fixture_cleanup(&fx);
+    PASS();
+}
+
+TEST
+check_decode_keys(void)
+{
+    /* unknown keys, and keys that share a prefix with known ones */
+    static const char json[] =
+        "{\"i\":\"1\",\"idx\":\"2\",\"unknown\":{\"id\":\"3\"},"
+        "\"content\":\"hi\",\"contents\":\"no\",\"id\":\"4\"}";
+    struct discord_message message = { 0 };
+    struct json_fixture fx = { 0 };
+    jsmnf_pair *root;
+
+    ASSERT((root = json_fixture_load(&fx, json, strlen(json))) != NULL);
+    ASSERT(discord_message_from_jsmnf(root, json, &message) > 0);
+    ASSERT_EQ(4ULL, message.id);
+    ASSERT_STR_EQ("hi", message.content);
+    ASSERT_EQ(NULL, message.author);
+    discord_message_cleanup(&message);
+
+    /* not an object, nothing to decode */
+    memset(&message, 0, sizeof(message));
+    ASSERT_EQ(0, discord_message_from_jsmnf(root->fields, json, &message));
+    ASSERT_EQ(0ULL, message.id);
+
+    json_fixture_cleanup(&fx);
+    PASS();
+}
+
+TEST
+check_decode_duplicates(void)
+{
+    /* the last one wins, and the previous one is released */
+    static const char json[] =
+        "{\"content\":\"first\",\"author\":{\"username\":\"a\"},"
+        "\"content\":\"last\",\"author\":{\"username\":\"b\"}}";
+    struct discord_message message = { 0 };
+    struct json_fixture fx = { 0 };
+    jsmnf_pair *root;
+
+    ASSERT((root = json_fixture_load(&fx, json, strlen(json))) != NULL);
+    ASSERT(discord_message_from_jsmnf(root, json, &message) > 0);
+    ASSERT_STR_EQ("last", message.content);
+    ASSERT(message.author != NULL);
+    ASSERT_STR_EQ("b", message.author->username);
+    discord_message_cleanup(&message);
+
+    json_fixture_cleanup(&fx);
+    PASS();
+}
+
+static const char GUILD_JSON[] =
+    "{\"id\":\"939234213521760270\",\"name\":\"concord\",\"roles\":["
+    "{\"id\":\"1\",\"name\":\"@everyone\",\"tags\":{\"bot_id\":\"7\"}},"
+    "{\"id\":\"2\",\"name\":\"admin\"}],\"channels\":["
+    "{\"id\":\"3\",\"name\":\"general\",\"topic\":\"hi\"},"
+    "{\"id\":\"4\",\"name\":\"voice\",\"type\":2}],"
+    "\"features\":[\"COMMUNITY\",\"NEWS\"]}";
+
+#define IN_BLOCK(_ptr, _block, _size)                                         \
+    ((const char *)(_ptr) > (const char *)(_block)                            \
+     && (const char *)(_ptr) < (const char *)(_block) + (_size))
+
+TEST
+check_flat_decode(void)
+{
+    struct discord_guild *guild, *copy;
+    struct json_fixture fx = { 0 };
+    jsmnf_pair *root;
+    long size;
+
+    root = json_fixture_load(&fx, GUILD_JSON, sizeof(GUILD_JSON) - 1);
+    ASSERT(root != NULL);
+
+    size = discord_guild_from_jsmnf_flat(root, GUILD_JSON, &guild);
+    ASSERT_EQ((long)discord_guild_flat_size(root, GUILD_JSON), size);
+
+    /* the whole graph lives in the block */
+    ASSERT(IN_BLOCK(guild->name, guild, size));
+    ASSERT(IN_BLOCK(guild->roles->array, guild, size));
+    ASSERT(IN_BLOCK(guild->roles->array[0].tags, guild, size));
+    ASSERT(IN_BLOCK(guild->features->array[1], guild, size));
+
+    /* copy it over and release the original */
+    copy = malloc((size_t)size);
+    memcpy(copy, guild, (size_t)size);
+    discord_guild_flat_relocate(copy, (char *)copy - (char *)guild);
+    memset(guild, 0xff, (size_t)size);
+    free(guild);
+
+    ASSERT_EQ(939234213521760270ULL, copy->id);
+    ASSERT_STR_EQ("concord", copy->name);
+    ASSERT_EQ(2, copy->roles->size);
+    ASSERT_STR_EQ("@everyone", copy->roles->array[0].name);
+    ASSERT_EQ(7ULL, copy->roles->array[0].tags->bot_id);
+    ASSERT_EQ(NULL, copy->roles->array[1].tags);
+    ASSERT_EQ(2, copy->channels->size);
+    ASSERT_STR_EQ("hi", copy->channels->array[0].topic);
+    ASSERT_EQ(NULL, copy->channels->array[1].topic);
+    ASSERT_STR_EQ("NEWS", copy->features->array[1]);
+    ASSERT_EQ(NULL, copy->members);
+    free(copy);
+
+    json_fixture_cleanup(&fx);
+    PASS();
+}
+
+SUITE(gateway_arena)
+{
+    RUN_TEST(check_arena_alloc);
+    RUN_TEST(check_arena_decode);
+    RUN_TEST(check_decode_keys);
+    RUN_TEST(check_decode_duplicates);
+    RUN_TEST(check_flat_decode);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_EVENTS 100000
+
+TEST
+bench_arena_decode(void)
+{
+    struct ccord_arena arena;
+    uint64_t tstart, heap_us, arena_us, flat_us;
+    struct json_fixture fx = { 0 };
+    jsmnf_pair *root;
+
+    root = json_fixture_load(&fx, MESSAGE_JSON, sizeof(MESSAGE_JSON) - 1);
+    ASSERT(root != NULL);
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_EVENTS; ++i) {
+        struct discord_message *message = calloc(1, sizeof *message);
+
+        discord_message_from_jsmnf(root, MESSAGE_JSON, message);
+        discord_message_cleanup(message);
+        free(message);
+    }
+    heap_us = cog_timestamp_us() - tstart;
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_EVENTS; ++i) {
+        struct discord_message *message;
+
+        cog_arena_init(&arena, sizeof *message + 2 * sizeof(MESSAGE_JSON));
+        message = cog_arena_alloc(&arena, sizeof *message);
+        discord_message_from_jsmnf_arena(root, MESSAGE_JSON, message, &arena);
+        cog_arena_cleanup(&arena);
+    }
+    arena_us = cog_timestamp_us() - tstart;
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_EVENTS; ++i) {
+        struct discord_message *message;
+
+        discord_message_from_jsmnf_flat(root, MESSAGE_JSON, &message);
+        free(message);
+    }
+    flat_us = cog_timestamp_us() - tstart;
+
+    fprintf(stderr,
+            "MESSAGE_CREATE with embeds: calloc %6.1f ns/event, "
+            "arena %6.1f ns/event, flat %6.1f ns/event\n",
+            heap_us * 1000.0 / BENCH_EVENTS,
+            arena_us * 1000.0 / BENCH_EVENTS,
+            flat_us * 1000.0 / BENCH_EVENTS);
+
+    json_fixture_cleanup(&fx);
+    PASS();
+}
+
+SUITE(gateway_arena_benchmark)
+{
+    RUN_TEST(bench_arena_decode);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(gateway_arena);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(gateway_arena_benchmark);
+#endif
+
+    GREATEST_MAIN_END();
+}
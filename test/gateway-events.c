@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+static const struct {
+    const char *name;
+    enum discord_gateway_events event;
+} EVENTS[] = {
+#define EVENT(name) { #name, DISCORD_EV_##name }
+    EVENT(READY),
+    EVENT(RESUMED),
+    EVENT(RECONNECT),
+    EVENT(INVALID_SESSION),
+    EVENT(APPLICATION_COMMAND_PERMISSIONS_UPDATE),
+    EVENT(AUTO_MODERATION_RULE_CREATE),
+    EVENT(AUTO_MODERATION_RULE_UPDATE),
+    EVENT(AUTO_MODERATION_RULE_DELETE),
+    EVENT(AUTO_MODERATION_ACTION_EXECUTION),
+    EVENT(CHANNEL_CREATE),
+    EVENT(CHANNEL_UPDATE),
+    EVENT(CHANNEL_DELETE),
+    EVENT(CHANNEL_PINS_UPDATE),
+    EVENT(THREAD_CREATE),
+    EVENT(THREAD_UPDATE),
+    EVENT(THREAD_DELETE),
+    EVENT(THREAD_LIST_SYNC),
+    EVENT(THREAD_MEMBER_UPDATE),
+    EVENT(THREAD_MEMBERS_UPDATE),
+    EVENT(GUILD_CREATE),
+    EVENT(GUILD_UPDATE),
+    EVENT(GUILD_DELETE),
+    EVENT(GUILD_BAN_ADD),
+    EVENT(GUILD_BAN_REMOVE),
+    EVENT(GUILD_EMOJIS_UPDATE),
+    EVENT(GUILD_STICKERS_UPDATE),
+    EVENT(GUILD_INTEGRATIONS_UPDATE),
+    EVENT(GUILD_MEMBER_ADD),
+    EVENT(GUILD_MEMBER_UPDATE),
+    EVENT(GUILD_MEMBER_REMOVE),
+    EVENT(GUILD_MEMBERS_CHUNK),
+    EVENT(GUILD_ROLE_CREATE),
+    EVENT(GUILD_ROLE_UPDATE),
+    EVENT(GUILD_ROLE_DELETE),
+    EVENT(GUILD_SCHEDULED_EVENT_CREATE),
+    EVENT(GUILD_SCHEDULED_EVENT_UPDATE),
+    EVENT(GUILD_SCHEDULED_EVENT_DELETE),
+    EVENT(GUILD_SCHEDULED_EVENT_USER_ADD),
+    EVENT(GUILD_SCHEDULED_EVENT_USER_REMOVE),
+    EVENT(INTEGRATION_CREATE),
+    EVENT(INTEGRATION_UPDATE),
+    EVENT(INTEGRATION_DELETE),
+    EVENT(INTERACTION_CREATE),
+    EVENT(INVITE_CREATE),
+    EVENT(INVITE_DELETE),
+    EVENT(MESSAGE_CREATE),
+    EVENT(MESSAGE_UPDATE),
+    EVENT(MESSAGE_DELETE),
+    EVENT(MESSAGE_DELETE_BULK),
+    EVENT(MESSAGE_REACTION_ADD),
+    EVENT(MESSAGE_REACTION_REMOVE),
+    EVENT(MESSAGE_REACTION_REMOVE_ALL),
+    EVENT(MESSAGE_REACTION_REMOVE_EMOJI),
+    EVENT(PRESENCE_UPDATE),
+    EVENT(STAGE_INSTANCE_CREATE),
+    EVENT(STAGE_INSTANCE_DELETE),
+    EVENT(STAGE_INSTANCE_UPDATE),
+    EVENT(TYPING_START),
+    EVENT(USER_UPDATE),
+    EVENT(VOICE_STATE_UPDATE),
+    EVENT(VOICE_SERVER_UPDATE),
+    EVENT(WEBHOOKS_UPDATE),
+#undef EVENT
+};
+
+TEST
+check_every_event_name(void)
+{
+    for (size_t i = 0; i < sizeof(EVENTS) / sizeof *EVENTS; ++i)
+        ASSERT_EQ_FMT(EVENTS[i].event,
+                      discord_gateway_event_eval(EVENTS[i].name,
+                                                 strlen(EVENTS[i].name)),
+                      "%d");
+    PASS();
+}
+
+TEST
+check_unknown_event_name(void)
+{
+    /* unterminated token, as it would be read from the payload */
+    const char text[] = "MESSAGE_CREATEX\"";
+
+    ASSERT_EQ(DISCORD_EV_MESSAGE_CREATE,
+              discord_gateway_event_eval(text, sizeof("MESSAGE_CREATE") - 1));
+    ASSERT_EQ(DISCORD_EV_NONE, discord_gateway_event_eval(text, 15));
+    ASSERT_EQ(DISCORD_EV_NONE, discord_gateway_event_eval("", 0));
+    ASSERT_EQ(DISCORD_EV_NONE, discord_gateway_event_eval("MESSAGE_", 8));
+    PASS();
+}
+
+SUITE(event_name_resolution)
+{
+    RUN_TEST(check_every_event_name);
+    RUN_TEST(check_unknown_event_name);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_ROUNDS 200000
+
+/* reference implementation: copy the token into a NUL-terminated buffer and
+ *  compare against every event name in order */
+static enum discord_gateway_events
+strcmp_event_eval(const char text[], size_t len)
+{
+    char name[64];
+
+    snprintf(name, sizeof(name), "%.*s", (int)len, text);
+    for (size_t i = 0; i < sizeof(EVENTS) / sizeof *EVENTS; ++i)
+        if (!strcmp(EVENTS[i].name, name)) return EVENTS[i].event;
+    return DISCORD_EV_NONE;
+}
+
+static double
+bench(enum discord_gateway_events (*eval)(const char[], size_t),
+      const char text[],
+      size_t len)
+{
+    const uint64_t tstart = cog_timestamp_us();
+    volatile enum discord_gateway_events event;
+
+    for (int i = 0; i < BENCH_ROUNDS; ++i)
+        event = eval(text, len);
+    (void)event;
+
+    return (double)(cog_timestamp_us() - tstart) * 1000.0 / BENCH_ROUNDS;
+}
+
+TEST
+bench_event_name(const char *name)
+{
+    const size_t len = strlen(name);
+    double before = bench(&strcmp_event_eval, name, len),
+           after = bench(&discord_gateway_event_eval, name, len);
+
+    fprintf(stderr, "%-24s strcmp chain: %7.2f ns/event, switch: %7.2f "
+                    "ns/event\n",
+            name, before, after);
+    PASS();
+}
+
+SUITE(event_name_benchmark)
+{
+    RUN_TEST1(bench_event_name, "READY");
+    RUN_TEST1(bench_event_name, "GUILD_CREATE");
+    RUN_TEST1(bench_event_name, "MESSAGE_CREATE");
+    RUN_TEST1(bench_event_name, "PRESENCE_UPDATE");
+    RUN_TEST1(bench_event_name, "WEBHOOKS_UPDATE");
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(event_name_resolution);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(event_name_benchmark);
+#endif
+
+    GREATEST_MAIN_END();
+}
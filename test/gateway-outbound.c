@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+static int
+count_queued(struct discord_gateway *gw)
+{
+    QUEUE(struct discord_gateway_command) *qelem;
+    int count = 0;
+
+    QUEUE_FOREACH(qelem, &gw->outbound->queue)
+    {
+        ++count;
+    }
+    return count;
+}
+
+/* have the queue drain as if the rate limit window had reset */
+static void
+expire_window(struct discord *client, struct discord_gateway *gw)
+{
+    struct discord_timer timer = { .id = gw->outbound->timer,
+                                   .flags = DISCORD_TIMER_GET };
+
+    discord_internal_timer_ctl(client, &timer);
+    timer.delay = 0;
+    discord_internal_timer_ctl(client, &timer);
+
+    gw->outbound->reset_at = 0;
+    discord_timers_run(client, &client->timers.internal);
+}
+
+TEST
+check_outbound_queue(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_gateway *gw = &client->gw;
+    struct discord_request_guild_members request = { .guild_id = 1 };
+    struct discord_presence_update presence = { .status = "idle" };
+
+    gw->session->is_ready = true;
+
+    /* the budget minus the reserved part goes through right away */
+    for (int i = 0; i < 200; ++i)
+        discord_gateway_send_request_guild_members(gw, &request);
+    ASSERT_EQ(200 - (120 - 5), count_queued(gw));
+    ASSERT(gw->outbound->timer != 0);
+
+    /* superseded presence updates are dropped */
+    for (int i = 0; i < 10; ++i)
+        discord_gateway_send_presence_update(gw, &presence);
+    ASSERT_EQ(200 - (120 - 5) + 1, count_queued(gw));
+    ASSERT(gw->outbound->presence != NULL);
+
+    /* heartbeats use the reserved budget and are never queued */
+    for (int i = 0; i < 3; ++i)
+        discord_gateway_send_heartbeat(gw, 0);
+    ASSERT_EQ(200 - (120 - 5) + 1, count_queued(gw));
+    ASSERT_EQ(2, gw->outbound->remaining);
+
+    /* the next window drains the queue in order */
+    expire_window(client, gw);
+    ASSERT_EQ(0, count_queued(gw));
+    ASSERT_EQ(0, gw->outbound->timer);
+    ASSERT_EQ(NULL, gw->outbound->presence);
+    ASSERT_EQ(120 - (200 - (120 - 5) + 1), gw->outbound->remaining);
+
+    discord_cleanup(client);
+    PASS();
+}
+
+TEST
+check_outbound_not_ready(void)
+{
+    struct discord *client = discord_init("");
+    struct discord_gateway *gw = &client->gw;
+    struct discord_request_guild_members request = { .guild_id = 1 };
+
+    gw->session->is_ready = true;
+    for (int i = 0; i < 120; ++i)
+        discord_gateway_send_request_guild_members(gw, &request);
+    ASSERT_EQ(5, count_queued(gw));
+
+    /* queued commands wait for the session to be ready again */
+    gw->session->is_ready = false;
+    expire_window(client, gw);
+    ASSERT_EQ(5, count_queued(gw));
+    ASSERT(gw->outbound->timer != 0);
+
+    /* pending commands are freed along with the client */
+    discord_cleanup(client);
+    PASS();
+}
+
+SUITE(gateway_outbound)
+{
+    RUN_TEST(check_outbound_queue);
+    RUN_TEST(check_outbound_not_ready);
+}
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(gateway_outbound);
+
+    GREATEST_MAIN_END();
+}
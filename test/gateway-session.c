@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+#define SESSION_FILE "gateway-session.json"
+
+static struct discord *
+client_init(void)
+{
+    struct discord *client = discord_init("");
+
+    discord_set_shards(client, 2, 2, 4);
+    discord_set_session_file(client, SESSION_FILE);
+    return client;
+}
+
+TEST
+check_session_roundtrip(void)
+{
+    struct discord *client = client_init();
+    struct discord_gateway *gw = SHARD(client, 0);
+
+    /* resumable */
+    snprintf(gw->session->id, sizeof(gw->session->id), "abcdef");
+    snprintf(gw->session->resume_url, sizeof(gw->session->resume_url),
+             "wss://gateway-us-east1-b.discord.gg");
+    gw->payload.seq = 1234;
+    gw->session->status = DISCORD_SESSION_RESUMABLE;
+    /* not resumable */
+    gw = SHARD(client, 1);
+    snprintf(gw->session->id, sizeof(gw->session->id), "ghijkl");
+    gw->payload.seq = 42;
+
+    discord_session_file_save(client);
+    discord_cleanup(client);
+
+    client = client_init();
+    discord_session_file_load(client);
+
+    gw = SHARD(client, 0);
+    ASSERT(gw->session->status & DISCORD_SESSION_RESUMABLE);
+    ASSERT_STR_EQ("abcdef", gw->session->id);
+    ASSERT_STR_EQ("wss://gateway-us-east1-b.discord.gg",
+                  gw->session->resume_url);
+    ASSERT_EQ(1234, gw->payload.seq);
+
+    gw = SHARD(client, 1);
+    ASSERT_FALSE(gw->session->status & DISCORD_SESSION_RESUMABLE);
+    ASSERT_STR_EQ("", gw->session->id);
+    ASSERT_EQ(0, gw->payload.seq);
+
+    discord_cleanup(client);
+    remove(SESSION_FILE);
+    PASS();
+}
+
+TEST
+check_session_escaped(void)
+{
+    struct discord *client = client_init();
+    struct discord_gateway *gw = SHARD(client, 0);
+
+    /* escaped control characters take up six times their size */
+    snprintf(gw->session->id, sizeof(gw->session->id), "abcdef");
+    memset(gw->session->resume_url, '\x01',
+           sizeof(gw->session->resume_url) - 1);
+    gw->session->status = DISCORD_SESSION_RESUMABLE;
+    gw = SHARD(client, 1);
+    snprintf(gw->session->id, sizeof(gw->session->id), "ghijkl");
+    gw->session->status = DISCORD_SESSION_RESUMABLE;
+
+    discord_session_file_save(client);
+    discord_cleanup(client);
+    ASSERT_EQ(NULL, fopen(SESSION_FILE ".tmp", "rb"));
+
+    client = client_init();
+    discord_session_file_load(client);
+    ASSERT_STR_EQ("abcdef", SHARD(client, 0)->session->id);
+    ASSERT_STR_EQ("ghijkl", SHARD(client, 1)->session->id);
+
+    discord_cleanup(client);
+    remove(SESSION_FILE);
+    PASS();
+}
+
+TEST
+check_session_stale(void)
+{
+    struct discord *client = client_init();
+    FILE *fp = fopen(SESSION_FILE, "wb");
+
+    ASSERT(fp != NULL);
+    fputs("{\"saved_at\":1000,\"sessions\":[{\"shard\":2,"
+          "\"session_id\":\"abcdef\",\"seq\":1234}]}",
+          fp);
+    fclose(fp);
+
+    discord_session_file_load(client);
+    ASSERT_FALSE(SHARD(client, 0)->session->status
+                 & DISCORD_SESSION_RESUMABLE);
+    ASSERT_STR_EQ("", SHARD(client, 0)->session->id);
+
+    discord_cleanup(client);
+    remove(SESSION_FILE);
+    PASS();
+}
+
+TEST
+check_session_missing(void)
+{
+    struct discord *client = client_init();
+
+    remove(SESSION_FILE);
+    discord_session_file_load(client);
+    ASSERT_FALSE(SHARD(client, 0)->session->status
+                 & DISCORD_SESSION_RESUMABLE);
+
+    discord_cleanup(client);
+    PASS();
+}
+
+TEST
+check_session_shutdown(void)
+{
+    struct discord *client = client_init();
+    struct discord_gateway *gw = SHARD(client, 0);
+
+    /* a session that has started is kept open */
+    snprintf(gw->session->id, sizeof(gw->session->id), "abcdef");
+    discord_gateway_shutdown(gw);
+    ASSERT(gw->session->status & DISCORD_SESSION_RESUMABLE);
+
+    /* without a session file it's closed for good */
+    discord_set_session_file(client, NULL);
+    discord_gateway_shutdown(gw);
+    ASSERT_FALSE(gw->session->status & DISCORD_SESSION_RESUMABLE);
+
+    discord_cleanup(client);
+    PASS();
+}
+
+static int guild_deletes;
+
+static void
+on_guild_delete(struct discord *client, const struct discord_guild *event)
+{
+    (void)client;
+    (void)event;
+    ++guild_deletes;
+}
+
+TEST
+check_shards_share_callbacks(void)
+{
+    struct discord *client = client_init();
+    const char payload[] = "{\"t\":\"GUILD_DELETE\",\"s\":1,\"op\":0,"
+                           "\"d\":{\"id\":\"1234\"}}";
+
+    /* registered after the shards have been created */
+    discord_set_on_guild_delete(client, &on_guild_delete);
+
+    guild_deletes = 0;
+    ASSERT(discord_gateway_replay(SHARD(client, 1), payload,
+                                  sizeof(payload) - 1));
+    ASSERT_EQ(1, guild_deletes);
+
+    discord_cleanup(client);
+    PASS();
+}
+
+SUITE(gateway_session)
+{
+    RUN_TEST(check_session_roundtrip);
+    RUN_TEST(check_session_escaped);
+    RUN_TEST(check_session_stale);
+    RUN_TEST(check_session_missing);
+    RUN_TEST(check_session_shutdown);
+    RUN_TEST(check_shards_share_callbacks);
+}
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(gateway_session);
+
+    GREATEST_MAIN_END();
+}
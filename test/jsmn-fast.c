@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+static const char *const DOCUMENTS[] = {
+    "",
+    "   ",
+    "{}",
+    "[]",
+    "{\"a\":1}",
+    "[1,2,3, true ,false,null,-1.5e10]",
+    "{\"op\":0,\"s\":42,\"t\":\"MESSAGE_CREATE\",\"d\":{\"content\":\"hi\"}}",
+    "{\"nested\":{\"array\":[{\"x\":[[],{}]},{\"y\":{\"z\":[1,[2,[3]]]}}]}}",
+    /* escapes, quotes right after backslash runs */
+    "{\"s\":\"a\\\\\",\"t\":\"\\\"quoted\\\"\",\"u\":\"\\\\\\\"\"}",
+    "{\"e\":\"\\u00e9\\ud83d\\ude00\\n\\t\\/\\b\\f\\r\"}",
+    "\"top level string\"",
+    "12345",
+    "1 2 \"three\" [4]",
+    /* utf-8 inside strings */
+    "{\"name\":\"\xc3\xa9t\xc3\xa9 \xf0\x9f\x98\x80\"}",
+    /* malformed, must be reported the same as jsmn_parse() */
+    "{\"a\":1",
+    "{\"a\":\"unterminated}",
+    "[1,2}",
+    "]",
+    "{\"bad\":\"\\x\"}",
+    "{\"bad\":\"\\u12G4\"}",
+    "{\"a\":tr\"ue}",
+    "{\"a\":\x01}",
+    "abc\\\"def\"",
+};
+
+static char *big_document;
+static size_t big_size;
+
+static void
+build_members_chunk(unsigned nmembers)
+{
+    size_t cap = 256 + nmembers * 512, len = 0;
+    unsigned i;
+
+    big_document = malloc(cap);
+    len += sprintf(big_document + len,
+                   "{\"t\":\"GUILD_MEMBERS_CHUNK\",\"s\":3,\"op\":0,\"d\":{"
+                   "\"guild_id\":\"939234213521760270\",\"members\":[");
+    for (i = 0; i < nmembers; ++i) {
+        len += sprintf(
+            big_document + len,
+            "%s{\"user\":{\"username\":\"member \\\"%u\\\"\",\"public_flags\""
+            ":0,\"id\":\"%llu\",\"discriminator\":\"%04u\",\"avatar\":"
+            "\"a_1b2c3d4e5f60718293a4b5c6d7e8f901\"},\"roles\":["
+            "\"939234213521760271\",\"939234213521760272\"],\"nick\":null,"
+            "\"mute\":false,\"joined_at\":\"2022-02-04T00:00:00.000000+00:00\""
+            ",\"flags\":0,\"deaf\":false}",
+            i ? "," : "", i, 140931563499159552ULL + i, i % 10000);
+    }
+    len += sprintf(big_document + len,
+                   "],\"chunk_index\":0,\"chunk_count\":1}}");
+    big_size = len;
+}
+
+static enum greatest_test_res
+compare_parsers(const char js[], size_t length)
+{
+    jsmntok_t *slow = NULL, *fast = NULL;
+    unsigned nslow = 0, nfast = 0;
+    jsmn_parser slow_parser, fast_parser;
+    int slow_ret, fast_ret;
+
+    jsmn_init(&slow_parser);
+    slow_ret = jsmn_parse_auto(&slow_parser, js, length, &slow, &nslow);
+    jsmn_init(&fast_parser);
+    fast_ret = jsmn_parse_fast(&fast_parser, js, length, &fast, &nfast);
+
+    ASSERT_EQ_FMT(slow_ret, fast_ret, "%d");
+    if (slow_ret >= 0) {
+        ASSERT_EQ(slow_parser.pos, fast_parser.pos);
+        ASSERT_EQ(slow_parser.toknext, fast_parser.toknext);
+        ASSERT_EQ(slow_parser.toksuper, fast_parser.toksuper);
+        for (int i = 0; i < slow_ret; ++i) {
+            ASSERT_EQ(slow[i].type, fast[i].type);
+            ASSERT_EQ(slow[i].start, fast[i].start);
+            ASSERT_EQ(slow[i].end, fast[i].end);
+            ASSERT_EQ(slow[i].size, fast[i].size);
+        }
+    }
+
+    free(slow);
+    free(fast);
+    PASS();
+}
+
+TEST
+check_same_tokens(enum jsmn_isa isa)
+{
+    char padded[256];
+
+    if (jsmn_fast_select(isa) != isa) SKIPm("unsupported by this CPU");
+
+    for (size_t i = 0; i < sizeof(DOCUMENTS) / sizeof *DOCUMENTS; ++i) {
+        const size_t length = strlen(DOCUMENTS[i]);
+
+        CHECK_CALL(compare_parsers(DOCUMENTS[i], length));
+
+        /* move every byte across the 64-byte block boundaries */
+        for (size_t shift = 1; shift < 130 && shift + length < sizeof(padded);
+             ++shift)
+        {
+            memset(padded, ' ', shift);
+            memcpy(padded + shift, DOCUMENTS[i], length);
+            CHECK_CALL(compare_parsers(padded, shift + length));
+        }
+    }
+    /* jsmn_parse() stops at the first NUL */
+    CHECK_CALL(compare_parsers("{\"a\":1}\0{\"b\":2}", 15));
+    CHECK_CALL(compare_parsers(big_document, big_size));
+    /* truncated anywhere */
+    for (size_t i = 0; i < 300; ++i)
+        CHECK_CALL(compare_parsers(big_document, i));
+
+    jsmn_fast_select(JSMN_ISA_AUTO);
+    PASS();
+}
+
+TEST
+check_reuses_tokens(void)
+{
+    jsmntok_t *tokens = NULL;
+    unsigned ntokens = 0;
+    jsmn_parser parser;
+
+    jsmn_init(&parser);
+    ASSERT(jsmn_parse_fast(&parser, big_document, big_size, &tokens, &ntokens)
+           > 0);
+    for (int i = 0; i < 3; ++i) {
+        jsmntok_t *prev = tokens;
+        unsigned prev_ntokens = ntokens;
+
+        jsmn_init(&parser);
+        ASSERT_EQ(11, jsmn_parse_fast(&parser, DOCUMENTS[6],
+                                      strlen(DOCUMENTS[6]), &tokens,
+                                      &ntokens));
+        ASSERT_EQ(prev, tokens);
+        ASSERT_EQ(prev_ntokens, ntokens);
+    }
+    free(tokens);
+    PASS();
+}
+
+SUITE(jsmn_fast)
+{
+    RUN_TESTp(check_same_tokens, JSMN_ISA_SCALAR);
+    RUN_TESTp(check_same_tokens, JSMN_ISA_SSE2);
+    RUN_TESTp(check_same_tokens, JSMN_ISA_AVX2);
+    RUN_TEST(check_reuses_tokens);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_ROUNDS 200
+
+TEST
+bench_parse(const char *name, enum jsmn_isa isa)
+{
+    jsmntok_t *tokens = NULL;
+    unsigned ntokens = 0;
+    jsmn_parser parser;
+    uint64_t tstart, elapsed;
+
+    if (isa && jsmn_fast_select(isa) != isa) SKIPm("unsupported by this CPU");
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS; ++i) {
+        jsmn_init(&parser);
+        if (isa)
+            jsmn_parse_fast(&parser, big_document, big_size, &tokens,
+                            &ntokens);
+        else
+            jsmn_parse_auto(&parser, big_document, big_size, &tokens,
+                            &ntokens);
+        /* a fresh buffer every time, like a one-off REST response */
+        free(tokens);
+        tokens = NULL;
+        ntokens = 0;
+    }
+    elapsed = cog_timestamp_us() - tstart;
+
+    fprintf(stderr, "%-16s %zu bytes: %8.1f us/parse, %6.0f MB/s\n", name,
+            big_size, (double)elapsed / BENCH_ROUNDS,
+            (double)big_size * BENCH_ROUNDS / (elapsed ? elapsed : 1));
+
+    jsmn_fast_select(JSMN_ISA_AUTO);
+    PASS();
+}
+
+SUITE(jsmn_fast_benchmark)
+{
+    RUN_TESTp(bench_parse, "jsmn_parse_auto", 0);
+    RUN_TESTp(bench_parse, "scalar", JSMN_ISA_SCALAR);
+    RUN_TESTp(bench_parse, "sse2", JSMN_ISA_SSE2);
+    RUN_TESTp(bench_parse, "avx2", JSMN_ISA_AVX2);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    build_members_chunk(1000);
+
+    RUN_SUITE(jsmn_fast);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(jsmn_fast_benchmark);
+#endif
+
+    free(big_document);
+
+    GREATEST_MAIN_END();
+}
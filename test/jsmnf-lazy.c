@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+struct document {
+    char *js;
+    size_t size;
+    jsmntok_t *tokens;
+    unsigned ntokens;
+    /** tokens actually parsed */
+    unsigned count;
+    jsmnf_pair *pairs;
+    unsigned npairs;
+};
+
+static char *members_chunk;
+static size_t members_chunk_size;
+
+static enum greatest_test_res
+load(struct document *doc, const char js[], size_t size)
+{
+    jsmn_parser parser;
+    jsmnf_loader loader;
+
+    doc->js = (char *)js;
+    doc->size = size;
+
+    jsmn_init(&parser);
+    ASSERT_GT(jsmn_parse_fast(&parser, js, size, &doc->tokens, &doc->ntokens),
+              0);
+    doc->count = parser.toknext;
+    jsmnf_init(&loader);
+    ASSERT_GT(jsmnf_load_auto(&loader, js, doc->tokens, doc->count,
+                              &doc->pairs, &doc->npairs),
+              0);
+    PASS();
+}
+
+static void
+cleanup(struct document *doc)
+{
+    free(doc->tokens);
+    free(doc->pairs);
+}
+
+/* {"k0":0,"k1":1,...} */
+static char *
+build_object(int nfields)
+{
+    char *js = malloc(32 + nfields * 32);
+    size_t len = 0;
+
+    js[len++] = '{';
+    for (int i = 0; i < nfields; ++i)
+        len += sprintf(js + len, "%s\"k%d\":%d", i ? "," : "", i, i);
+    len += sprintf(js + len, ",\"nested\":{\"a\":1}}");
+    return js;
+}
+
+static void
+build_members_chunk(unsigned nmembers)
+{
+    size_t cap = 256 + nmembers * 512, len = 0;
+
+    members_chunk = malloc(cap);
+    len += sprintf(members_chunk + len,
+                   "{\"t\":\"GUILD_MEMBERS_CHUNK\",\"s\":3,\"op\":0,\"d\":{"
+                   "\"guild_id\":\"939234213521760270\",\"members\":[");
+    for (unsigned i = 0; i < nmembers; ++i) {
+        len += sprintf(
+            members_chunk + len,
+            "%s{\"user\":{\"username\":\"member %u\",\"public_flags\":0,"
+            "\"id\":\"%llu\",\"discriminator\":\"%04u\",\"avatar\":null},"
+            "\"roles\":[\"939234213521760271\"],\"nick\":null,\"mute\":false,"
+            "\"joined_at\":\"2022-02-04T00:00:00.000000+00:00\",\"flags\":0,"
+            "\"deaf\":false,\"embed\":{\"fields\":[{\"name\":\"a\",\"value\":"
+            "\"b\",\"inline\":true}],\"footer\":{\"text\":\"unread\"}}}",
+            i ? "," : "", i, 140931563499159552ULL + i, i % 10000);
+    }
+    len += sprintf(members_chunk + len,
+                   "],\"chunk_index\":0,\"chunk_count\":1}}");
+    members_chunk_size = len;
+}
+
+TEST
+check_find(int nfields)
+{
+    char *js = build_object(nfields);
+    struct document doc = { 0 };
+    jsmnf_pair *f;
+    char key[16];
+
+    CHECK_CALL(load(&doc, js, strlen(js)));
+    ASSERT_EQ(0, doc.pairs->hashed);
+
+    for (int i = 0; i < nfields; ++i) {
+        f = jsmnf_find(doc.pairs, js, key, sprintf(key, "k%d", i));
+        ASSERT_NEQ(NULL, f);
+        ASSERT_EQ(i, (int)strtol(js + f->v.pos, NULL, 10));
+    }
+    ASSERT_EQ(NULL, jsmnf_find(doc.pairs, js, "k", 1));
+    ASSERT_EQ(NULL, jsmnf_find(doc.pairs, js, "missing", 7));
+    ASSERT_EQ(nfields + 1 > JSMNF_LINEAR_MAX, doc.pairs->hashed);
+
+    /* nested objects are left alone until looked into */
+    f = jsmnf_find(doc.pairs, js, "nested", 6);
+    ASSERT_NEQ(NULL, f);
+    ASSERT_EQ(0, f->hashed);
+    ASSERT_NEQ(NULL, jsmnf_find(f, js, "a", 1));
+
+    cleanup(&doc);
+    free(js);
+    PASS();
+}
+
+TEST
+check_duplicate_keys(void)
+{
+    char *js = build_object(JSMNF_LINEAR_MAX * 2);
+    struct document doc = { 0 };
+    jsmnf_pair *f;
+    size_t len = strlen(js);
+
+    /* {"k0":0,"k0":1,...} */
+    for (char *p = js; (p = strstr(p, "\"k1")); ++p)
+        if (p[3] == '"') p[2] = '0';
+
+    CHECK_CALL(load(&doc, "{\"a\":1,\"a\":2}", 13));
+    f = jsmnf_find(doc.pairs, doc.js, "a", 1);
+    ASSERT_EQ('2', doc.js[f->v.pos]);
+
+    CHECK_CALL(load(&doc, js, len));
+    f = jsmnf_find(doc.pairs, js, "k0", 2);
+    ASSERT_EQ(1, doc.pairs->hashed);
+    ASSERT_EQ('1', js[f->v.pos]);
+
+    cleanup(&doc);
+    free(js);
+    PASS();
+}
+
+TEST
+check_reuses_buffers(void)
+{
+    static const char SMALL[] = "{\"op\":11,\"d\":null}";
+    struct document doc = { 0 };
+    jsmnf_pair *pairs;
+    unsigned npairs;
+
+    CHECK_CALL(load(&doc, members_chunk, members_chunk_size));
+    pairs = doc.pairs;
+    npairs = doc.npairs;
+
+    for (int i = 0; i < 3; ++i) {
+        CHECK_CALL(load(&doc, SMALL, sizeof(SMALL) - 1));
+        ASSERT_EQ(pairs, doc.pairs);
+        ASSERT_EQ(npairs, doc.npairs);
+        ASSERT_NEQ(NULL, jsmnf_find(doc.pairs, SMALL, "op", 2));
+
+        CHECK_CALL(load(&doc, members_chunk, members_chunk_size));
+        ASSERT_EQ(pairs, doc.pairs);
+        ASSERT_EQ(npairs, doc.npairs);
+    }
+
+    cleanup(&doc);
+    PASS();
+}
+
+SUITE(jsmnf_lazy)
+{
+    RUN_TESTp(check_find, 3);
+    RUN_TESTp(check_find, JSMNF_LINEAR_MAX - 1);
+    RUN_TESTp(check_find, JSMNF_LINEAR_MAX);
+    RUN_TESTp(check_find, 200);
+    RUN_TEST(check_duplicate_keys);
+    RUN_TEST(check_reuses_buffers);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_ROUNDS 200
+
+TEST
+bench_load(void)
+{
+    struct document doc = { 0 };
+    uint64_t tstart, load_us, find_us;
+    jsmnf_pair *d = NULL;
+
+    CHECK_CALL(load(&doc, members_chunk, members_chunk_size));
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS; ++i) {
+        jsmnf_loader loader;
+
+        jsmnf_init(&loader);
+        jsmnf_load_auto(&loader, members_chunk, doc.tokens, doc.count,
+                        &doc.pairs, &doc.npairs);
+    }
+    load_us = cog_timestamp_us() - tstart;
+
+    /* what the Gateway reads before handing the event over */
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS; ++i) {
+        jsmnf_find(doc.pairs, members_chunk, "t", 1);
+        jsmnf_find(doc.pairs, members_chunk, "s", 1);
+        jsmnf_find(doc.pairs, members_chunk, "op", 2);
+        d = jsmnf_find(doc.pairs, members_chunk, "d", 1);
+        jsmnf_find(d, members_chunk, "guild_id", 8);
+    }
+    find_us = cog_timestamp_us() - tstart;
+    ASSERT_NEQ(NULL, d);
+
+    fprintf(stderr,
+            "GUILD_MEMBERS_CHUNK %zu bytes, %u pairs: %.1f us/load, "
+            "%.2f us/envelope lookup\n",
+            members_chunk_size, doc.npairs, (double)load_us / BENCH_ROUNDS,
+            (double)find_us / BENCH_ROUNDS);
+
+    cleanup(&doc);
+    PASS();
+}
+
+SUITE(jsmnf_lazy_benchmark)
+{
+    RUN_TEST(bench_load);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    build_members_chunk(1000);
+
+    RUN_SUITE(jsmnf_lazy);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(jsmnf_lazy_benchmark);
+#endif
+
+    free(members_chunk);
+
+    GREATEST_MAIN_END();
+}
@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+static const struct {
+    const char *src;
+    const char *expect;
+    long ret;
+} VECTORS[] = {
+    { "", "", 0 },
+    { "plain ascii, long enough to cross a couple of 32-byte chunks!!",
+      "plain ascii, long enough to cross a couple of 32-byte chunks!!", 62 },
+    { "hello \\\"world\\\"", "hello \"world\"", 13 },
+    { "\\\\\\/\\b\\f\\n\\r\\t", "\\/\b\f\n\r\t", 7 },
+    { "caf\\u00e9 \\u20AC", "caf\xc3\xa9 \xe2\x82\xac", 9 },
+    { "\\ud83d\\ude00 x \\uD83D\\uDE00", "\xf0\x9f\x98\x80 x \xf0\x9f\x98\x80",
+      11 },
+    { "\xc3\xa9t\xc3\xa9 \xf0\x9f\x98\x80",
+      "\xc3\xa9t\xc3\xa9 \xf0\x9f\x98\x80", 10 },
+    /* a first surrogate ending the string is dropped */
+    { "ab\\ud83d", "ab", 2 },
+    { "\\ud83d\\n", NULL, JSMN_ERROR_INVAL },
+    { "\\ud83dx", NULL, JSMN_ERROR_INVAL },
+    { "\\ud83d\\u0041", NULL, JSMN_ERROR_INVAL },
+    { "\\ude00", NULL, JSMN_ERROR_INVAL },
+    { "\\x", NULL, JSMN_ERROR_INVAL },
+    { "\\u12g4", NULL, JSMN_ERROR_INVAL },
+    { "\\u12", NULL, JSMN_ERROR_PART },
+    { "abc\\", NULL, JSMN_ERROR_PART },
+    { "tab\there", NULL, JSMN_ERROR_INVAL },
+    { "\xc3", NULL, JSMN_ERROR_INVAL },
+    { "\xc0\xaf", NULL, JSMN_ERROR_INVAL },
+    { "\xed\xa0\x80", NULL, JSMN_ERROR_INVAL },
+    { "\xff", NULL, JSMN_ERROR_INVAL },
+};
+
+TEST
+check_vectors(enum jsmn_isa isa)
+{
+    char buf[256];
+
+    if (jsmn_fast_select(isa) != isa) SKIPm("unsupported by this CPU");
+
+    for (size_t i = 0; i < sizeof(VECTORS) / sizeof *VECTORS; ++i) {
+        const size_t len = strlen(VECTORS[i].src);
+        const long ret = jsmnf_unescape(buf, len, VECTORS[i].src, len);
+
+        ASSERT_EQ_FMTm(VECTORS[i].src, VECTORS[i].ret, ret, "%ld");
+        if (VECTORS[i].expect) ASSERT_MEM_EQ(VECTORS[i].expect, buf, ret);
+    }
+    /* stops at NUL, same as jsmn_parse() */
+    ASSERT_EQ(2, jsmnf_unescape(buf, sizeof(buf), "ab\0cd", 5));
+    /* not enough room */
+    ASSERT_EQ(JSMN_ERROR_NOMEM, jsmnf_unescape(buf, 3, "abcdef", 6));
+
+    jsmn_fast_select(JSMN_ISA_AUTO);
+    PASS();
+}
+
+TEST
+check_same_across_isas(void)
+{
+    static const char *const atoms[] = {
+        "a",        "0123456789abcdef", " ",      "\\\"",   "\\\\",
+        "\\n",      "\\u00e9",          "\\ud83d\\ude00", "\\ud83d",
+        "\\ude00",  "\xc3\xa9",         "\xf0\x9f\x98\x80", "\xc3",
+        "\x01",     "\x7f",             "\\",     "\\u00",  "\\q",
+    };
+    char src[512], expect[600], got[600];
+
+    srand(42);
+    for (int i = 0; i < 20000; ++i) {
+        size_t len = 0, bufsize;
+        long expect_ret;
+
+        for (int j = rand() % 16; j > 0; --j) {
+            const char *atom = atoms[rand() % (sizeof(atoms) / sizeof *atoms)];
+            const size_t atom_len = strlen(atom);
+
+            if (len + atom_len >= sizeof(src)) break;
+            memcpy(src + len, atom, atom_len);
+            len += atom_len;
+        }
+        bufsize = rand() % 4 ? len : rand() % (len + 1);
+
+        jsmn_fast_select(JSMN_ISA_SCALAR);
+        expect_ret = jsmnf_unescape(expect, bufsize, src, len);
+        for (enum jsmn_isa isa = JSMN_ISA_SSE2; isa <= JSMN_ISA_AVX2; ++isa) {
+            if (jsmn_fast_select(isa) != isa) continue;
+            ASSERT_EQ(expect_ret, jsmnf_unescape(got, bufsize, src, len));
+            if (expect_ret > 0) ASSERT_MEM_EQ(expect, got, expect_ret);
+        }
+    }
+
+    jsmn_fast_select(JSMN_ISA_AUTO);
+    PASS();
+}
+
+SUITE(unescape)
+{
+    RUN_TESTp(check_vectors, JSMN_ISA_SCALAR);
+    RUN_TESTp(check_vectors, JSMN_ISA_SSE2);
+    RUN_TESTp(check_vectors, JSMN_ISA_AVX2);
+    RUN_TEST(check_same_across_isas);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_ROUNDS 20000
+
+/* content, embed and usernames of a recorded MESSAGE_CREATE */
+static const char MESSAGE_CREATE[] =
+    "{\"id\":\"1014990303337226250\",\"channel_id\":\"939234213521760276\","
+    "\"guild_id\":\"939234213521760270\",\"type\":0,\"tts\":false,"
+    "\"content\":\"Release notes for this week are up! Highlights:\\n"
+    "- the gateway now reconnects with exponential backoff\\n"
+    "- `discord_create_message()` accepts up to 10 embeds\\n"
+    "- fixed a crash when a guild had no \\\"system_channel_id\\\"\\n"
+    "Thanks to everyone who reported issues \\ud83c\\udf89 "
+    "see https://github.com/Cogmasters/concord/releases for the full "
+    "changelog, and ping us in #support if anything looks off.\","
+    "\"timestamp\":\"2022-09-02T18:15:12.345000+00:00\","
+    "\"author\":{\"id\":\"140931563499159552\",\"username\":\"concord-bot\","
+    "\"discriminator\":\"0001\","
+    "\"avatar\":\"a_1b2c3d4e5f60718293a4b5c6d7e8f901\"},"
+    "\"mentions\":[{\"id\":\"140931563499159553\","
+    "\"username\":\"J\xc3\xa9r\xc3\xb4me\"}],"
+    "\"embeds\":[{\"title\":\"Changelog v2.2.0\",\"description\":\"A long "
+    "embed description that quotes code like `jsmnf_unescape(buf, size, "
+    "src, len)` and spans several lines.\\nIt also carries a path such as "
+    "C:\\\\Users\\\\concord\\\\bot.log and a URL with escaped slashes: "
+    "https:\\/\\/discord.com\\/api\\/v10\\/gateway\",\"color\":5814783,"
+    "\"footer\":{\"text\":\"Cogmasters \\u00b7 concord\"}}]}";
+
+TEST
+bench_message_create(const char *name, enum jsmn_isa isa)
+{
+    uint64_t tstart, unescape_ns, decode_ns;
+    jsmntok_t *tokens = NULL;
+    unsigned ntokens = 0;
+    jsmn_parser parser;
+    char buf[2048];
+    int count;
+
+    if (jsmn_fast_select(isa) != isa) SKIPm("unsupported by this CPU");
+
+    jsmn_init(&parser);
+    count = jsmn_parse_fast(&parser, MESSAGE_CREATE,
+                            sizeof(MESSAGE_CREATE) - 1, &tokens, &ntokens);
+    ASSERT_GT(count, 0);
+
+    /* every string, keys included */
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS; ++i) {
+        for (int j = 0; j < count; ++j) {
+            const jsmntok_t *tok = tokens + j;
+
+            if (tok->type != JSMN_STRING) continue;
+            jsmnf_unescape(buf, sizeof(buf), MESSAGE_CREATE + tok->start,
+                           tok->end - tok->start);
+        }
+    }
+    unescape_ns = (cog_timestamp_us() - tstart) * 1000;
+
+    tstart = cog_timestamp_us();
+    for (int i = 0; i < BENCH_ROUNDS; ++i) {
+        struct discord_message message = { 0 };
+
+        discord_message_from_json(MESSAGE_CREATE, sizeof(MESSAGE_CREATE) - 1,
+                                  &message);
+        discord_message_cleanup(&message);
+    }
+    decode_ns = (cog_timestamp_us() - tstart) * 1000;
+
+    fprintf(stderr,
+            "%-6s MESSAGE_CREATE: %6.0f ns unescaping its strings, "
+            "%6.0f ns/discord_message_from_json()\n",
+            name, (double)unescape_ns / BENCH_ROUNDS,
+            (double)decode_ns / BENCH_ROUNDS);
+
+    free(tokens);
+    jsmn_fast_select(JSMN_ISA_AUTO);
+    PASS();
+}
+
+SUITE(unescape_benchmark)
+{
+    RUN_TESTp(bench_message_create, "scalar", JSMN_ISA_SCALAR);
+    RUN_TESTp(bench_message_create, "sse2", JSMN_ISA_SSE2);
+    RUN_TESTp(bench_message_create, "avx2", JSMN_ISA_AVX2);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(unescape);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(unescape_benchmark);
+#endif
+
+    GREATEST_MAIN_END();
+}
@@ -0,0 +1,63 @@
+/* JSON documents loaded into jsmn-find pairs, as the Gateway does */
+#ifndef JSON_FIXTURE_H
+#define JSON_FIXTURE_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+/** @brief The buffers a JSON document is loaded at */
+struct json_fixture {
+    jsmntok_t *tokens;
+    unsigned ntokens;
+    jsmnf_pair *pairs;
+    unsigned npairs;
+};
+
+static inline void
+json_fixture_cleanup(struct json_fixture *fixture)
+{
+    free(fixture->tokens);
+    free(fixture->pairs);
+    memset(fixture, 0, sizeof *fixture);
+}
+
+/* the buffers are reused across loads, so pairs from a previous load
+ *      are no longer valid */
+static inline jsmnf_pair *
+json_fixture_load(struct json_fixture *fixture,
+                  const char js[],
+                  size_t length)
+{
+    jsmnf_loader loader;
+    jsmn_parser parser;
+
+    jsmn_init(&parser);
+    if (jsmn_parse_auto(&parser, js, length, &fixture->tokens,
+                        &fixture->ntokens)
+        <= 0)
+        return NULL;
+    jsmnf_init(&loader);
+    if (jsmnf_load_auto(&loader, js, fixture->tokens, parser.toknext,
+                        &fixture->pairs, &fixture->npairs)
+        <= 0)
+        return NULL;
+    return fixture->pairs;
+}
+
+/* loads @p js as the data of a dispatched @p event */
+static inline void
+json_fixture_payload(struct json_fixture *fixture,
+                     struct discord_gateway_payload *payload,
+                     enum discord_gateway_events event,
+                     const char js[])
+{
+    payload->event = event;
+    payload->name = "TEST";
+    payload->json.start = (char *)js;
+    payload->data = json_fixture_load(fixture, js, strlen(js));
+}
+
+#endif /* JSON_FIXTURE_H */
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+#include "discord-request.h"
+
+#include "greatest.h"
+
+#define EMBEDS_AMOUNT 10
+
+static char content[4000];
+static char descriptions[EMBEDS_AMOUNT][4096];
+static struct discord_embed embeds[EMBEDS_AMOUNT];
+
+/* well over the 16KB the request body used to be limited to */
+static struct discord_create_message
+big_message(void)
+{
+    struct discord_create_message params = { 0 };
+    static struct discord_embeds list;
+
+    /* quotes double in size once escaped */
+    memset(content, '"', sizeof(content) - 1);
+    for (int i = 0; i < EMBEDS_AMOUNT; ++i) {
+        memset(descriptions[i], 'a' + i, sizeof(descriptions[i]) - 1);
+        embeds[i].description = descriptions[i];
+    }
+    list.size = EMBEDS_AMOUNT;
+    list.array = embeds;
+
+    params.content = content;
+    params.embeds = &list;
+    return params;
+}
+
+TEST
+check_body_grows(void)
+{
+    struct discord_create_message params = big_message();
+    struct ccord_szbuf_reusable body = { 0 };
+    struct discord_attributes attr = { 0 };
+    size_t expected_size, size;
+    jsmntok_t *tokens = NULL;
+    unsigned ntokens = 0;
+    jsmn_parser parser;
+    char *expected;
+
+    expected_size = 2 * sizeof(content) + sizeof(descriptions) + 4096;
+    expected = malloc(expected_size);
+    expected_size =
+        discord_create_message_to_json(expected, expected_size, &params);
+
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_message, &params);
+    size = discord_request_body_encode(&body, &attr.body_params);
+    ASSERT(size > 16384);
+    ASSERT_EQ(expected_size, size);
+    ASSERT_MEM_EQ(expected, body.start, size);
+    ASSERT(body.realsize > size);
+
+    /* the body is valid JSON */
+    jsmn_init(&parser);
+    ASSERT(jsmn_parse_auto(&parser, body.start, size, &tokens, &ntokens) > 0);
+
+    free(tokens);
+    free(expected);
+    free(body.start);
+    PASS();
+}
+
+TEST
+check_body_reused(void)
+{
+    struct discord_create_message params = big_message();
+    struct ccord_szbuf_reusable body = { 0 };
+    struct discord_attributes attr = { 0 };
+    char expected[256], *start;
+
+    DISCORD_ATTR_BODY_INIT(attr, discord_create_message, &params);
+    discord_request_body_encode(&body, &attr.body_params);
+    start = body.start;
+
+    /* a smaller body fits the buffer already in place */
+    params = (struct discord_create_message){ .content = "hi" };
+    ASSERT_EQ(discord_create_message_to_json(expected, sizeof(expected),
+                                             &params),
+              discord_request_body_encode(&body, &attr.body_params));
+    ASSERT_EQ(start, body.start);
+    ASSERT_STR_EQ(expected, body.start);
+
+    /* no parameters, an empty object */
+    attr.body_params.params = NULL;
+    ASSERT_EQ(2, discord_request_body_encode(&body, &attr.body_params));
+    ASSERT_STR_EQ("{}", body.start);
+
+    free(body.start);
+    PASS();
+}
+
+TEST
+check_escape_bounds(void)
+{
+    char buf[16];
+    jsonb b;
+
+    /* the escaped string doesn't fit what's left after the key */
+    jsonb_init(&b);
+    ASSERT_EQ(JSONB_OK, jsonb_object(&b, buf, sizeof(buf)));
+    ASSERT_EQ(JSONB_OK, jsonb_key(&b, buf, sizeof(buf), "key", 3));
+    ASSERT_EQ(JSONB_ERROR_NOMEM,
+              jsonb_string(&b, buf, sizeof(buf), "\"\"\"\"\"\"", 6));
+    PASS();
+}
+
+SUITE(rest_body)
+{
+    RUN_TEST(check_body_grows);
+    RUN_TEST(check_body_reused);
+    RUN_TEST(check_escape_bounds);
+}
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(rest_body);
+
+    GREATEST_MAIN_END();
+}
@@ -0,0 +1,564 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+#define NTHREADS 16
+#define NROUNDS  50
+
+#define H2_PREFACE     "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+#define H2_DATA        0x0
+#define H2_HEADERS     0x1
+#define H2_SETTINGS    0x4
+#define H2_PING        0x6
+#define H2_GOAWAY      0x7
+#define H2_END_STREAM  0x1
+#define H2_ACK         0x1
+#define H2_END_HEADERS 0x4
+
+#define RESPONSE_BODY "{\"id\":\"939234213521760276\",\"name\":\"general\"}"
+
+#define TLS_RECORD_HANDSHAKE 0x16
+
+/* a local stand-in for discord.com, that speaks HTTP/1.1 or HTTP/2, either
+ *      in cleartext or over TLS (where ALPN picks the protocol) */
+static struct {
+    int fd;
+    unsigned short port;
+    SSL_CTX *tls;
+    pthread_t tid;
+    pthread_mutex_t lock;
+    unsigned h1_connections;
+    unsigned h2_connections;
+    unsigned h2_streams;
+} standin;
+
+struct conn {
+    int fd;
+    SSL *ssl;
+    size_t len;
+    char buf[1 << 16];
+};
+
+/* make sure at least `n` bytes are buffered */
+static bool
+conn_fill(struct conn *c, size_t n)
+{
+    while (c->len < n) {
+        const size_t size = sizeof(c->buf) - 1 - c->len;
+        ssize_t ret = c->ssl ? SSL_read(c->ssl, c->buf + c->len, (int)size)
+                             : recv(c->fd, c->buf + c->len, size, 0);
+        if (ret <= 0) return false;
+        c->len += (size_t)ret;
+        c->buf[c->len] = '\0';
+    }
+    return true;
+}
+
+static void
+conn_consume(struct conn *c, size_t n)
+{
+    memmove(c->buf, c->buf + n, c->len - n);
+    c->len -= n;
+    c->buf[c->len] = '\0';
+}
+
+static bool
+conn_send(struct conn *c, const void *buf, size_t len)
+{
+    if (c->ssl) return SSL_write(c->ssl, buf, (int)len) == (int)len;
+    return send(c->fd, buf, len, MSG_NOSIGNAL) == (ssize_t)len;
+}
+
+static void
+count(unsigned *counter)
+{
+    pthread_mutex_lock(&standin.lock);
+    ++*counter;
+    pthread_mutex_unlock(&standin.lock);
+}
+
+static void
+serve_http1(struct conn *c)
+{
+    char resp[512];
+    const int resp_len =
+        sprintf(resp,
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: application/json\r\n"
+                "Content-Length: %zu\r\n"
+                "x-ratelimit-bucket: standin\r\n"
+                "x-ratelimit-remaining: 50\r\n"
+                "x-ratelimit-reset-after: 1\r\n\r\n%s",
+                sizeof(RESPONSE_BODY) - 1, RESPONSE_BODY);
+
+    count(&standin.h1_connections);
+    while (1) {
+        size_t header_len, body_len = 0;
+        char *end, *p;
+
+        /* libcurl sends no NUL bytes before the body */
+        while (!(end = strstr(c->buf, "\r\n\r\n")))
+            if (!conn_fill(c, c->len + 1)) return;
+        header_len = (size_t)(end - c->buf) + 4;
+        *end = '\0';
+        if ((p = strstr(c->buf, "\r\nContent-Length:")))
+            body_len = strtoul(p + 17, NULL, 10);
+        if (!conn_fill(c, header_len + body_len)) return;
+        conn_consume(c, header_len + body_len);
+
+        if (!conn_send(c, resp, (size_t)resp_len)) return;
+    }
+}
+
+static bool
+h2_send_frame(struct conn *c,
+              int type,
+              int flags,
+              unsigned stream,
+              const void *payload,
+              size_t len)
+{
+    unsigned char frame[9 + 512];
+
+    frame[0] = (unsigned char)(len >> 16);
+    frame[1] = (unsigned char)(len >> 8);
+    frame[2] = (unsigned char)len;
+    frame[3] = (unsigned char)type;
+    frame[4] = (unsigned char)flags;
+    frame[5] = (unsigned char)((stream >> 24) & 0x7f);
+    frame[6] = (unsigned char)(stream >> 16);
+    frame[7] = (unsigned char)(stream >> 8);
+    frame[8] = (unsigned char)stream;
+    memcpy(frame + 9, payload, len);
+    return conn_send(c, frame, 9 + len);
+}
+
+/* HPACK literal header field without indexing, with a new name */
+static size_t
+hpack_literal(unsigned char *buf, const char name[], const char value[])
+{
+    const size_t name_len = strlen(name), value_len = strlen(value);
+    size_t len = 0;
+
+    buf[len++] = 0x00;
+    buf[len++] = (unsigned char)name_len;
+    memcpy(buf + len, name, name_len);
+    len += name_len;
+    buf[len++] = (unsigned char)value_len;
+    memcpy(buf + len, value, value_len);
+    return len + value_len;
+}
+
+static bool
+h2_respond(struct conn *c, unsigned stream)
+{
+    unsigned char headers[256];
+    size_t len = 0;
+
+    headers[len++] = 0x88; /* :status: 200 */
+    len += hpack_literal(headers + len, "content-type", "application/json");
+    len += hpack_literal(headers + len, "x-ratelimit-bucket", "standin");
+    len += hpack_literal(headers + len, "x-ratelimit-remaining", "50");
+    len += hpack_literal(headers + len, "x-ratelimit-reset-after", "1");
+
+    count(&standin.h2_streams);
+    return h2_send_frame(c, H2_HEADERS, H2_END_HEADERS, stream, headers, len)
+           && h2_send_frame(c, H2_DATA, H2_END_STREAM, stream, RESPONSE_BODY,
+                            sizeof(RESPONSE_BODY) - 1);
+}
+
+/* just enough HTTP/2 for libcurl: request headers aren't even decoded */
+static void
+serve_http2(struct conn *c)
+{
+    count(&standin.h2_connections);
+    conn_consume(c, sizeof(H2_PREFACE) - 1);
+    if (!h2_send_frame(c, H2_SETTINGS, 0, 0, NULL, 0)) return;
+
+    while (conn_fill(c, 9)) {
+        const size_t len = (size_t)((unsigned char)c->buf[0] << 16
+                                    | (unsigned char)c->buf[1] << 8
+                                    | (unsigned char)c->buf[2]);
+        const int type = c->buf[3], flags = c->buf[4];
+        const unsigned stream = ((unsigned char)c->buf[5] & 0x7fu) << 24
+                                | (unsigned char)c->buf[6] << 16
+                                | (unsigned char)c->buf[7] << 8
+                                | (unsigned char)c->buf[8];
+        bool ok = true;
+
+        if (!conn_fill(c, 9 + len)) return;
+        switch (type) {
+        case H2_SETTINGS:
+            if (!(flags & H2_ACK))
+                ok = h2_send_frame(c, H2_SETTINGS, H2_ACK, 0, NULL, 0);
+            break;
+        case H2_PING:
+            if (!(flags & H2_ACK))
+                ok = h2_send_frame(c, H2_PING, H2_ACK, 0, c->buf + 9, len);
+            break;
+        case H2_HEADERS:
+        case H2_DATA:
+            if (flags & H2_END_STREAM) ok = h2_respond(c, stream);
+            break;
+        case H2_GOAWAY:
+            return;
+        default:
+            break;
+        }
+        if (!ok) return;
+        conn_consume(c, 9 + len);
+    }
+}
+
+/* a client that negotiated h2 over TLS sends the same preface as one
+ *      with prior knowledge does */
+static void *
+serve(void *p_fd)
+{
+    struct conn *c = malloc(sizeof *c);
+    unsigned char record;
+
+    c->fd = (int)(intptr_t)p_fd;
+    c->ssl = NULL;
+    c->len = 0;
+    if (1 == recv(c->fd, &record, 1, MSG_PEEK)
+        && TLS_RECORD_HANDSHAKE == record)
+    {
+        c->ssl = SSL_new(standin.tls);
+        SSL_set_fd(c->ssl, c->fd);
+        if (SSL_accept(c->ssl) != 1) goto _close;
+    }
+    if (conn_fill(c, sizeof(H2_PREFACE) - 1)) {
+        if (0 == memcmp(c->buf, H2_PREFACE, sizeof(H2_PREFACE) - 1))
+            serve_http2(c);
+        else
+            serve_http1(c);
+    }
+_close:
+    if (c->ssl) {
+        SSL_shutdown(c->ssl);
+        SSL_free(c->ssl);
+    }
+    close(c->fd);
+    free(c);
+    return NULL;
+}
+
+static void *
+standin_accept(void *p_unused)
+{
+    int fd;
+
+    (void)p_unused;
+    while ((fd = accept(standin.fd, NULL, NULL)) != -1) {
+        pthread_t tid;
+
+        pthread_create(&tid, NULL, &serve, (void *)(intptr_t)fd);
+        pthread_detach(tid);
+    }
+    return NULL;
+}
+
+/* h2 if the client offers it, like discord.com does */
+static int
+standin_alpn(SSL *ssl,
+             const unsigned char **out,
+             unsigned char *outlen,
+             const unsigned char *in,
+             unsigned inlen,
+             void *data)
+{
+    static const unsigned char protos[] = "\x02h2\x08http/1.1";
+
+    (void)ssl;
+    (void)data;
+    if (OPENSSL_NPN_NEGOTIATED
+        != SSL_select_next_proto((unsigned char **)out, outlen, protos,
+                                 sizeof(protos) - 1, in, inlen))
+        return SSL_TLSEXT_ERR_ALERT_FATAL;
+    return SSL_TLSEXT_ERR_OK;
+}
+
+/* a throwaway self-signed certificate, the client doesn't verify it */
+static SSL_CTX *
+standin_tls(void)
+{
+    SSL_CTX *ctx = SSL_CTX_new(TLS_server_method());
+    EVP_PKEY *pkey = EVP_EC_gen("P-256");
+    X509 *cert = X509_new();
+    bool ok = ctx && pkey && cert;
+
+    if (ok) {
+        X509_NAME *name = X509_get_subject_name(cert);
+
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 60 * 60);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   (unsigned char *)"127.0.0.1", -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509_set_pubkey(cert, pkey);
+        ok = X509_sign(cert, pkey, EVP_sha256())
+             && SSL_CTX_use_certificate(ctx, cert)
+             && SSL_CTX_use_PrivateKey(ctx, pkey);
+    }
+    X509_free(cert);
+    EVP_PKEY_free(pkey);
+    if (!ok) {
+        SSL_CTX_free(ctx);
+        return NULL;
+    }
+    SSL_CTX_set_alpn_select_cb(ctx, &standin_alpn, NULL);
+    return ctx;
+}
+
+static bool
+standin_start(void)
+{
+    struct sockaddr_in addr = { .sin_family = AF_INET };
+    socklen_t addrlen = sizeof(addr);
+
+    if (!(standin.tls = standin_tls())) return false;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    standin.fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (standin.fd == -1
+        || bind(standin.fd, (struct sockaddr *)&addr, sizeof(addr))
+        || listen(standin.fd, 64)
+        || getsockname(standin.fd, (struct sockaddr *)&addr, &addrlen))
+        return false;
+    standin.port = ntohs(addr.sin_port);
+    pthread_mutex_init(&standin.lock, NULL);
+    return 0 == pthread_create(&standin.tid, NULL, &standin_accept, NULL);
+}
+
+static void
+standin_stop(void)
+{
+    shutdown(standin.fd, SHUT_RDWR);
+    pthread_join(standin.tid, NULL);
+    close(standin.fd);
+    pthread_mutex_destroy(&standin.lock);
+    SSL_CTX_free(standin.tls);
+}
+
+static void
+standin_counters(unsigned *h1_connections,
+                 unsigned *h2_connections,
+                 unsigned *h2_streams)
+{
+    pthread_mutex_lock(&standin.lock);
+    *h1_connections = standin.h1_connections;
+    *h2_connections = standin.h2_connections;
+    *h2_streams = standin.h2_streams;
+    pthread_mutex_unlock(&standin.lock);
+}
+
+static void
+standin_setopt(struct ua_conn *conn, void *data)
+{
+    CURL *ehandle = ua_conn_get_easy_handle(conn);
+
+    (void)data;
+    curl_easy_setopt(ehandle, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(ehandle, CURLOPT_SSL_VERIFYHOST, 0L);
+}
+
+static void
+standin_url(struct discord *client, bool tls)
+{
+    char url[64];
+
+    snprintf(url, sizeof(url), "%s://127.0.0.1:%hu/api/v10",
+             tls ? "https" : "http", standin.port);
+    ua_set_url(client->rest.requestor.ua, url);
+}
+
+/* HTTP/2 is negotiated over TLS, as it is with discord.com */
+static struct discord *
+standin_client(bool tls)
+{
+    struct discord *client = discord_init("");
+
+    ua_set_opt(client->rest.requestor.ua, NULL, &standin_setopt);
+    standin_url(client, tls);
+    return client;
+}
+
+static CCORDcode
+get_channel(struct discord *client, u64snowflake channel_id)
+{
+    struct discord_channel channel = { 0 };
+    CCORDcode code = discord_get_channel(
+        client, channel_id, &(struct discord_ret_channel){ .sync = &channel });
+
+    if (CCORD_OK == code && channel.id != 939234213521760276ULL)
+        code = CCORD_UNAVAILABLE;
+    discord_channel_cleanup(&channel);
+    return code;
+}
+
+struct worker {
+    struct discord *client;
+    u64snowflake channel_id;
+    int failures;
+};
+
+static void *
+get_channels(void *p_worker)
+{
+    struct worker *worker = p_worker;
+
+    for (int i = 0; i < NROUNDS; ++i)
+        if (CCORD_OK != get_channel(worker->client, worker->channel_id))
+            ++worker->failures;
+    return NULL;
+}
+
+/* each thread requests its own channel, so they're given a bucket each
+ *      and run concurrently */
+static enum greatest_test_res
+run(struct discord *client)
+{
+    struct discord_rest_stats before, after;
+    struct worker workers[NTHREADS];
+    pthread_t threads[NTHREADS];
+    unsigned h1[2], h2[2], streams[2];
+
+    /* the first request of a route is sent alone, until its bucket is
+     *      known */
+    for (int i = 0; i < NTHREADS; ++i) {
+        workers[i] = (struct worker){ client, 1000 + i, 0 };
+        ASSERT_EQ(CCORD_OK, get_channel(client, workers[i].channel_id));
+    }
+
+    discord_get_rest_stats(client, &before);
+    standin_counters(&h1[0], &h2[0], &streams[0]);
+    for (int i = 0; i < NTHREADS; ++i)
+        pthread_create(&threads[i], NULL, &get_channels, &workers[i]);
+    for (int i = 0; i < NTHREADS; ++i) {
+        pthread_join(threads[i], NULL);
+        ASSERT_EQ(0, workers[i].failures);
+    }
+    discord_get_rest_stats(client, &after);
+    standin_counters(&h1[1], &h2[1], &streams[1]);
+
+    ASSERT_EQ(NTHREADS * NROUNDS, after.requests - before.requests);
+    ASSERT_EQ(after.connections - before.connections,
+              (h1[1] - h1[0]) + (h2[1] - h2[0]));
+    ASSERT_EQ(after.streams - before.streams, streams[1] - streams[0]);
+    PASS();
+}
+
+TEST
+check_http11(void)
+{
+    struct discord *client = standin_client(false);
+    struct discord_rest_stats stats;
+
+    CHECK_CALL(run(client));
+    discord_get_rest_stats(client, &stats);
+    ASSERT_EQ(NTHREADS + NTHREADS * NROUNDS, stats.requests);
+    ASSERT_EQ(0, stats.streams);
+    ASSERT(stats.connections >= 1);
+
+    discord_cleanup(client);
+    PASS();
+}
+
+TEST
+check_http2(long max_connections)
+{
+    struct discord *client;
+    struct discord_rest_stats stats;
+    unsigned h1, h2, streams;
+
+    client = standin_client(true);
+    discord_set_http2(client, true, max_connections);
+    CHECK_CALL(run(client));
+
+    discord_get_rest_stats(client, &stats);
+    ASSERT_EQ(NTHREADS + NTHREADS * NROUNDS, stats.requests);
+    ASSERT_EQ(stats.requests, stats.streams);
+    ASSERT(stats.connections >= 1);
+    if (max_connections) ASSERT(stats.connections <= max_connections);
+    discord_cleanup(client);
+
+    standin_counters(&h1, &h2, &streams);
+    ASSERT(h2 >= stats.connections);
+    PASS();
+}
+
+TEST
+check_toggle(void)
+{
+    struct discord *client;
+    struct discord_rest_stats stats;
+
+    client = standin_client(false);
+    ASSERT_EQ(CCORD_OK, get_channel(client, 1));
+    discord_get_rest_stats(client, &stats);
+    ASSERT_EQ(0, stats.streams);
+    ASSERT_EQ(1, stats.connections);
+
+    /* reaches a running client, and the easy handles it reuses */
+    standin_url(client, true);
+    discord_set_http2(client, true, 0);
+    ASSERT_EQ(CCORD_OK, get_channel(client, 1));
+    ASSERT_EQ(CCORD_OK, get_channel(client, 1));
+    discord_get_rest_stats(client, &stats);
+    ASSERT_EQ(3, stats.requests);
+    ASSERT_EQ(2, stats.streams);
+    ASSERT_EQ(2, stats.connections);
+
+    discord_cleanup(client);
+    PASS();
+}
+
+SUITE(rest_http2)
+{
+    RUN_TEST(check_http11);
+    RUN_TESTp(check_http2, 0);
+    RUN_TESTp(check_http2, 1);
+    RUN_TEST(check_toggle);
+}
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    ccord_global_init();
+    /* a client may hang up on a TLS connection that's being written to */
+    signal(SIGPIPE, SIG_IGN);
+    if (!(curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2)) {
+        fprintf(stderr, "libcurl was built without HTTP/2 support\n");
+        ccord_global_cleanup();
+        GREATEST_MAIN_END();
+    }
+    if (!standin_start()) {
+        fprintf(stderr, "couldn't start the HTTP/2 stand-in server\n");
+        return EXIT_FAILURE;
+    }
+
+    RUN_SUITE(rest_http2);
+
+    standin_stop();
+    ccord_global_cleanup();
+
+    GREATEST_MAIN_END();
+}
@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "discord.h"
+#include "discord-internal.h"
+
+#include "greatest.h"
+
+#define RECORDING    "traffic-replay.rec"
+
+static const char HELLO[] = "{\"op\":10,\"d\":{\"heartbeat_interval\":41250}}";
+static const char MESSAGE_CREATE[] =
+    "{\"op\":0,\"s\":2,\"t\":\"MESSAGE_CREATE\",\"d\":{"
+    "\"id\":\"1014990303337226250\",\"channel_id\":\"939234213521760276\","
+    "\"guild_id\":\"939234213521760270\",\"content\":\"hi\","
+    "\"author\":{\"id\":\"140931563499159552\",\"username\":\"concord\"}}}";
+static const char GUILD_DELETE[] =
+    "{\"op\":0,\"s\":3,\"t\":\"GUILD_DELETE\",\"d\":{"
+    "\"id\":\"939234213521760270\",\"unavailable\":true}}";
+
+static int messages, guilds;
+
+static void
+on_message_create(struct discord *client, const struct discord_message *event)
+{
+    (void)client;
+    if (0 == strcmp("hi", event->content)) ++messages;
+}
+
+static void
+on_guild_delete(struct discord *client, const struct discord_guild *event)
+{
+    (void)client;
+    if (939234213521760270ULL == event->id) ++guilds;
+}
+
+static struct discord *
+client_init(void)
+{
+    struct discord *client = discord_init("");
+
+    discord_set_on_message_create(client, &on_message_create);
+    discord_set_on_guild_delete(client, &on_guild_delete);
+    messages = guilds = 0;
+    return client;
+}
+
+static void
+record(struct discord *client, const char text[], int shard_id)
+{
+    discord_recorder_append(&client->recorder, shard_id, text, strlen(text));
+}
+
+TEST
+check_record_and_replay(void)
+{
+    struct discord *client = client_init();
+    struct discord_replay_stats stats;
+
+    ASSERT_EQ(CCORD_OK, discord_set_traffic_recorder(client, RECORDING));
+    record(client, HELLO, 0);
+    record(client, MESSAGE_CREATE, 0);
+    record(client, MESSAGE_CREATE, 1);
+    record(client, GUILD_DELETE, 0);
+    ASSERT_EQ(CCORD_OK, discord_set_traffic_recorder(client, NULL));
+    discord_cleanup(client);
+
+    client = client_init();
+    ASSERT_EQ(CCORD_OK,
+              discord_replay_traffic(client, RECORDING, false, &stats));
+    ASSERT_EQ(4, stats.payloads);
+    ASSERT_EQ(strlen(HELLO) + 2 * strlen(MESSAGE_CREATE)
+                  + strlen(GUILD_DELETE),
+              stats.bytes);
+    ASSERT_EQ(2, messages);
+    ASSERT_EQ(1, guilds);
+    /* the session is left untouched */
+    ASSERT_FALSE(client->gw.session->is_ready);
+    ASSERT_EQ(NULL, client->gw.payload.json.start);
+
+    discord_cleanup(client);
+    remove(RECORDING);
+    PASS();
+}
+
+TEST
+check_paced_replay(void)
+{
+    struct discord *client = client_init();
+    struct discord_replay_stats stats;
+
+    discord_set_traffic_recorder(client, RECORDING);
+    record(client, MESSAGE_CREATE, 0);
+    cog_sleep_ms(50);
+    record(client, MESSAGE_CREATE, 0);
+    discord_set_traffic_recorder(client, NULL);
+
+    ASSERT_EQ(CCORD_OK,
+              discord_replay_traffic(client, RECORDING, true, &stats));
+    ASSERT_EQ(2, messages);
+    ASSERT(stats.elapsed_us >= 50000);
+
+    discord_cleanup(client);
+    remove(RECORDING);
+    PASS();
+}
+
+TEST
+check_bad_recording(void)
+{
+    struct discord *client = client_init();
+    char *contents;
+    size_t size;
+    FILE *fp;
+
+    ASSERT_EQ(CCORD_BAD_PARAMETER,
+              discord_replay_traffic(client, "does-not-exist.rec", false,
+                                     NULL));
+
+    fp = fopen(RECORDING, "wb");
+    fputs("{\"op\":0}", fp);
+    fclose(fp);
+    ASSERT_EQ(CCORD_BAD_PARAMETER,
+              discord_replay_traffic(client, RECORDING, false, NULL));
+
+    /* truncated payload */
+    discord_set_traffic_recorder(client, RECORDING);
+    record(client, MESSAGE_CREATE, 0);
+    discord_set_traffic_recorder(client, NULL);
+    contents = cog_load_whole_file(RECORDING, &size);
+    fp = fopen(RECORDING, "wb");
+    fwrite(contents, 1, size - 10, fp);
+    fclose(fp);
+    free(contents);
+    ASSERT_EQ(CCORD_BAD_JSON,
+              discord_replay_traffic(client, RECORDING, false, NULL));
+    ASSERT_EQ(0, messages);
+
+    discord_cleanup(client);
+    remove(RECORDING);
+    PASS();
+}
+
+SUITE(traffic_replay)
+{
+    RUN_TEST(check_record_and_replay);
+    RUN_TEST(check_paced_replay);
+    RUN_TEST(check_bad_recording);
+}
+
+#ifdef CCORD_BENCHMARK
+#define BENCH_EVENTS 10000
+
+TEST
+bench_replay(void)
+{
+    struct discord *client = client_init();
+    struct discord_replay_stats stats;
+
+    discord_set_traffic_recorder(client, RECORDING);
+    for (int i = 0; i < BENCH_EVENTS; ++i)
+        record(client, MESSAGE_CREATE, 0);
+    discord_set_traffic_recorder(client, NULL);
+
+    ASSERT_EQ(CCORD_OK,
+              discord_replay_traffic(client, RECORDING, false, &stats));
+    ASSERT_EQ(BENCH_EVENTS, messages);
+
+    fprintf(stderr,
+            "MESSAGE_CREATE replay: %zu payloads, %8.1f ns/payload, "
+            "%6.1f MB/s\n",
+            stats.payloads, stats.elapsed_us * 1000.0 / stats.payloads,
+            (double)stats.bytes / (double)stats.elapsed_us);
+
+    discord_cleanup(client);
+    remove(RECORDING);
+    PASS();
+}
+
+SUITE(traffic_replay_benchmark)
+{
+    RUN_TEST(bench_replay);
+}
+#endif /* CCORD_BENCHMARK */
+
+GREATEST_MAIN_DEFS();
+
+int
+main(int argc, char *argv[])
+{
+    GREATEST_MAIN_BEGIN();
+
+    RUN_SUITE(traffic_replay);
+#ifdef CCORD_BENCHMARK
+    RUN_SUITE(traffic_replay_benchmark);
+#endif
+
+    GREATEST_MAIN_END();
+}